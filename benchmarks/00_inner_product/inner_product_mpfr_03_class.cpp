@@ -0,0 +1,55 @@
+#include <iostream>
+#include <chrono>
+#include <mpfr.h>
+#include "mpfr_class.h"
+
+gmp_randstate_t state;
+
+void init_mpfr_class_vec(mpfr::mpfr_class *vec, int n, int prec) {
+    mpfr_t tmp;
+    mpfr_init2(tmp, prec);
+    for (int i = 0; i < n; i++) {
+        mpfr_urandom(tmp, state, MPFR_RNDN);
+        vec[i] = mpfr::mpfr_class(tmp);
+    }
+    mpfr_clear(tmp);
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <vector size> <precision>" << std::endl;
+        return 1;
+    }
+
+    int N = std::atoi(argv[1]);
+    int prec = std::atoi(argv[2]);
+    mpfr::defaults::set_default_prec(prec);
+
+    mpfr::mpfr_class *vec1 = new mpfr::mpfr_class[N];
+    mpfr::mpfr_class *vec2 = new mpfr::mpfr_class[N];
+    mpfr::mpfr_class dot_product(0.0);
+
+    init_mpfr_class_vec(vec1, N, prec);
+    init_mpfr_class_vec(vec2, N, prec);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N; i++) {
+        dot_product += vec1[i] * vec2[i]; // evaluated as a single mpfr_fma
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::cout << "Elapsed time: " << elapsed_seconds.count() << " s" << std::endl;
+
+    std::cout << "Dot product: ";
+    mpfr_printf("%.128Rf", dot_product.get_mpfr_t());
+    std::cout << std::endl;
+
+    delete[] vec1;
+    delete[] vec2;
+
+    return 0;
+}
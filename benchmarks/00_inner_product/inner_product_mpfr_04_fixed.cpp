@@ -0,0 +1,64 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <mpfr.h>
+#include "mpfr_fixed.h"
+
+gmp_randstate_t state;
+
+template <mpfr_prec_t Bits> void init_mpfr_fixed_vec(std::vector<mpfr::mpfr_fixed<Bits>> &vec) {
+    mpfr_t tmp;
+    mpfr_init2(tmp, Bits);
+    for (auto &v : vec) {
+        mpfr_urandom(tmp, state, MPFR_RNDN);
+        v = mpfr::mpfr_fixed<Bits>(tmp);
+    }
+    mpfr_clear(tmp);
+}
+
+template <mpfr_prec_t Bits> void run(int N) {
+    std::vector<mpfr::mpfr_fixed<Bits>> vec1(N), vec2(N); // one contiguous block each
+    mpfr::mpfr_fixed<Bits> dot_product(0.0);
+
+    init_mpfr_fixed_vec(vec1);
+    init_mpfr_fixed_vec(vec2);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N; i++) {
+        dot_product += vec1[i] * vec2[i];
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::cout << "Elapsed time: " << elapsed_seconds.count() << " s" << std::endl;
+
+    std::cout << "Dot product: ";
+    mpfr_printf("%.128Rf", dot_product.get_mpfr_t());
+    std::cout << std::endl;
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <vector size> <precision: 256 or 512>" << std::endl;
+        return 1;
+    }
+
+    int N = std::atoi(argv[1]);
+    int prec = std::atoi(argv[2]);
+
+    switch (prec) {
+    case 256:
+        run<256>(N);
+        break;
+    case 512:
+        run<512>(N);
+        break;
+    default:
+        std::cerr << "Unsupported precision: " << prec << std::endl;
+        return 1;
+    }
+    return 0;
+}
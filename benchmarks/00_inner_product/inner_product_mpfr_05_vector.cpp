@@ -0,0 +1,65 @@
+#include <iostream>
+#include <chrono>
+#include <mpfr.h>
+#include "mpfr_vector.h"
+
+gmp_randstate_t state;
+
+void init_mpfr_vector(mpfr::mpfr_vector &vec) {
+    for (auto v : vec) {
+        mpfr_urandom(v.get_mpfr_t(), state, MPFR_RNDN);
+    }
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <vector size> <precision>" << std::endl;
+        return 1;
+    }
+
+    int N = std::atoi(argv[1]);
+    int prec = std::atoi(argv[2]);
+    mpfr::defaults::set_default_prec(prec);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    mpfr::mpfr_vector vec1(N, prec), vec2(N, prec); // one allocation each instead of N
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::cout << "Allocation time: " << elapsed_seconds.count() << " s" << std::endl;
+
+    mpfr::mpfr_class dot_product(0.0);
+    init_mpfr_vector(vec1);
+    init_mpfr_vector(vec2);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N; i++) {
+        dot_product += vec1[i] * vec2[i]; // evaluated as a single mpfr_fma
+    }
+    end = std::chrono::high_resolution_clock::now();
+
+    elapsed_seconds = end - start;
+    std::cout << "Elapsed time: " << elapsed_seconds.count() << " s" << std::endl;
+
+    std::cout << "Dot product: ";
+    mpfr_printf("%.128Rf", dot_product.get_mpfr_t());
+    std::cout << std::endl;
+
+    mpfr_t dot; // correctly rounded, straight on the raw pointer arrays
+    mpfr_init2(dot, prec);
+    start = std::chrono::high_resolution_clock::now();
+    mpfr_dot(dot, vec1.data(), vec2.data(), N, MPFR_RNDN);
+    end = std::chrono::high_resolution_clock::now();
+
+    elapsed_seconds = end - start;
+    std::cout << "Elapsed time (mpfr_dot): " << elapsed_seconds.count() << " s" << std::endl;
+
+    std::cout << "Dot product (mpfr_dot): ";
+    mpfr_printf("%.128Rf", dot);
+    std::cout << std::endl;
+    mpfr_clear(dot);
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <chrono>
+#include <mpfr.h>
+#include "mpfr_blas.h"
+
+gmp_randstate_t state;
+
+void init_mpfr_vector(mpfr::mpfr_vector &vec) {
+    for (auto v : vec) {
+        mpfr_urandom(v.get_mpfr_t(), state, MPFR_RNDN);
+    }
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <vector size> <precision> [threads]" << std::endl;
+        return 1;
+    }
+
+    int N = std::atoi(argv[1]);
+    int prec = std::atoi(argv[2]);
+    mpfr::defaults::set_default_prec(prec);
+    if (argc == 4)
+        mpfr::blas::set_num_threads(std::atoi(argv[3]));
+
+    mpfr::mpfr_vector vec1(N, prec), vec2(N, prec);
+    init_mpfr_vector(vec1);
+    init_mpfr_vector(vec2);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    mpfr::mpfr_class dot_product = mpfr::blas::dot_fma(vec1, vec2);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::cout << "Elapsed time (dot_fma, " << mpfr::blas::get_num_threads() << " threads): " << elapsed_seconds.count() << " s" << std::endl;
+    std::cout << "Dot product: ";
+    mpfr_printf("%.128Rf", dot_product.get_mpfr_t());
+    std::cout << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    dot_product = mpfr::blas::dot(vec1, vec2);
+    end = std::chrono::high_resolution_clock::now();
+
+    elapsed_seconds = end - start;
+    std::cout << "Elapsed time (dot, correctly rounded): " << elapsed_seconds.count() << " s" << std::endl;
+    std::cout << "Dot product: ";
+    mpfr_printf("%.128Rf", dot_product.get_mpfr_t());
+    std::cout << std::endl;
+
+    return 0;
+}
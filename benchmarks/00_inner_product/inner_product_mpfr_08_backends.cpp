@@ -0,0 +1,89 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include "mpfr_backend.h" // ahead of <mpfr.h>, for the _Float128 functions
+#include "mpfr_blas.h"
+
+// The same templated inner product on mpfr_class, mpfr_fixed and the fixed-width backends,
+// at the width of each backend. Inputs are random at that width, so they convert exactly;
+// the error is against the correctly rounded result of mpfr_dot at 1024 bits.
+
+gmp_randstate_t state;
+
+template <class T> T dot(const std::vector<T> &x, const std::vector<T> &y) {
+    T s(0.0);
+    for (size_t i = 0; i < x.size(); i++)
+        s += x[i] * y[i];
+    return s;
+}
+
+template <class T> void run(const char *name, const std::vector<mpfr::mpfr_class> &x, const std::vector<mpfr::mpfr_class> &y, const mpfr::mpfr_class &exact) {
+    std::vector<T> tx, ty;
+    for (size_t i = 0; i < x.size(); i++) {
+        tx.push_back(T(x[i]));
+        ty.push_back(T(y[i]));
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    T s = dot(tx, ty);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    mpfr::precision_scope scope(1024);
+    const mpfr::mpfr_class v(s); // exact at 1024 bits
+    mpfr::mpfr_class err = abs((v - exact) / exact);
+    const double bits = mpfr_zero_p(err.get_mpfr_t()) ? 1024 : -mpfr_get_d(log2(err).get_mpfr_t(), MPFR_RNDN);
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    std::cout << std::setw(20) << std::left << name << std::setw(14) << std::setprecision(6) << elapsed_seconds.count() << " s  " << std::setprecision(4) << bits << " bits" << std::endl;
+}
+
+template <class T> const char *name() { return "  backend_t"; }
+template <> const char *name<mpfr::mpfr_dd>() { return "  mpfr_dd"; }
+template <> const char *name<mpfr::mpfr_qd>() { return "  mpfr_qd"; }
+#ifdef MPFR_WANT_FLOAT128
+template <> const char *name<mpfr::mpfr_float128>() { return "  mpfr_float128"; }
+#endif
+
+// every type that meets Bits; backend_t<Bits> should be the fastest of the backends
+template <mpfr_prec_t Bits, class... Backends> void tier(int N) {
+    std::vector<mpfr::mpfr_class> x, y;
+    {
+        mpfr::precision_scope scope(Bits);
+        for (int i = 0; i < N; i++) {
+            x.emplace_back(0.0);
+            y.emplace_back(0.0);
+            mpfr_urandom(x.back().get_mpfr_t(), state, MPFR_RNDN);
+            mpfr_urandom(y.back().get_mpfr_t(), state, MPFR_RNDN);
+        }
+    }
+    mpfr::mpfr_class exact;
+    {
+        mpfr::precision_scope scope(1024);
+        exact = mpfr::blas::dot(N, x.begin(), 1, y.begin(), 1);
+    }
+    mpfr::precision_scope scope(Bits);
+    std::cout << Bits << " bits:" << std::endl;
+    run<mpfr::mpfr_class>("  mpfr_class", x, y, exact);
+    run<mpfr::mpfr_fixed<Bits>>("  mpfr_fixed", x, y, exact);
+    (run<Backends>(name<Backends>(), x, y, exact), ...);
+    std::cout << "  backend_t<" << Bits << "> is" << name<mpfr::backend_t<Bits>>() << std::endl;
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <vector size>" << std::endl;
+        return 1;
+    }
+    int N = std::atoi(argv[1]);
+
+#ifdef MPFR_WANT_FLOAT128
+    tier<mpfr::mpfr_dd::prec, mpfr::mpfr_dd, mpfr::mpfr_float128, mpfr::mpfr_qd>(N);
+    tier<mpfr::mpfr_float128::prec, mpfr::mpfr_float128, mpfr::mpfr_qd>(N);
+#else
+    tier<mpfr::mpfr_dd::prec, mpfr::mpfr_dd, mpfr::mpfr_qd>(N);
+#endif
+    tier<mpfr::mpfr_qd::prec, mpfr::mpfr_qd>(N);
+    return 0;
+}
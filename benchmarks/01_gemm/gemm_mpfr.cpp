@@ -0,0 +1,63 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <mpfr.h>
+#include "mpfr_blas.h"
+
+// C = A * B for n x n matrices: a triple loop over mpfr_class against blas::gemm,
+// at precisions from 64 to 4096 bits. GFLOP-equivalents count a multiply-add as 2.
+
+gmp_randstate_t state;
+
+void init_matrix(std::vector<mpfr::mpfr_class> &a) {
+    for (auto &x : a)
+        mpfr_urandom(x.get_mpfr_t(), state, MPFR_RNDN);
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " [matrix size (128)] [threads (1)]" << std::endl;
+        return 1;
+    }
+    const long n = argc > 1 ? std::atol(argv[1]) : 128;
+    mpfr::blas::set_num_threads(argc > 2 ? std::atoi(argv[2]) : 1);
+    const double flops = 2.0 * n * n * n;
+
+    std::cout << "n = " << n << ", threads = " << mpfr::blas::get_num_threads() << std::endl;
+    std::cout << std::setw(6) << "prec" << std::setw(14) << "naive [s]" << std::setw(14) << "gemm [s]" << std::setw(14) << "naive GFLOPS" << std::setw(14) << "gemm GFLOPS"
+              << std::setw(10) << "speedup" << std::setw(8) << "equal" << std::endl;
+    for (mpfr_prec_t prec : {64, 128, 256, 512, 1024, 2048, 4096}) {
+        mpfr::precision_scope scope(prec);
+        std::vector<mpfr::mpfr_class> A(n * n), B(n * n), C(n * n), D(n * n);
+        init_matrix(A);
+        init_matrix(B);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (long j = 0; j < n; j++)
+            for (long i = 0; i < n; i++) {
+                mpfr::mpfr_class s(0.0);
+                for (long p = 0; p < n; p++)
+                    s += A[i + p * n] * B[p + j * n];
+                C[i + j * n] = s;
+            }
+        auto end = std::chrono::high_resolution_clock::now();
+        const double naive = std::chrono::duration<double>(end - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        mpfr::blas::gemm('N', 'N', n, n, n, 1, A.data(), n, B.data(), n, 0, D.data(), n);
+        end = std::chrono::high_resolution_clock::now();
+        const double blocked = std::chrono::duration<double>(end - start).count();
+
+        bool equal = true;
+        for (long i = 0; i < n * n; i++)
+            equal = equal && C[i] == D[i];
+        std::cout << std::setw(6) << prec << std::setw(14) << naive << std::setw(14) << blocked << std::setw(14) << flops / naive * 1e-9 << std::setw(14) << flops / blocked * 1e-9
+                  << std::setw(10) << naive / blocked << std::setw(8) << (equal ? "yes" : "no") << std::endl;
+    }
+    gmp_randclear(state);
+    return 0;
+}
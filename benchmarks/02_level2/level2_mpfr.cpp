@@ -0,0 +1,62 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <mpfr.h>
+#include "mpfr_blas.h"
+
+// Level 2 kernels on an n x n matrix, next to a plain mpfr_class loop for y = A * x.
+
+gmp_randstate_t state;
+
+void init_vector(std::vector<mpfr::mpfr_class> &a) {
+    for (auto &x : a)
+        mpfr_urandom(x.get_mpfr_t(), state, MPFR_RNDN);
+}
+
+template <class F> double seconds(F f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <matrix size> <precision> [threads]" << std::endl;
+        return 1;
+    }
+    const long n = std::atol(argv[1]);
+    mpfr::defaults::set_default_prec(std::atoi(argv[2]));
+    if (argc == 4)
+        mpfr::blas::set_num_threads(std::atoi(argv[3]));
+
+    std::vector<mpfr::mpfr_class> A(n * n), x(n), y(n);
+    init_vector(A);
+    init_vector(x);
+    for (long i = 0; i < n; i++)
+        A[i + i * n] += n; // well conditioned for trsv
+
+    auto report = [](const char *name, double t) { std::cout << std::setw(24) << std::left << name << t << " s" << std::endl; };
+    std::cout << "n = " << n << ", prec = " << mpfr::defaults::get_default_prec() << ", threads = " << mpfr::blas::get_num_threads() << std::endl;
+    report("loop (mpfr_class)", seconds([&] {
+               for (long i = 0; i < n; i++) {
+                   mpfr::mpfr_class s(0.0);
+                   for (long j = 0; j < n; j++)
+                       s += A[i + j * n] * x[j];
+                   y[i] = s;
+               }
+           }));
+    report("gemv column-major", seconds([&] { mpfr::blas::gemv(mpfr::blas::col_major, 'N', n, n, 1, A.data(), n, x.data(), 1, 0, y.data(), 1); }));
+    report("gemv row-major", seconds([&] { mpfr::blas::gemv(mpfr::blas::row_major, 'N', n, n, 1, A.data(), n, x.data(), 1, 0, y.data(), 1); }));
+    report("gemv exact (mpfr_sum)", seconds([&] { mpfr::blas::gemv(mpfr::blas::col_major, 'N', n, n, 1, A.data(), n, x.data(), 1, 0, y.data(), 1, true); }));
+    report("symv", seconds([&] { mpfr::blas::symv(mpfr::blas::col_major, 'U', n, 1, A.data(), n, x.data(), 1, 0, y.data(), 1); }));
+    report("trsv", seconds([&] { mpfr::blas::trsv(mpfr::blas::col_major, 'L', 'N', 'N', n, A.data(), n, y.data(), 1); }));
+    report("ger", seconds([&] { mpfr::blas::ger(mpfr::blas::col_major, n, n, 1, x.data(), 1, y.data(), 1, A.data(), n); }));
+
+    gmp_randclear(state);
+    return 0;
+}
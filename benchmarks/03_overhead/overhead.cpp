@@ -0,0 +1,352 @@
+// Abstraction overhead of mpfr_class over raw mpfr_t, with mpreal alongside.
+//
+// Each kernel of overhead.h runs through the raw MPFR backend, mpfr_class and, when
+// mpreal.h is found, mpreal, interleaved and repeated. The report gives the median time
+// per run and the ratio to raw MPFR per kernel and precision. The program exits with 1
+// when an mpfr_class ratio is over its budget or a result disagrees with raw MPFR.
+//
+// Usage: overhead [--prec P1,P2,...] [--budget X] [--budget KERNEL=X] [--samples N]
+//                 [--min-time SECONDS] [--csv]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "mpfr_class.h"
+#include "overhead.h"
+
+namespace overhead {
+
+namespace {
+double now() { return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+}
+
+run raw_kernel(kernel k, mpfr_prec_t prec, long reps) {
+    run r = {0, 0};
+    mpfr_t s, t, u, v, w;
+    mpfr_inits2(prec, s, t, u, v, w, (mpfr_ptr)0);
+    switch (k) {
+    case dot:
+    case axpy: {
+        std::vector<__mpfr_struct> x(vector_length), y(vector_length);
+        for (long i = 0; i < vector_length; i++) {
+            mpfr_init2(&x[i], prec);
+            mpfr_init2(&y[i], prec);
+            input_x(&x[i], i);
+            input_y(&y[i], i);
+        }
+        mpfr_set_ui(t, 3, MPFR_RNDN);
+        mpfr_ui_div(t, 1, t, MPFR_RNDN);
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            if (k == dot) {
+                mpfr_set_zero(s, 1);
+                for (long i = 0; i < vector_length; i++)
+                    mpfr_fma(s, &x[i], &y[i], s, MPFR_RNDN);
+            } else {
+                for (long i = 0; i < vector_length; i++)
+                    mpfr_fma(&y[i], t, &x[i], &y[i], MPFR_RNDN);
+            }
+        }
+        r.seconds = now() - start;
+        r.value = mpfr_get_d(k == dot ? s : &y[vector_length - 1], MPFR_RNDN);
+        for (long i = 0; i < vector_length; i++) {
+            mpfr_clear(&x[i]);
+            mpfr_clear(&y[i]);
+        }
+        break;
+    }
+    case horner: {
+        std::vector<__mpfr_struct> c(horner_degree + 1);
+        for (long i = 0; i <= horner_degree; i++) {
+            mpfr_init2(&c[i], prec);
+            input_c(&c[i], i);
+        }
+        mpfr_set_d(t, 0.5, MPFR_RNDN);
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            mpfr_set(s, &c[horner_degree], MPFR_RNDN);
+            for (long i = horner_degree - 1; i >= 0; i--)
+                mpfr_fma(s, s, t, &c[i], MPFR_RNDN);
+        }
+        r.seconds = now() - start;
+        r.value = mpfr_get_d(s, MPFR_RNDN);
+        for (auto &ci : c)
+            mpfr_clear(&ci);
+        break;
+    }
+    case gauss_legendre: {
+        // a = s, b = t, t = u, p = v, pi = w
+        mpfr_t an, d, e;
+        mpfr_inits2(prec, an, d, e, (mpfr_ptr)0);
+        const long iterations = static_cast<long>(std::log2(static_cast<double>(prec))) + 1;
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            mpfr_set_ui(s, 1, MPFR_RNDN);
+            mpfr_sqrt_ui(t, 2, MPFR_RNDN);
+            mpfr_ui_div(t, 1, t, MPFR_RNDN);
+            mpfr_set_d(u, 0.25, MPFR_RNDN);
+            mpfr_set_ui(v, 1, MPFR_RNDN);
+            for (long it = 0; it < iterations; it++) {
+                mpfr_add(an, s, t, MPFR_RNDN);
+                mpfr_div_si(an, an, 2, MPFR_RNDN);
+                mpfr_mul(e, s, t, MPFR_RNDN);
+                mpfr_sqrt(t, e, MPFR_RNDN);
+                mpfr_sub(d, s, an, MPFR_RNDN);
+                mpfr_mul(e, v, d, MPFR_RNDN);
+                mpfr_mul(e, e, d, MPFR_RNDN);
+                mpfr_sub(u, u, e, MPFR_RNDN);
+                mpfr_mul_si(v, v, 2, MPFR_RNDN);
+                mpfr_set(s, an, MPFR_RNDN);
+            }
+            mpfr_add(e, s, t, MPFR_RNDN);
+            mpfr_add(d, s, t, MPFR_RNDN);
+            mpfr_mul(e, e, d, MPFR_RNDN);
+            mpfr_mul_si(d, u, 4, MPFR_RNDN);
+            mpfr_div(w, e, d, MPFR_RNDN);
+        }
+        r.seconds = now() - start;
+        r.value = mpfr_get_d(w, MPFR_RNDN);
+        mpfr_clears(an, d, e, (mpfr_ptr)0);
+        break;
+    }
+    case muller: {
+        // v1 = s, v2 = t, vn = u
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            mpfr_set_si(s, 2, MPFR_RNDN);
+            mpfr_set_si(t, -4, MPFR_RNDN);
+            for (long n = 0; n < muller_steps; n++) {
+                mpfr_si_div(v, 1130, t, MPFR_RNDN);
+                mpfr_si_sub(v, 111, v, MPFR_RNDN);
+                mpfr_mul(w, t, s, MPFR_RNDN);
+                mpfr_si_div(w, 3000, w, MPFR_RNDN);
+                mpfr_add(u, v, w, MPFR_RNDN);
+                mpfr_set(s, t, MPFR_RNDN);
+                mpfr_set(t, u, MPFR_RNDN);
+            }
+        }
+        r.seconds = now() - start;
+        r.value = mpfr_get_d(u, MPFR_RNDN);
+        break;
+    }
+    default:
+        break;
+    }
+    mpfr_clears(s, t, u, v, w, (mpfr_ptr)0);
+    return r;
+}
+
+// the same kernels as a user of mpfr_class writes them
+run class_kernel(kernel k, mpfr_prec_t prec, long reps) {
+    using mpfr::mpfr_class;
+    mpfr::precision_scope scope(prec);
+    run r = {0, 0};
+    switch (k) {
+    case dot:
+    case axpy: {
+        std::vector<mpfr_class> x(vector_length), y(vector_length);
+        for (long i = 0; i < vector_length; i++) {
+            input_x(x[i].get_mpfr_t(), i);
+            input_y(y[i].get_mpfr_t(), i);
+        }
+        const mpfr_class a = mpfr_class(1) / 3;
+        mpfr_class s;
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            if (k == dot) {
+                s = 0.0;
+                for (long i = 0; i < vector_length; i++)
+                    s += x[i] * y[i];
+            } else {
+                for (long i = 0; i < vector_length; i++)
+                    y[i] += a * x[i];
+            }
+        }
+        r.seconds = now() - start;
+        r.value = mpfr_get_d((k == dot ? s : y[vector_length - 1]).get_mpfr_t(), MPFR_RNDN);
+        break;
+    }
+    case horner: {
+        std::vector<mpfr_class> c(horner_degree + 1);
+        for (long i = 0; i <= horner_degree; i++)
+            input_c(c[i].get_mpfr_t(), i);
+        const mpfr_class x(0.5);
+        mpfr_class p;
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            p = c[horner_degree];
+            for (long i = horner_degree - 1; i >= 0; i--)
+                p = p * x + c[i];
+        }
+        r.seconds = now() - start;
+        r.value = mpfr_get_d(p.get_mpfr_t(), MPFR_RNDN);
+        break;
+    }
+    case gauss_legendre: {
+        const long iterations = static_cast<long>(std::log2(static_cast<double>(prec))) + 1;
+        mpfr_class a, b, t, p, an, d, pi;
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            a = 1.0;
+            b = 1 / mpfr::sqrt(mpfr_class(2.0));
+            t = 0.25;
+            p = 1.0;
+            for (long it = 0; it < iterations; it++) {
+                an = (a + b) / 2;
+                b = mpfr::sqrt(mpfr_class(a * b));
+                d = a - an;
+                t -= p * d * d;
+                p *= 2;
+                a = an;
+            }
+            pi = (a + b) * (a + b) / (4 * t);
+        }
+        r.seconds = now() - start;
+        r.value = mpfr_get_d(pi.get_mpfr_t(), MPFR_RNDN);
+        break;
+    }
+    case muller: {
+        mpfr_class v1, v2, vn;
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            v1 = 2;
+            v2 = -4;
+            for (long n = 0; n < muller_steps; n++) {
+                vn = 111 - 1130 / v2 + 3000 / (v2 * v1);
+                v1 = v2;
+                v2 = vn;
+            }
+        }
+        r.seconds = now() - start;
+        r.value = mpfr_get_d(vn.get_mpfr_t(), MPFR_RNDN);
+        break;
+    }
+    default:
+        break;
+    }
+    return r;
+}
+
+} // namespace overhead
+
+namespace {
+
+struct options {
+    std::vector<mpfr_prec_t> precs = {64, 128, 256, 512, 1024, 4096};
+    // the vector kernels fuse into mpfr_fma and match raw MPFR; the scalar recurrences
+    // pay for temporaries, most at low precision (about 1.6 at 64 bits)
+    double budget[overhead::kernel_count] = {1.25, 1.25, 1.25, 2.0, 2.0};
+    int samples = 7;
+    double min_time = 0.02;
+    bool csv = false;
+};
+
+bool parse(int argc, char **argv, options &opt) {
+    for (int i = 1; i < argc; i++) {
+        const std::string a = argv[i];
+        if (a == "--prec" && i + 1 < argc) {
+            opt.precs.clear();
+            std::stringstream ss(argv[++i]);
+            for (std::string p; std::getline(ss, p, ',');)
+                opt.precs.push_back(std::atol(p.c_str()));
+        } else if (a == "--budget" && i + 1 < argc) {
+            const std::string b = argv[++i];
+            const size_t eq = b.find('=');
+            if (eq == std::string::npos) {
+                std::fill(opt.budget, opt.budget + overhead::kernel_count, std::atof(b.c_str()));
+                continue;
+            }
+            int k = 0;
+            while (k < overhead::kernel_count && b.compare(0, eq, overhead::kernel_names[k]) != 0)
+                k++;
+            if (k == overhead::kernel_count) {
+                std::cerr << "Error: unknown kernel in --budget " << b << std::endl;
+                return false;
+            }
+            opt.budget[k] = std::atof(b.c_str() + eq + 1);
+        } else if (a == "--samples" && i + 1 < argc) {
+            opt.samples = std::max(1, std::atoi(argv[++i]));
+        } else if (a == "--min-time" && i + 1 < argc) {
+            opt.min_time = std::atof(argv[++i]);
+        } else if (a == "--csv") {
+            opt.csv = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--prec P1,P2,...] [--budget X] [--budget KERNEL=X] [--samples N] [--min-time SECONDS] [--csv]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v.size() % 2 ? v[v.size() / 2] : (v[v.size() / 2 - 1] + v[v.size() / 2]) / 2;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    options opt;
+    if (!parse(argc, argv, opt))
+        return 1;
+    const bool with_mpreal = overhead::mpreal_available();
+    if (!with_mpreal)
+        std::cerr << "mpreal.h was not found; the mpreal column is left out" << std::endl;
+
+    if (opt.csv)
+        std::cout << "kernel,prec,raw_ns,class_ns,class_ratio,mpreal_ns,mpreal_ratio,budget,status" << std::endl;
+    else
+        std::cout << std::left << std::setw(16) << "kernel" << std::right << std::setw(7) << "prec" << std::setw(14) << "raw ns" << std::setw(14) << "class ns" << std::setw(8)
+                  << "ratio" << std::setw(14) << "mpreal ns" << std::setw(8) << "ratio" << std::setw(8) << "budget" << "  status" << std::endl;
+    bool pass = true;
+    for (mpfr_prec_t prec : opt.precs)
+        for (int ki = 0; ki < overhead::kernel_count; ki++) {
+            const auto k = static_cast<overhead::kernel>(ki);
+            // enough repetitions for raw MPFR to take min_time per sample
+            long reps = 1;
+            for (double t = overhead::raw_kernel(k, prec, reps).seconds; t < opt.min_time; t = overhead::raw_kernel(k, prec, reps).seconds)
+                reps = t > 0 ? std::max(reps * 2, static_cast<long>(reps * opt.min_time / t * 1.2)) : reps * 16;
+            std::vector<double> raw, cls, mpr;
+            overhead::run r = {0, 0}, c = {0, 0}, m = {0, 0};
+            for (int s = 0; s < opt.samples; s++) {
+                r = overhead::raw_kernel(k, prec, reps);
+                c = overhead::class_kernel(k, prec, reps);
+                raw.push_back(r.seconds / reps * 1e9);
+                cls.push_back(c.seconds / reps * 1e9);
+                if (with_mpreal) {
+                    m = overhead::mpreal_kernel(k, prec, reps);
+                    mpr.push_back(m.seconds / reps * 1e9);
+                }
+            }
+            const double raw_ns = median(raw), class_ns = median(cls), ratio = class_ns / raw_ns;
+            const bool agrees = c.value == r.value || std::fabs(c.value - r.value) <= 1e-12 * std::fabs(r.value);
+            const bool ok = ratio <= opt.budget[k] && agrees;
+            pass = pass && ok;
+            const char *status = !agrees ? "MISMATCH" : (ok ? "ok" : "OVER");
+            const double mpreal_ns = with_mpreal ? median(mpr) : 0;
+            if (opt.csv) {
+                std::cout << overhead::kernel_names[k] << "," << prec << "," << raw_ns << "," << class_ns << "," << ratio << ",";
+                if (with_mpreal)
+                    std::cout << mpreal_ns << "," << mpreal_ns / raw_ns;
+                else
+                    std::cout << ",";
+                std::cout << "," << opt.budget[k] << "," << status << std::endl;
+            } else {
+                std::cout << std::left << std::setw(16) << overhead::kernel_names[k] << std::right << std::setw(7) << prec << std::fixed << std::setprecision(0) << std::setw(14)
+                          << raw_ns << std::setw(14) << class_ns << std::setprecision(2) << std::setw(8) << ratio;
+                if (with_mpreal)
+                    std::cout << std::setprecision(0) << std::setw(14) << mpreal_ns << std::setprecision(2) << std::setw(8) << mpreal_ns / raw_ns;
+                else
+                    std::cout << std::setw(14) << "-" << std::setw(8) << "-";
+                std::cout << std::setw(8) << opt.budget[k] << "  " << status << std::defaultfloat << std::endl;
+            }
+        }
+    std::cout << (pass ? "All kernels within budget." : "Overhead budget exceeded.") << std::endl;
+    return pass ? 0 : 1;
+}
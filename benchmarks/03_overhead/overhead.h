@@ -0,0 +1,47 @@
+#ifndef _MPFR_OVERHEAD_H_
+#define _MPFR_OVERHEAD_H_
+
+// The kernels of the overhead suite, written once per backend: raw mpfr_t calls,
+// mpfr_class and mpreal. Every backend builds the same inputs and performs the same
+// operations in the same order, so their results agree and only the wrapper differs.
+
+#include <mpfr.h>
+
+namespace overhead {
+
+enum kernel { dot, axpy, horner, gauss_legendre, muller, kernel_count };
+constexpr const char *kernel_names[kernel_count] = {"dot", "axpy", "horner", "gauss_legendre", "muller"};
+
+// sizes: vector length, polynomial degree, recurrence steps; Gauss-Legendre runs
+// log2(prec) + 1 iterations
+constexpr long vector_length = 1000, horner_degree = 1000, muller_steps = 100;
+
+struct run {
+    double seconds; // for all reps
+    double value;   // the last result, to check that the backends agree
+};
+
+// inputs: x_i = 1 / (i + 2), y_i = 1 - 1 / (i + 3), a = 1 / 3, and for Horner the
+// coefficients c_i = 1 / (i + 1) and the point 1 / 2
+inline void input_x(mpfr_ptr v, long i) {
+    mpfr_set_ui(v, i + 2, MPFR_RNDN);
+    mpfr_ui_div(v, 1, v, MPFR_RNDN);
+}
+inline void input_y(mpfr_ptr v, long i) {
+    mpfr_set_ui(v, i + 3, MPFR_RNDN);
+    mpfr_ui_div(v, 1, v, MPFR_RNDN);
+    mpfr_ui_sub(v, 1, v, MPFR_RNDN);
+}
+inline void input_c(mpfr_ptr v, long i) {
+    mpfr_set_ui(v, i + 1, MPFR_RNDN);
+    mpfr_ui_div(v, 1, v, MPFR_RNDN);
+}
+
+run raw_kernel(kernel k, mpfr_prec_t prec, long reps);
+run class_kernel(kernel k, mpfr_prec_t prec, long reps);
+bool mpreal_available();
+run mpreal_kernel(kernel k, mpfr_prec_t prec, long reps);
+
+} // namespace overhead
+
+#endif
@@ -0,0 +1,127 @@
+// The overhead kernels through mpreal, in a translation unit of their own: mpreal.h and
+// mpfr_class.h both declare functions in namespace mpfr. Built against MPLAPACK's
+// mpreal, define MPREAL_NEEDS_STATICS to provide the defaults it leaves to the program.
+
+#include "overhead.h"
+
+#if __has_include(<mpreal.h>)
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <mpreal.h>
+
+#ifdef MPREAL_NEEDS_STATICS
+mp_rnd_t mpfr::mpreal::default_rnd = MPFR_RNDN;
+mp_prec_t mpfr::mpreal::default_prec = 512;
+int mpfr::mpreal::default_base = 10;
+int mpfr::mpreal::double_bits = -1;
+#endif
+
+namespace overhead {
+
+namespace {
+double now() { return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+}
+
+bool mpreal_available() { return true; }
+
+run mpreal_kernel(kernel k, mpfr_prec_t prec, long reps) {
+    using mpfr::mpreal;
+    mpreal::set_default_prec(prec);
+    run r = {0, 0};
+    switch (k) {
+    case dot:
+    case axpy: {
+        std::vector<mpreal> x(vector_length), y(vector_length);
+        for (long i = 0; i < vector_length; i++) {
+            input_x(x[i].mpfr_ptr(), i);
+            input_y(y[i].mpfr_ptr(), i);
+        }
+        const mpreal a = mpreal(1) / 3;
+        mpreal s;
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            if (k == dot) {
+                s = 0.0;
+                for (long i = 0; i < vector_length; i++)
+                    s += x[i] * y[i];
+            } else {
+                for (long i = 0; i < vector_length; i++)
+                    y[i] += a * x[i];
+            }
+        }
+        r.seconds = now() - start;
+        r.value = (k == dot ? s : y[vector_length - 1]).toDouble();
+        break;
+    }
+    case horner: {
+        std::vector<mpreal> c(horner_degree + 1);
+        for (long i = 0; i <= horner_degree; i++)
+            input_c(c[i].mpfr_ptr(), i);
+        const mpreal x(0.5);
+        mpreal p;
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            p = c[horner_degree];
+            for (long i = horner_degree - 1; i >= 0; i--)
+                p = p * x + c[i];
+        }
+        r.seconds = now() - start;
+        r.value = p.toDouble();
+        break;
+    }
+    case gauss_legendre: {
+        const long iterations = static_cast<long>(std::log2(static_cast<double>(prec))) + 1;
+        mpreal a, b, t, p, an, d, pi;
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            a = 1.0;
+            b = 1 / mpfr::sqrt(mpreal(2.0));
+            t = 0.25;
+            p = 1.0;
+            for (long it = 0; it < iterations; it++) {
+                an = (a + b) / 2;
+                b = mpfr::sqrt(a * b);
+                d = a - an;
+                t -= p * d * d;
+                p *= 2;
+                a = an;
+            }
+            pi = (a + b) * (a + b) / (4 * t);
+        }
+        r.seconds = now() - start;
+        r.value = pi.toDouble();
+        break;
+    }
+    case muller: {
+        mpreal v1, v2, vn;
+        const double start = now();
+        for (long rep = 0; rep < reps; rep++) {
+            v1 = 2;
+            v2 = -4;
+            for (long n = 0; n < muller_steps; n++) {
+                vn = 111 - 1130 / v2 + 3000 / (v2 * v1);
+                v1 = v2;
+                v2 = vn;
+            }
+        }
+        r.seconds = now() - start;
+        r.value = vn.toDouble();
+        break;
+    }
+    default:
+        break;
+    }
+    return r;
+}
+
+} // namespace overhead
+
+#else
+
+namespace overhead {
+bool mpreal_available() { return false; }
+run mpreal_kernel(kernel, mpfr_prec_t, long) { return {0, 0}; }
+} // namespace overhead
+
+#endif
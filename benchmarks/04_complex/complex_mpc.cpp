@@ -0,0 +1,70 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <complex>
+#include <vector>
+#include <mpfr.h>
+#include <mpc.h>
+#include "mpc_class.h"
+
+// Complex dot and axpy through std::complex<mpfr_class>, which spends four real multiplies
+// and two adds on every product, against mpc_class and its fused kernels.
+
+gmp_randstate_t state;
+
+template <class F> double seconds(F f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <vector size> <precision> [threads]" << std::endl;
+        return 1;
+    }
+    const long n = std::atol(argv[1]);
+    mpfr::defaults::set_default_prec(std::atoi(argv[2]));
+    if (argc == 4)
+        mpfr::blas::set_num_threads(std::atoi(argv[3]));
+
+    using std_complex = std::complex<mpfr::mpfr_class>;
+    std::vector<mpfr::mpc_class> x(n), y(n);
+    std::vector<std_complex> sx(n), sy(n);
+    for (long i = 0; i < n; i++) {
+        mpc_urandom(x[i].get_mpc_t(), state);
+        mpc_urandom(y[i].get_mpc_t(), state);
+        sx[i] = std_complex(x[i].real(), x[i].imag());
+        sy[i] = std_complex(y[i].real(), y[i].imag());
+    }
+    const mpfr::mpc_class a(mpfr::mpfr_class(1) / 3, mpfr::mpfr_class(2) / 7);
+    const std_complex sa(a.real(), a.imag());
+
+    auto report = [](const char *name, double t) { std::cout << std::setw(32) << std::left << name << t << " s" << std::endl; };
+    std::cout << "n = " << n << ", prec = " << mpfr::defaults::get_default_prec() << ", threads = " << mpfr::blas::get_num_threads() << std::endl;
+    std_complex ss;
+    mpfr::mpc_class s;
+    report("dot std::complex<mpfr_class>", seconds([&] {
+               ss = std_complex(mpfr::mpfr_class(0.0), mpfr::mpfr_class(0.0));
+               for (long i = 0; i < n; i++)
+                   ss += sx[i] * sy[i];
+           }));
+    report("dot mpc_class loop", seconds([&] {
+               s = 0;
+               for (long i = 0; i < n; i++)
+                   s += x[i] * y[i];
+           }));
+    report("blas::dotu (mpc_dot)", seconds([&] { s = mpfr::blas::dotu(x, y); }));
+    report("axpy std::complex<mpfr_class>", seconds([&] {
+               for (long i = 0; i < n; i++)
+                   sy[i] += sa * sx[i];
+           }));
+    report("blas::axpy (mpc_class)", seconds([&] { mpfr::blas::axpy(a, x, y); }));
+
+    gmp_randclear(state);
+    return 0;
+}
@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_BENCH_H_
+#define _MPFR_BENCH_H_
+
+// A small micro-benchmark harness for the benchmarks/ programs.
+//
+//   bench::registry r;
+//   r.add("arith", "a + b", [](mpfr_prec_t prec) {
+//       auto a = ..., b = ..., c = ...;
+//       return [=](long n) mutable { for (long i = 0; i < n; i++) { c = a + b; bench::keep(c); } };
+//   });
+//   return r.run(argc, argv);
+//
+// A case makes its operands for a precision and returns the timed body, which runs n
+// operations. Every (case, precision) is calibrated to --min-time per sample, run
+// --warmup times untimed and --reps times timed, and reported as ns per operation:
+// median, percentiles, min and max. With --perf, Linux hardware counters are read
+// through perf_event_open around the timed samples and reported per operation.
+// Output is a text table, --csv or --json, to stdout or --output FILE.
+
+#include <mpfr.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+// keeps the compiler from dropping a result or hoisting an operand out of the loop
+template <class T> inline void keep(T &v) { asm volatile("" : : "g"(&v) : "memory"); }
+
+using body = std::function<void(long)>;
+using setup = std::function<body(mpfr_prec_t)>;
+
+struct options {
+    std::vector<mpfr_prec_t> precs = {53, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536};
+    int reps = 15, warmup = 3;
+    double min_time = 2e-3; // seconds per sample
+    std::string filter, format = "text", output;
+    bool perf = false;
+};
+
+struct result {
+    std::string group, name;
+    mpfr_prec_t prec;
+    long ops; // per sample
+    double median, p10, p90, p99, min, max, mean; // ns per operation
+    bool counted = false;
+    double cycles = 0, instructions = 0, cache_misses = 0, branch_misses = 0; // per operation
+};
+
+// the value below which a fraction q of the sorted samples falls, interpolated
+inline double percentile(const std::vector<double> &sorted, double q) {
+    if (sorted.empty())
+        return 0;
+    const double pos = q * (sorted.size() - 1);
+    const size_t i = static_cast<size_t>(pos);
+    return i + 1 < sorted.size() ? sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]) : sorted.back();
+}
+
+#ifdef __linux__
+// cycles, instructions, cache misses and branch misses of this thread, as one group
+class counters {
+  public:
+    counters() {
+        const unsigned long long config[4] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < 4; i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = config[i];
+            attr.disabled = i == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            fd[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fd[0], 0));
+            if (fd[i] < 0) {
+                close_all();
+                return;
+            }
+        }
+    }
+    ~counters() { close_all(); }
+    bool ok() const { return fd[0] >= 0; }
+    void start() {
+        ioctl(fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    // adds the counts since start() to total
+    void stop(unsigned long long total[4]) {
+        ioctl(fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        unsigned long long buf[5];
+        if (read(fd[0], buf, sizeof(buf)) == static_cast<ssize_t>(sizeof(buf)) && buf[0] == 4)
+            for (int i = 0; i < 4; i++)
+                total[i] += buf[i + 1];
+    }
+
+  private:
+    void close_all() {
+        for (int &f : fd) {
+            if (f >= 0)
+                close(f);
+            f = -1;
+        }
+    }
+    int fd[4] = {-1, -1, -1, -1};
+};
+#else
+class counters {
+  public:
+    bool ok() const { return false; }
+    void start() {}
+    void stop(unsigned long long[4]) {}
+};
+#endif
+
+class registry {
+  public:
+    void add(const std::string &group, const std::string &name, setup s) { cases.push_back({group, name, std::move(s)}); }
+
+    // parses the command line, runs the matching cases and writes the report
+    int run(int argc, char **argv) {
+        options opt;
+        if (!parse(argc, argv, opt))
+            return 1;
+        std::vector<result> results;
+        counters perf;
+        if (opt.perf && !perf.ok())
+            std::cerr << "perf_event_open is not available; running without counters" << std::endl;
+        for (mpfr_prec_t prec : opt.precs)
+            for (const auto &c : cases) {
+                if (!opt.filter.empty() && (c.group + "/" + c.name).find(opt.filter) == std::string::npos)
+                    continue;
+                results.push_back(measure(c, prec, opt, opt.perf && perf.ok() ? &perf : nullptr));
+                if (opt.format != "text" || !opt.output.empty())
+                    std::cerr << "." << std::flush;
+            }
+        if (opt.format != "text" || !opt.output.empty())
+            std::cerr << std::endl;
+        std::ofstream file;
+        if (!opt.output.empty()) {
+            file.open(opt.output);
+            if (!file) {
+                std::cerr << "Error: cannot open " << opt.output << std::endl;
+                return 1;
+            }
+        }
+        std::ostream &os = opt.output.empty() ? std::cout : file;
+        if (opt.format == "json")
+            write_json(os, results);
+        else if (opt.format == "csv")
+            write_csv(os, results);
+        else
+            write_text(os, results);
+        return 0;
+    }
+
+  private:
+    struct entry {
+        std::string group, name;
+        setup make;
+    };
+    std::vector<entry> cases;
+
+    static double seconds(const body &b, long n) {
+        const auto start = std::chrono::steady_clock::now();
+        b(n);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static result measure(const entry &c, mpfr_prec_t prec, const options &opt, counters *perf) {
+        const body b = c.make(prec);
+        // grow the operation count until one sample takes min_time
+        long n = 1;
+        for (double t = seconds(b, n); t < opt.min_time && n < (1L << 40); t = seconds(b, n))
+            n = t > 0 ? std::max(n * 2, static_cast<long>(n * opt.min_time / t * 1.2)) : n * 16;
+        for (int i = 0; i < opt.warmup; i++)
+            b(n);
+        std::vector<double> ns;
+        unsigned long long total[4] = {0, 0, 0, 0};
+        for (int i = 0; i < opt.reps; i++) {
+            if (perf)
+                perf->start();
+            const double t = seconds(b, n);
+            if (perf)
+                perf->stop(total);
+            ns.push_back(t * 1e9 / n);
+        }
+        std::sort(ns.begin(), ns.end());
+        result r;
+        r.group = c.group;
+        r.name = c.name;
+        r.prec = prec;
+        r.ops = n;
+        r.median = percentile(ns, 0.5);
+        r.p10 = percentile(ns, 0.1);
+        r.p90 = percentile(ns, 0.9);
+        r.p99 = percentile(ns, 0.99);
+        r.min = ns.front();
+        r.max = ns.back();
+        double sum = 0;
+        for (double v : ns)
+            sum += v;
+        r.mean = sum / ns.size();
+        if (perf) {
+            const double ops = static_cast<double>(n) * opt.reps;
+            r.counted = true;
+            r.cycles = total[0] / ops;
+            r.instructions = total[1] / ops;
+            r.cache_misses = total[2] / ops;
+            r.branch_misses = total[3] / ops;
+        }
+        return r;
+    }
+
+    static void usage(const char *argv0) {
+        std::cerr << "Usage: " << argv0 << " [--prec P1,P2,...] [--reps N] [--warmup N] [--min-time SECONDS] [--filter TEXT]" << std::endl
+                  << "       [--json | --csv] [--output FILE] [--perf]" << std::endl;
+    }
+    static bool parse(int argc, char **argv, options &opt) {
+        for (int i = 1; i < argc; i++) {
+            const std::string a = argv[i];
+            const bool has_value = i + 1 < argc;
+            if (a == "--prec" && has_value) {
+                opt.precs.clear();
+                std::stringstream ss(argv[++i]);
+                for (std::string p; std::getline(ss, p, ',');)
+                    opt.precs.push_back(std::atol(p.c_str()));
+            } else if (a == "--reps" && has_value) {
+                opt.reps = std::max(1, std::atoi(argv[++i]));
+            } else if (a == "--warmup" && has_value) {
+                opt.warmup = std::max(0, std::atoi(argv[++i]));
+            } else if (a == "--min-time" && has_value) {
+                opt.min_time = std::atof(argv[++i]);
+            } else if (a == "--filter" && has_value) {
+                opt.filter = argv[++i];
+            } else if (a == "--output" && has_value) {
+                opt.output = argv[++i];
+            } else if (a == "--json" || a == "--csv") {
+                opt.format = a.substr(2);
+            } else if (a == "--perf") {
+                opt.perf = true;
+            } else {
+                usage(argv[0]);
+                return false;
+            }
+        }
+        for (mpfr_prec_t p : opt.precs)
+            if (p < MPFR_PREC_MIN || p > MPFR_PREC_MAX) {
+                std::cerr << "Error: invalid precision " << p << std::endl;
+                return false;
+            }
+        return true;
+    }
+
+    static void write_text(std::ostream &os, const std::vector<result> &results) {
+        const bool counted = !results.empty() && results.front().counted;
+        os << std::left << std::setw(12) << "group" << std::setw(24) << "case" << std::right << std::setw(7) << "prec" << std::setw(12) << "median ns" << std::setw(12) << "p10"
+           << std::setw(12) << "p90" << std::setw(12) << "p99";
+        if (counted)
+            os << std::setw(12) << "cycles" << std::setw(12) << "instr" << std::setw(10) << "cache-m" << std::setw(10) << "branch-m";
+        os << std::endl;
+        os << std::fixed << std::setprecision(1);
+        for (const auto &r : results) {
+            os << std::left << std::setw(12) << r.group << std::setw(24) << r.name << std::right << std::setw(7) << r.prec << std::setw(12) << r.median << std::setw(12) << r.p10
+               << std::setw(12) << r.p90 << std::setw(12) << r.p99;
+            if (counted)
+                os << std::setw(12) << r.cycles << std::setw(12) << r.instructions << std::setw(10) << r.cache_misses << std::setw(10) << r.branch_misses;
+            os << std::endl;
+        }
+        os << std::defaultfloat;
+    }
+    static void write_csv(std::ostream &os, const std::vector<result> &results) {
+        os << "group,case,prec,ops,median_ns,p10_ns,p90_ns,p99_ns,min_ns,max_ns,mean_ns,cycles,instructions,cache_misses,branch_misses" << std::endl;
+        os << std::setprecision(6);
+        for (const auto &r : results) {
+            os << r.group << ",\"" << r.name << "\"," << r.prec << "," << r.ops << "," << r.median << "," << r.p10 << "," << r.p90 << "," << r.p99 << "," << r.min << "," << r.max << ","
+               << r.mean;
+            if (r.counted)
+                os << "," << r.cycles << "," << r.instructions << "," << r.cache_misses << "," << r.branch_misses;
+            else
+                os << ",,,,";
+            os << std::endl;
+        }
+    }
+    static std::string json_string(const std::string &s) {
+        std::string out = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+    static void write_json(std::ostream &os, const std::vector<result> &results) {
+        os << std::setprecision(6) << "[" << std::endl;
+        for (size_t i = 0; i < results.size(); i++) {
+            const auto &r = results[i];
+            os << "  {\"group\": " << json_string(r.group) << ", \"case\": " << json_string(r.name) << ", \"prec\": " << r.prec << ", \"ops\": " << r.ops << ", \"median_ns\": " << r.median
+               << ", \"p10_ns\": " << r.p10 << ", \"p90_ns\": " << r.p90 << ", \"p99_ns\": " << r.p99 << ", \"min_ns\": " << r.min << ", \"max_ns\": " << r.max << ", \"mean_ns\": " << r.mean;
+            if (r.counted)
+                os << ", \"cycles\": " << r.cycles << ", \"instructions\": " << r.instructions << ", \"cache_misses\": " << r.cache_misses << ", \"branch_misses\": " << r.branch_misses;
+            os << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+        }
+        os << "]" << std::endl;
+    }
+};
+
+} // namespace bench
+
+#endif
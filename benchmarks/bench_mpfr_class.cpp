@@ -0,0 +1,110 @@
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <mpfr.h>
+#include "mpfr_class.h"
+#include "mpfr_binary.h"
+#include "bench.h"
+
+// Every mpfr_class operator, the mixed double and integer operators, the common free
+// functions and construction/copy/move, swept over precision. See bench.h for options.
+
+using mpfr::mpfr_class;
+
+gmp_randstate_t state;
+
+// 1 + a random fraction, all bits of the precision significant
+mpfr_class operand() {
+    mpfr_class x(0.0);
+    mpfr_urandom(x.get_mpfr_t(), state, MPFR_RNDN);
+    return x + 1;
+}
+
+// runs the setup and every call of the body at the precision of the sample
+template <class F> bench::setup at_prec(F f) {
+    return [f](mpfr_prec_t prec) -> bench::body {
+        mpfr::precision_scope scope(prec);
+        auto b = f();
+        return [prec, b](long n) mutable {
+            mpfr::precision_scope scope(prec);
+            b(n);
+        };
+    };
+}
+
+#define BENCH_OP(group, name, stmt)                                                                                                                                         \
+    r.add(group, name, at_prec([] {                                                                                                                                        \
+              mpfr_class a = operand(), b = operand(), c = operand(), e = operand();                                                                                      \
+              const double d = 1.0 / 3;                                                                                                                                    \
+              const long l = 12345;                                                                                                                                        \
+              return [=](long n) mutable {                                                                                                                                 \
+                  for (long i = 0; i < n; i++) {                                                                                                                           \
+                      stmt;                                                                                                                                                \
+                      bench::keep(c);                                                                                                                                      \
+                  }                                                                                                                                                        \
+                  (void)d, (void)l, (void)e;                                                                                                                               \
+              };                                                                                                                                                           \
+          }))
+
+int main(int argc, char **argv) {
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+    bench::registry r;
+
+    BENCH_OP("construct", "default", mpfr_class x; bench::keep(x));
+    BENCH_OP("construct", "from double", mpfr_class x(d); bench::keep(x));
+    BENCH_OP("construct", "from long", mpfr_class x(l); bench::keep(x));
+    BENCH_OP("construct", "from string", mpfr_class x("3.14159265358979323846"); bench::keep(x));
+    BENCH_OP("construct", "copy", mpfr_class x(a); bench::keep(x));
+    BENCH_OP("construct", "move and back", mpfr_class x(std::move(a)); a = std::move(x));
+    BENCH_OP("construct", "copy assign", c = a);
+    BENCH_OP("construct", "move assign", mpfr_class x(a); c = std::move(x));
+
+    BENCH_OP("arith", "a + b", c = a + b);
+    BENCH_OP("arith", "a - b", c = a - b);
+    BENCH_OP("arith", "a * b", c = a * b);
+    BENCH_OP("arith", "a / b", c = a / b);
+    BENCH_OP("arith", "c += a, c -= a", c += a; c -= a);
+    BENCH_OP("arith", "c *= a, c /= a", c *= a; c /= a);
+    BENCH_OP("arith", "a * b + e (fma)", c = a * b + e);
+    BENCH_OP("arith", "a * b - c * e (fmms)", c = a * b - c * e);
+    BENCH_OP("arith", "(a + b) * (a - b)", c = (a + b) * (a - b));
+
+    BENCH_OP("mixed", "a + d", c = a + d);
+    BENCH_OP("mixed", "d + a", c = d + a);
+    BENCH_OP("mixed", "a - d", c = a - d);
+    BENCH_OP("mixed", "d - a", c = d - a);
+    BENCH_OP("mixed", "a * d", c = a * d);
+    BENCH_OP("mixed", "d * a", c = d * a);
+    BENCH_OP("mixed", "a / d", c = a / d);
+    BENCH_OP("mixed", "d / a", c = d / a);
+    BENCH_OP("mixed", "c += d, c -= d", c += d; c -= d);
+    BENCH_OP("mixed", "a + l", c = a + l);
+    BENCH_OP("mixed", "a * l", c = a * l);
+    BENCH_OP("mixed", "l / a", c = l / a);
+
+    BENCH_OP("compare", "a < b", bool t = a < b; bench::keep(t));
+    BENCH_OP("compare", "a == b", bool t = a == b; bench::keep(t));
+    BENCH_OP("compare", "a < d", bool t = a < d; bench::keep(t));
+
+    BENCH_OP("function", "sqrt", c = sqrt(a));
+    BENCH_OP("function", "abs", c = abs(a));
+    BENCH_OP("function", "exp", c = exp(a));
+    BENCH_OP("function", "log", c = log(a));
+    BENCH_OP("function", "sin", c = sin(a));
+    BENCH_OP("function", "cos", c = cos(a));
+    BENCH_OP("function", "tan", c = tan(a));
+    BENCH_OP("function", "atan2", c = atan2(a, b));
+    BENCH_OP("function", "sinh", c = sinh(a));
+    BENCH_OP("function", "pow", c = pow(a, b));
+    BENCH_OP("function", "const_pi", c = mpfr::const_pi());
+
+    BENCH_OP("io", "operator<<", std::ostringstream os; os << a; bench::keep(os));
+    BENCH_OP("io", "to_chars", static std::vector<char> buf; buf.resize(mpfr::to_chars_size(a.get_mpfr_t()));
+             char *end = mpfr::to_chars(buf.data(), buf.data() + buf.size(), a.get_mpfr_t()).ptr; bench::keep(end));
+    BENCH_OP("io", "binary::save", std::ostringstream os; mpfr::binary::save(os, a); bench::keep(os));
+
+    const int status = r.run(argc, argv);
+    gmp_randclear(state);
+    return status;
+}
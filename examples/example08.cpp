@@ -4,6 +4,7 @@
 #include "mpfr_class.h"
 
 void calculate_sequence(int prec) {
+    mpfr::profile::region profile; // see the report with -DMPFR_CLASS_PROFILE
     mpfr::defaults::set_default_prec(prec);
     mpfr::mpfr_class v1(2), v2(-4), vn, diff;
     int m = 10000;
@@ -12,7 +13,7 @@ void calculate_sequence(int prec) {
     bool hasConverged = false;
 
     for (int n = 3; n <= m && !hasConverged; ++n) {
-        vn = mpfr::mpfr_class("111") - mpfr::mpfr_class("1130") / v2 + mpfr::mpfr_class("3000") / (v2 * v1);
+        vn = 111 - 1130 / v2 + 3000 / (v2 * v1);
 
         diff = abs(vn - v2);
 
@@ -33,6 +34,8 @@ int main() {
     calculate_sequence(256);
     calculate_sequence(2048);
     calculate_sequence(4096);
+    if (mpfr::profile::enabled)
+        mpfr::profile::report();
 
     return 0;
 }
@@ -0,0 +1,24 @@
+// The sequence of example08 in ball arithmetic: one run at 256 bits, and each term says
+// how many of its bits are right, instead of reruns at 53, 113, 256, 2048 and 4096 bits.
+#include <iostream>
+#include <mpfr.h>
+#include "mpfr_class.h"
+#include "mpfr_ball.h"
+
+int main() {
+    mpfr::defaults::set_default_prec(256);
+    mpfr::mpfr_ball v1(2), v2(-4), vn;
+    std::cout.precision(30);
+
+    for (int n = 3; n <= 100; ++n) {
+        vn = 111 - 1130 / v2 + 3000 / (v2 * v1);
+        std::cout << "v" << n << ": " << vn << ", " << vn.correct_bits() << " correct bits" << std::endl;
+        if (vn.correct_bits() == 0) {
+            std::cout << "No bit of v" << n << " is certain at 256 bits; the limit 100 seen at lower precision is a rounding artifact." << std::endl;
+            break;
+        }
+        v1 = v2;
+        v2 = vn;
+    }
+    return 0;
+}
@@ -0,0 +1,851 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef _MPC_CLASS_H_
+#define _MPC_CLASS_H_
+
+#include "mpfr_class.h"
+#include "mpfr_blas.h"
+#include <mpc.h>
+#include <algorithm>
+#include <complex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// mpc_class: a complex number on MPC, made like mpfr_class. Both parts have the default
+// precision of the thread (precision_scope applies to it), operations round both parts
+// with defaults::rnd, limbs are allocated on first use and moves take them over.
+//
+// a * b of two mpc_class is an mpc_product until it is assigned or combined: a * b + c,
+// a * b - c, c + a * b, c - a * b, c += a * b and c -= a * b are fused. The four real
+// products are exact and each part is a single mpfr_sum, so each part is rounded once,
+// as by mpc_fma, at a fraction of its cost. std::complex<mpfr_class> rounds every real
+// product and sum and makes a temporary for each.
+//
+// blas::dotu and blas::dotc are mpc_dot, each part correctly rounded; blas::axpy and
+// blas::scal of mpfr_blas.h take vectors of mpc_class as they are, y += a * x fused.
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+
+inline mpc_rnd_t mpc_default_rnd() { return MPC_RND(defaults::rnd, defaults::rnd); }
+
+// x, -x or its conjugate on the limbs of x, for the fused operations and dotc
+inline void mpc_signed_view(mpfr_ptr view, mpfr_srcptr x, const bool negate) {
+    const int kind = mpfr_custom_get_kind(x);
+    const bool regular = kind == MPFR_REGULAR_KIND || kind == -MPFR_REGULAR_KIND;
+    mpfr_custom_init_set(view, negate ? -kind : kind, regular ? mpfr_custom_get_exp(x) : 0, mpfr_get_prec(x), mpfr_custom_get_significand(x));
+}
+inline void mpc_signed_view(mpc_ptr view, mpc_srcptr x, const bool negate_re, const bool negate_im) {
+    mpc_signed_view(mpc_realref(view), mpc_realref(x), negate_re);
+    mpc_signed_view(mpc_imagref(view), mpc_imagref(x), negate_im);
+}
+
+// rop = c +- a * b, or a * b - c with negate_c: exact products of the parts, then one
+// mpfr_sum per part. Infinities and NaNs go to mpc_fma for its complex semantics.
+inline void mpc_fused(mpc_ptr rop, mpc_srcptr a, mpc_srcptr b, mpc_srcptr c, const bool negate_product, const bool negate_c, const mpc_rnd_t rnd) {
+    mpc_t na, nc;
+    mpc_signed_view(na, a, negate_product, negate_product);
+    mpc_signed_view(nc, c, negate_c, negate_c);
+    if (!mpfr_number_p(mpc_realref(a)) || !mpfr_number_p(mpc_imagref(a)) || !mpfr_number_p(mpc_realref(b)) || !mpfr_number_p(mpc_imagref(b)) || !mpfr_number_p(mpc_realref(c)) ||
+        !mpfr_number_p(mpc_imagref(c))) {
+        mpc_fma(rop, na, b, nc, rnd);
+        return;
+    }
+    // the products, per thread, at the precision they need to be exact; they outlive any
+    // arena_scope of the caller, so they never take its memory
+    struct scratch {
+        mpfr_t t[4];
+        scratch() {
+            allocator::arena_suspend suspend;
+            for (auto &x : t)
+                mpfr_init2(x, MPFR_PREC_MIN);
+        }
+        ~scratch() {
+            for (auto &x : t)
+                mpfr_clear(x);
+        }
+    };
+    static thread_local scratch s;
+    const mpfr_prec_t pa = std::max(mpfr_get_prec(mpc_realref(a)), mpfr_get_prec(mpc_imagref(a)));
+    const mpfr_prec_t pb = std::max(mpfr_get_prec(mpc_realref(b)), mpfr_get_prec(mpc_imagref(b)));
+    if (mpfr_get_prec(s.t[0]) < pa + pb) {
+        allocator::arena_suspend suspend;
+        for (auto &x : s.t)
+            mpfr_set_prec(x, pa + pb);
+    }
+    mpfr_mul(s.t[0], mpc_realref(na), mpc_realref(b), MPFR_RNDN);
+    mpfr_mul(s.t[1], mpc_imagref(na), mpc_imagref(b), MPFR_RNDN);
+    mpfr_neg(s.t[1], s.t[1], MPFR_RNDN);
+    mpfr_mul(s.t[2], mpc_realref(na), mpc_imagref(b), MPFR_RNDN);
+    mpfr_mul(s.t[3], mpc_imagref(na), mpc_realref(b), MPFR_RNDN);
+    mpfr_ptr re[3] = {s.t[0], s.t[1], mpc_realref(nc)};
+    mpfr_ptr im[3] = {s.t[2], s.t[3], mpc_imagref(nc)};
+    mpfr_sum(mpc_realref(rop), re, 3, MPC_RND_RE(rnd));
+    mpfr_sum(mpc_imagref(rop), im, 3, MPC_RND_IM(rnd));
+}
+
+// an arithmetic scalar, exactly, for the mpc_*_fr functions; it goes through the same
+// types as with mpfr_class (see mpfr_scalar)
+class mpc_scalar {
+  public:
+    template <class S> explicit mpc_scalar(const S op) {
+        mpfr_custom_init(limbs, bits);
+        mpfr_custom_init_set(value, MPFR_ZERO_KIND, 0, bits, limbs);
+        set(static_cast<mpfr_scalar_t<S>>(op));
+    }
+    mpc_scalar(const mpc_scalar &) = delete; // value points into limbs
+    operator mpfr_srcptr() const { return value; }
+
+  private:
+    static constexpr mpfr_prec_t bits = 64; // a double, long or unsigned long exactly
+    mp_limb_t limbs[(bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS];
+    mpfr_t value;
+    void set(const double op) { mpfr_set_d(value, op, MPFR_RNDN); }
+    void set(const long op) { mpfr_set_si(value, op, MPFR_RNDN); }
+    void set(const unsigned long op) { mpfr_set_ui(value, op, MPFR_RNDN); }
+};
+template <class S> using mpc_enable_if_scalar = typename std::enable_if<std::is_arithmetic<S>::value && is_mpfr_scalar<S>::value, int>::type;
+
+class mpc_class;
+
+// a * b, evaluated when it is assigned or converted, fused when added to or subtracted
+// from an mpc_class. Like mpfr_expr, do not keep one around with auto.
+class mpc_product {
+  public:
+    mpc_product(const mpc_class &a, const mpc_class &b) : a(a), b(b) {}
+    const mpc_class &a;
+    const mpc_class &b;
+};
+
+class mpc_class {
+  public:
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.2 Initialization Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // No limbs are allocated until the object is first used, as with mpfr_class.
+    mpc_class() noexcept { empty(defaults::prec); }
+    ~mpc_class() {
+        if (has_limbs()) {
+            MPFR_CLASS_STATS_CLEAR(get_prec());
+            MPFR_CLASS_STATS_CLEAR(mpfr_get_prec(mpc_imagref(value)));
+            mpc_clear(value);
+        }
+    }
+    // both parts; the value becomes NaN
+    void set_prec(const mpfr_prec_t prec) {
+        if (has_limbs()) {
+            MPFR_CLASS_STATS_REALLOC(get_prec(), prec);
+            MPFR_CLASS_STATS_REALLOC(mpfr_get_prec(mpc_imagref(value)), prec);
+            mpc_set_prec(value, prec);
+        } else {
+            init2(prec);
+        }
+    }
+    // the precision of the real part, which is that of both unless set through get_mpc_t()
+    mpfr_prec_t get_prec() const { return mpfr_get_prec(mpc_realref(value)); }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.3 Assignment Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpc_class(mpc_class &&op) noexcept {
+        value[0] = op.value[0]; // take over the limbs of op and leave it without any
+        op.empty(get_prec());
+    }
+    mpc_class(const mpc_class &op) {
+        if (!op.has_limbs()) {
+            value[0] = op.value[0];
+            return;
+        }
+        init3(mpfr_get_prec(mpc_realref(op.value)), mpfr_get_prec(mpc_imagref(op.value)));
+        mpc_set(value, op.value, mpc_default_rnd());
+    }
+    ___MPFR_CLASS_EXPLICIT___ mpc_class(const mpc_t op) {
+        init3(mpfr_get_prec(mpc_realref(op)), mpfr_get_prec(mpc_imagref(op)));
+        mpc_set(value, op, mpc_default_rnd());
+    }
+    // everything else is made at the default precision
+    ___MPFR_CLASS_EXPLICIT___ mpc_class(const mpfr_class &re) {
+        init2(defaults::prec);
+        mpc_set_fr(value, re.get_mpfr_t(), mpc_default_rnd());
+    }
+    mpc_class(const mpfr_class &re, const mpfr_class &im) {
+        init2(defaults::prec);
+        mpc_set_fr_fr(value, re.get_mpfr_t(), im.get_mpfr_t(), mpc_default_rnd());
+    }
+    template <class S, mpc_enable_if_scalar<S> = 0> ___MPFR_CLASS_EXPLICIT___ mpc_class(const S re) {
+        init2(defaults::prec);
+        mpc_set_fr(value, mpc_scalar(re), mpc_default_rnd());
+    }
+    template <class S, class T, mpc_enable_if_scalar<S> = 0, mpc_enable_if_scalar<T> = 0> mpc_class(const S re, const T im) {
+        init2(defaults::prec);
+        mpc_set_fr_fr(value, mpc_scalar(re), mpc_scalar(im), mpc_default_rnd());
+    }
+    // mixed parts; without these a literal 0 would reach mpfr_class(const char *)
+    template <class S, mpc_enable_if_scalar<S> = 0> mpc_class(const S re, const mpfr_class &im) {
+        init2(defaults::prec);
+        mpc_set_fr_fr(value, mpc_scalar(re), im.get_mpfr_t(), mpc_default_rnd());
+    }
+    template <class S, mpc_enable_if_scalar<S> = 0> mpc_class(const mpfr_class &re, const S im) {
+        init2(defaults::prec);
+        mpc_set_fr_fr(value, re.get_mpfr_t(), mpc_scalar(im), mpc_default_rnd());
+    }
+    ___MPFR_CLASS_EXPLICIT___ mpc_class(const std::complex<double> &op) {
+        init2(defaults::prec);
+        mpc_set_d_d(value, op.real(), op.imag(), mpc_default_rnd());
+    }
+    // "(re im)" or a real number, as mpc_set_str reads them
+    mpc_class(const char *s, int base = defaults::base, mpc_rnd_t rnd = mpc_default_rnd()) {
+        init2(defaults::prec);
+        if (mpc_set_str(value, s, base, rnd) != 0) {
+            std::cerr << "Error initializing mpc_t from const char*: " << s << std::endl;
+            throw std::runtime_error("Failed to initialize mpc_t with given string.");
+        }
+    }
+    mpc_class(const std::string &s, int base = defaults::base, mpc_rnd_t rnd = mpc_default_rnd()) : mpc_class(s.c_str(), base, rnd) {}
+    mpc_class(const mpc_product &p) {
+        init2(defaults::prec);
+        MPFR_CLASS_STATS_OP(stats::mul, get_prec());
+        mpc_mul(value, p.a.get_mpc_t(), p.b.get_mpc_t(), mpc_default_rnd());
+    }
+    mpc_class &operator=(mpc_class op) noexcept { // copy-and-swap, as mpfr_class
+        mpc_swap(value, op.value);
+        return *this;
+    }
+    // the destination keeps its precision, as with mpfr_expr
+    mpc_class &operator=(const mpc_product &p) {
+        MPFR_CLASS_STATS_OP(stats::mul, get_prec());
+        mpc_mul(materialize(), p.a.get_mpc_t(), p.b.get_mpc_t(), mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &operator=(const mpfr_class &op) {
+        mpc_set_fr(materialize(), op.get_mpfr_t(), mpc_default_rnd());
+        return *this;
+    }
+    template <class S, mpc_enable_if_scalar<S> = 0> mpc_class &operator=(const S op) {
+        mpc_set_fr(materialize(), mpc_scalar(op), mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &operator=(const std::complex<double> &op) {
+        mpc_set_d_d(materialize(), op.real(), op.imag(), mpc_default_rnd());
+        return *this;
+    }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.4 Conversion Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_class real() const { return part(mpc_realref(get_mpc_t())); }
+    mpfr_class imag() const { return part(mpc_imagref(get_mpc_t())); }
+    std::complex<double> get_complex() const { return {mpfr_get_d(mpc_realref(get_mpc_t()), defaults::rnd), mpfr_get_d(mpc_imagref(get_mpc_t()), defaults::rnd)}; }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.7 Basic Arithmetic Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpc_class &operator+=(const mpc_class &rhs) {
+        MPFR_CLASS_STATS_OP(stats::add, get_prec());
+        mpc_add(materialize(), value, rhs.get_mpc_t(), mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &operator-=(const mpc_class &rhs) {
+        MPFR_CLASS_STATS_OP(stats::sub, get_prec());
+        mpc_sub(materialize(), value, rhs.get_mpc_t(), mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &operator*=(const mpc_class &rhs) {
+        MPFR_CLASS_STATS_OP(stats::mul, get_prec());
+        mpc_mul(materialize(), value, rhs.get_mpc_t(), mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &operator/=(const mpc_class &rhs) {
+        MPFR_CLASS_STATS_OP(stats::div, get_prec());
+        mpc_div(materialize(), value, rhs.get_mpc_t(), mpc_default_rnd());
+        return *this;
+    }
+    // c += a * b and c -= a * b: one rounding per part
+    mpc_class &operator+=(const mpc_product &p) {
+        MPFR_CLASS_STATS_OP(stats::fma, get_prec());
+        mpc_fused(materialize(), p.a.get_mpc_t(), p.b.get_mpc_t(), value, false, false, mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &operator-=(const mpc_product &p) {
+        MPFR_CLASS_STATS_OP(stats::fma, get_prec());
+        mpc_fused(materialize(), p.a.get_mpc_t(), p.b.get_mpc_t(), value, true, false, mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &operator*=(const mpc_product &p) { return *this *= mpc_class(p); }
+    mpc_class &operator/=(const mpc_product &p) { return *this /= mpc_class(p); }
+    // with a real: mpfr_class or an arithmetic scalar
+    mpc_class &operator+=(const mpfr_class &rhs) { return add_fr(rhs.get_mpfr_t()); }
+    mpc_class &operator-=(const mpfr_class &rhs) { return sub_fr(rhs.get_mpfr_t()); }
+    mpc_class &operator*=(const mpfr_class &rhs) { return mul_fr(rhs.get_mpfr_t()); }
+    mpc_class &operator/=(const mpfr_class &rhs) { return div_fr(rhs.get_mpfr_t()); }
+    template <class S, mpc_enable_if_scalar<S> = 0> mpc_class &operator+=(const S rhs) { return add_fr(mpc_scalar(rhs)); }
+    template <class S, mpc_enable_if_scalar<S> = 0> mpc_class &operator-=(const S rhs) { return sub_fr(mpc_scalar(rhs)); }
+    template <class S, mpc_enable_if_scalar<S> = 0> mpc_class &operator*=(const S rhs) { return mul_fr(mpc_scalar(rhs)); }
+    template <class S, mpc_enable_if_scalar<S> = 0> mpc_class &operator/=(const S rhs) { return div_fr(mpc_scalar(rhs)); }
+
+    // without limbs, both parts read as NaN headers, as with mpfr_class; reading allocates nothing
+    mpc_srcptr get_mpc_t() const { return value; }
+    mpc_ptr get_mpc_t() { return materialize(); } // for calling MPC directly
+
+  private:
+    mutable mpc_t value;
+    bool has_limbs() const { return mpfr_custom_get_significand(mpc_realref(value)) != nullptr; }
+    void empty(const mpfr_prec_t prec) const {
+        mpfr_custom_init_set(mpc_realref(value), MPFR_NAN_KIND, 0, prec, nullptr);
+        mpfr_custom_init_set(mpc_imagref(value), MPFR_NAN_KIND, 0, prec, nullptr);
+    }
+    mpc_ptr materialize() const {
+        if (!has_limbs())
+            init2(get_prec());
+        return value;
+    }
+    void init2(const mpfr_prec_t prec) const { init3(prec, prec); }
+    void init3(const mpfr_prec_t re, const mpfr_prec_t im) const {
+        mpc_init3(value, re, im);
+        MPFR_CLASS_STATS_INIT(re);
+        MPFR_CLASS_STATS_INIT(im);
+    }
+    static mpfr_class part(mpfr_srcptr x) {
+        mpfr_class rop;
+        rop.set_prec(mpfr_get_prec(x));
+        mpfr_set(rop.get_mpfr_t(), x, MPFR_RNDN);
+        return rop;
+    }
+    mpc_class &add_fr(mpfr_srcptr rhs) {
+        MPFR_CLASS_STATS_OP(stats::add, get_prec());
+        mpc_add_fr(materialize(), value, rhs, mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &sub_fr(mpfr_srcptr rhs) {
+        MPFR_CLASS_STATS_OP(stats::sub, get_prec());
+        mpc_sub_fr(materialize(), value, rhs, mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &mul_fr(mpfr_srcptr rhs) {
+        MPFR_CLASS_STATS_OP(stats::mul, get_prec());
+        mpc_mul_fr(materialize(), value, rhs, mpc_default_rnd());
+        return *this;
+    }
+    mpc_class &div_fr(mpfr_srcptr rhs) {
+        MPFR_CLASS_STATS_OP(stats::div, get_prec());
+        mpc_div_fr(materialize(), value, rhs, mpc_default_rnd());
+        return *this;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Operators. An expiring mpc_class operand is used as the destination and moved out as
+// the result, as with mpfr_class.
+////////////////////////////////////////////////////////////////////////////////////////
+// rop = f(rop, args...) in a new object at the default precision
+template <class F, class... Args> inline mpc_class mpc_apply(const stats::op_kind kind, F f, const Args &...args) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(kind, rop.get_prec());
+    (void)kind;
+    f(rop.get_mpc_t(), args..., mpc_default_rnd());
+    return rop;
+}
+// ... or in the expiring operand z, if it is at the default precision
+template <class F, class... Args> inline mpc_class mpc_reuse(mpc_class &&z, const stats::op_kind kind, F f, const Args &...args) {
+    if (z.get_prec() != defaults::prec)
+        return mpc_apply(kind, f, args...);
+    MPFR_CLASS_STATS_OP(kind, z.get_prec());
+    (void)kind;
+    f(z.get_mpc_t(), args..., mpc_default_rnd());
+    return std::move(z);
+}
+
+inline mpc_product operator*(const mpc_class &a, const mpc_class &b) { return mpc_product(a, b); }
+inline mpc_class operator+(const mpc_class &a, const mpc_class &b) { return mpc_apply(stats::add, mpc_add, a.get_mpc_t(), b.get_mpc_t()); }
+inline mpc_class operator+(mpc_class &&a, const mpc_class &b) { return mpc_reuse(std::move(a), stats::add, mpc_add, a.get_mpc_t(), b.get_mpc_t()); }
+inline mpc_class operator-(const mpc_class &a, const mpc_class &b) { return mpc_apply(stats::sub, mpc_sub, a.get_mpc_t(), b.get_mpc_t()); }
+inline mpc_class operator-(mpc_class &&a, const mpc_class &b) { return mpc_reuse(std::move(a), stats::sub, mpc_sub, a.get_mpc_t(), b.get_mpc_t()); }
+inline mpc_class operator/(const mpc_class &a, const mpc_class &b) { return mpc_apply(stats::div, mpc_div, a.get_mpc_t(), b.get_mpc_t()); }
+inline mpc_class operator/(mpc_class &&a, const mpc_class &b) { return mpc_reuse(std::move(a), stats::div, mpc_div, a.get_mpc_t(), b.get_mpc_t()); }
+
+// fused: a * b + c, c + a * b, a * b - c, c - a * b
+inline mpc_class operator+(const mpc_product &p, const mpc_class &c) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::fma, rop.get_prec());
+    mpc_fused(rop.get_mpc_t(), p.a.get_mpc_t(), p.b.get_mpc_t(), c.get_mpc_t(), false, false, mpc_default_rnd());
+    return rop;
+}
+inline mpc_class operator+(const mpc_class &c, const mpc_product &p) { return p + c; }
+inline mpc_class operator-(const mpc_product &p, const mpc_class &c) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::fma, rop.get_prec());
+    mpc_fused(rop.get_mpc_t(), p.a.get_mpc_t(), p.b.get_mpc_t(), c.get_mpc_t(), false, true, mpc_default_rnd());
+    return rop;
+}
+inline mpc_class operator-(const mpc_class &c, const mpc_product &p) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::fma, rop.get_prec());
+    mpc_fused(rop.get_mpc_t(), p.a.get_mpc_t(), p.b.get_mpc_t(), c.get_mpc_t(), true, false, mpc_default_rnd());
+    return rop;
+}
+// a * b + c * d: c * d is rounded, then fused with a * b
+inline mpc_class operator+(const mpc_product &p, const mpc_product &q) { return p + mpc_class(q); }
+inline mpc_class operator-(const mpc_product &p, const mpc_product &q) { return p - mpc_class(q); }
+
+// with a real: mpfr_class or an arithmetic scalar, on either side
+inline mpc_class operator+(const mpc_class &a, const mpfr_class &b) { return mpc_apply(stats::add, mpc_add_fr, a.get_mpc_t(), b.get_mpfr_t()); }
+inline mpc_class operator+(mpc_class &&a, const mpfr_class &b) { return mpc_reuse(std::move(a), stats::add, mpc_add_fr, a.get_mpc_t(), b.get_mpfr_t()); }
+inline mpc_class operator-(const mpc_class &a, const mpfr_class &b) { return mpc_apply(stats::sub, mpc_sub_fr, a.get_mpc_t(), b.get_mpfr_t()); }
+inline mpc_class operator-(mpc_class &&a, const mpfr_class &b) { return mpc_reuse(std::move(a), stats::sub, mpc_sub_fr, a.get_mpc_t(), b.get_mpfr_t()); }
+inline mpc_class operator*(const mpc_class &a, const mpfr_class &b) { return mpc_apply(stats::mul, mpc_mul_fr, a.get_mpc_t(), b.get_mpfr_t()); }
+inline mpc_class operator*(mpc_class &&a, const mpfr_class &b) { return mpc_reuse(std::move(a), stats::mul, mpc_mul_fr, a.get_mpc_t(), b.get_mpfr_t()); }
+inline mpc_class operator/(const mpc_class &a, const mpfr_class &b) { return mpc_apply(stats::div, mpc_div_fr, a.get_mpc_t(), b.get_mpfr_t()); }
+inline mpc_class operator/(mpc_class &&a, const mpfr_class &b) { return mpc_reuse(std::move(a), stats::div, mpc_div_fr, a.get_mpc_t(), b.get_mpfr_t()); }
+inline mpc_class operator+(const mpfr_class &a, const mpc_class &b) { return mpc_apply(stats::add, mpc_add_fr, b.get_mpc_t(), a.get_mpfr_t()); }
+inline mpc_class operator+(const mpfr_class &a, mpc_class &&b) { return mpc_reuse(std::move(b), stats::add, mpc_add_fr, b.get_mpc_t(), a.get_mpfr_t()); }
+inline mpc_class operator-(const mpfr_class &a, const mpc_class &b) { return mpc_apply(stats::sub, mpc_fr_sub, a.get_mpfr_t(), b.get_mpc_t()); }
+inline mpc_class operator-(const mpfr_class &a, mpc_class &&b) { return mpc_reuse(std::move(b), stats::sub, mpc_fr_sub, a.get_mpfr_t(), b.get_mpc_t()); }
+inline mpc_class operator*(const mpfr_class &a, const mpc_class &b) { return mpc_apply(stats::mul, mpc_mul_fr, b.get_mpc_t(), a.get_mpfr_t()); }
+inline mpc_class operator*(const mpfr_class &a, mpc_class &&b) { return mpc_reuse(std::move(b), stats::mul, mpc_mul_fr, b.get_mpc_t(), a.get_mpfr_t()); }
+inline mpc_class operator/(const mpfr_class &a, const mpc_class &b) { return mpc_apply(stats::div, mpc_fr_div, a.get_mpfr_t(), b.get_mpc_t()); }
+inline mpc_class operator/(const mpfr_class &a, mpc_class &&b) { return mpc_reuse(std::move(b), stats::div, mpc_fr_div, a.get_mpfr_t(), b.get_mpc_t()); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator+(const mpc_class &a, const S b) { return mpc_apply(stats::add, mpc_add_fr, a.get_mpc_t(), mpc_scalar(b)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator+(mpc_class &&a, const S b) { return mpc_reuse(std::move(a), stats::add, mpc_add_fr, a.get_mpc_t(), mpc_scalar(b)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator-(const mpc_class &a, const S b) { return mpc_apply(stats::sub, mpc_sub_fr, a.get_mpc_t(), mpc_scalar(b)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator-(mpc_class &&a, const S b) { return mpc_reuse(std::move(a), stats::sub, mpc_sub_fr, a.get_mpc_t(), mpc_scalar(b)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator*(const mpc_class &a, const S b) { return mpc_apply(stats::mul, mpc_mul_fr, a.get_mpc_t(), mpc_scalar(b)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator*(mpc_class &&a, const S b) { return mpc_reuse(std::move(a), stats::mul, mpc_mul_fr, a.get_mpc_t(), mpc_scalar(b)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator/(const mpc_class &a, const S b) { return mpc_apply(stats::div, mpc_div_fr, a.get_mpc_t(), mpc_scalar(b)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator/(mpc_class &&a, const S b) { return mpc_reuse(std::move(a), stats::div, mpc_div_fr, a.get_mpc_t(), mpc_scalar(b)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator+(const S a, const mpc_class &b) { return mpc_apply(stats::add, mpc_add_fr, b.get_mpc_t(), mpc_scalar(a)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator+(const S a, mpc_class &&b) { return mpc_reuse(std::move(b), stats::add, mpc_add_fr, b.get_mpc_t(), mpc_scalar(a)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator-(const S a, const mpc_class &b) { return mpc_apply(stats::sub, mpc_fr_sub, mpc_scalar(a), b.get_mpc_t()); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator-(const S a, mpc_class &&b) { return mpc_reuse(std::move(b), stats::sub, mpc_fr_sub, mpc_scalar(a), b.get_mpc_t()); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator*(const S a, const mpc_class &b) { return mpc_apply(stats::mul, mpc_mul_fr, b.get_mpc_t(), mpc_scalar(a)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator*(const S a, mpc_class &&b) { return mpc_reuse(std::move(b), stats::mul, mpc_mul_fr, b.get_mpc_t(), mpc_scalar(a)); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator/(const S a, const mpc_class &b) { return mpc_apply(stats::div, mpc_fr_div, mpc_scalar(a), b.get_mpc_t()); }
+template <class S, mpc_enable_if_scalar<S> = 0> inline mpc_class operator/(const S a, mpc_class &&b) { return mpc_reuse(std::move(b), stats::div, mpc_fr_div, mpc_scalar(a), b.get_mpc_t()); }
+
+// equal when both parts are, as mpfr_equal_p (NaNs are unequal)
+inline bool operator==(const mpc_class &a, const mpc_class &b) {
+    return mpfr_equal_p(mpc_realref(a.get_mpc_t()), mpc_realref(b.get_mpc_t())) && mpfr_equal_p(mpc_imagref(a.get_mpc_t()), mpc_imagref(b.get_mpc_t()));
+}
+inline bool operator!=(const mpc_class &a, const mpc_class &b) { return !(a == b); }
+
+// "(re,im)", each part formatted as operator<< of mpfr_class, padded as a whole like std::complex
+inline std::ostream &operator<<(std::ostream &os, const mpc_class &z) {
+    std::ostringstream s;
+    s.flags(os.flags());
+    s.precision(os.precision());
+    s << '(';
+    mpfr_write(s, mpc_realref(z.get_mpc_t()));
+    s << ',';
+    mpfr_write(s, mpc_imagref(z.get_mpc_t()));
+    s << ')';
+    return os << s.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// 5.7 - 5.10 Arithmetic, Power, Logarithm and Trigonometric Functions
+////////////////////////////////////////////////////////////////////////////////////////
+inline mpc_class sqr(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::mul, rop.get_prec());
+    mpc_sqr(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class sqr(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return sqr(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::mul, op.get_prec());
+    mpc_sqr(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class sqrt(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::sqrt, rop.get_prec());
+    mpc_sqrt(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class sqrt(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return sqrt(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::sqrt, op.get_prec());
+    mpc_sqrt(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class neg(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpc_neg(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class neg(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return neg(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, op.get_prec());
+    mpc_neg(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class conj(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpc_conj(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class conj(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return conj(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, op.get_prec());
+    mpc_conj(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class proj(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpc_proj(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class proj(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return proj(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, op.get_prec());
+    mpc_proj(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class exp(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_exp(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class exp(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return exp(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_exp(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class log(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_log(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class log(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return log(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_log(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class log10(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_log10(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class log10(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return log10(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_log10(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class sin(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_sin(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class sin(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return sin(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_sin(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class cos(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_cos(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class cos(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return cos(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_cos(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class tan(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_tan(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class tan(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return tan(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_tan(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class sinh(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_sinh(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class sinh(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return sinh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_sinh(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class cosh(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_cosh(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class cosh(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return cosh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_cosh(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class tanh(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_tanh(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class tanh(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return tanh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_tanh(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class asin(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_asin(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class asin(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return asin(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_asin(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class acos(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_acos(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class acos(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return acos(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_acos(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class atan(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_atan(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class atan(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return atan(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_atan(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class asinh(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_asinh(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class asinh(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return asinh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_asinh(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class acosh(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_acosh(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class acosh(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return acosh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_acosh(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+inline mpc_class atanh(const mpc_class &op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_atanh(rop.get_mpc_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class atanh(mpc_class &&op, mpc_rnd_t rnd = mpc_default_rnd()) {
+    if (op.get_prec() != defaults::prec)
+        return atanh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpc_atanh(op.get_mpc_t(), op.get_mpc_t(), rnd);
+    return std::move(op);
+}
+// multiplication by i (sign >= 0) or -i (sign < 0), exact
+inline mpc_class mul_i(const mpc_class &op, int sign, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpc_mul_i(rop.get_mpc_t(), op.get_mpc_t(), sign, rnd);
+    return rop;
+}
+inline mpc_class pow(const mpc_class &op1, const mpc_class &op2, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_pow(rop.get_mpc_t(), op1.get_mpc_t(), op2.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpc_class pow(const mpc_class &op1, const mpfr_class &op2, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_pow_fr(rop.get_mpc_t(), op1.get_mpc_t(), op2.get_mpfr_t(), rnd);
+    return rop;
+}
+inline mpc_class pow(const mpc_class &op1, long op2, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_pow_si(rop.get_mpc_t(), op1.get_mpc_t(), op2, rnd);
+    return rop;
+}
+inline mpc_class pow(const mpc_class &op1, double op2, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_pow_d(rop.get_mpc_t(), op1.get_mpc_t(), op2, rnd);
+    return rop;
+}
+inline mpc_class agm(const mpc_class &op1, const mpc_class &op2, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_agm(rop.get_mpc_t(), op1.get_mpc_t(), op2.get_mpc_t(), rnd);
+    return rop;
+}
+// a * b + c with one rounding per part, as mpc_fma
+inline mpc_class fma(const mpc_class &a, const mpc_class &b, const mpc_class &c, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::fma, rop.get_prec());
+    mpc_fused(rop.get_mpc_t(), a.get_mpc_t(), b.get_mpc_t(), c.get_mpc_t(), false, false, rnd);
+    return rop;
+}
+inline void sin_cos(mpc_class &s, mpc_class &c, const mpc_class &op, mpc_rnd_t rnd_sin = mpc_default_rnd(), mpc_rnd_t rnd_cos = mpc_default_rnd()) {
+    MPFR_CLASS_STATS_OP(stats::transcendental, s.get_prec());
+    mpc_sin_cos(s.get_mpc_t(), c.get_mpc_t(), op.get_mpc_t(), rnd_sin, rnd_cos);
+}
+// exp(2 pi i k / n)
+inline mpc_class rootofunity(unsigned long n, unsigned long k, mpc_rnd_t rnd = mpc_default_rnd()) {
+    mpc_class rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_rootofunity(rop.get_mpc_t(), n, k, rnd);
+    return rop;
+}
+// the real results, at the default precision
+inline mpfr_class real(const mpc_class &op) { return op.real(); }
+inline mpfr_class imag(const mpc_class &op) { return op.imag(); }
+inline mpfr_class abs(const mpc_class &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_class rop(0.0);
+    MPFR_CLASS_STATS_OP(stats::sqrt, rop.get_prec());
+    mpc_abs(rop.get_mpfr_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpfr_class norm(const mpc_class &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_class rop(0.0);
+    MPFR_CLASS_STATS_OP(stats::fma, rop.get_prec());
+    mpc_norm(rop.get_mpfr_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+inline mpfr_class arg(const mpc_class &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_class rop(0.0);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpc_arg(rop.get_mpfr_t(), op.get_mpc_t(), rnd);
+    return rop;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Complex kernels in the manner of mpfr_blas.h
+//   dotu  sum x_i * y_i        mpc_dot, each part correctly rounded
+//   dotc  sum conj(x_i) * y_i  the same on conjugate views of x
+//   axpy  y += a * x           mpfr_blas.h's axpy, fused and split across threads
+////////////////////////////////////////////////////////////////////////////////////////
+namespace blas {
+
+template <class X, class Y> inline mpc_class mpc_dot_views(const long n, X x, const long incx, Y y, const long incy, const bool conjugate) {
+    mpc_class rop(0);
+    if (n <= 0)
+        return rop;
+    std::vector<__mpc_struct> views(n); // mpc_dot only reads through these
+    std::vector<mpc_ptr> px(n), py(n);
+    const long ix = first_index(n, incx), iy = first_index(n, incy);
+    for (long i = 0; i < n; i++) {
+        mpc_signed_view(&views[i], x[ix + i * incx].get_mpc_t(), false, conjugate);
+        px[i] = &views[i];
+        py[i] = const_cast<mpc_ptr>(static_cast<mpc_srcptr>(y[iy + i * incy].get_mpc_t()));
+    }
+    MPFR_CLASS_STATS_OP(stats::fma, rop.get_prec());
+    mpc_dot(rop.get_mpc_t(), px.data(), py.data(), n, mpc_default_rnd());
+    return rop;
+}
+template <class X, class Y> inline mpc_class dotu(const long n, X x, const long incx, Y y, const long incy) { return mpc_dot_views(n, x, incx, y, incy, false); }
+template <class X, class Y> inline mpc_class dotc(const long n, X x, const long incx, Y y, const long incy) { return mpc_dot_views(n, x, incx, y, incy, true); }
+inline mpc_class dotu(const std::vector<mpc_class> &x, const std::vector<mpc_class> &y) {
+    check_sizes(x.size(), y.size());
+    return dotu(static_cast<long>(x.size()), x.begin(), 1, y.begin(), 1);
+}
+inline mpc_class dotc(const std::vector<mpc_class> &x, const std::vector<mpc_class> &y) {
+    check_sizes(x.size(), y.size());
+    return dotc(static_cast<long>(x.size()), x.begin(), 1, y.begin(), 1);
+}
+template <class A> inline void axpy(const A &a, const std::vector<mpc_class> &x, std::vector<mpc_class> &y) {
+    check_sizes(x.size(), y.size());
+    axpy(static_cast<long>(x.size()), a, x.begin(), y.begin());
+}
+template <class A> inline void scal(const A &a, std::vector<mpc_class> &x) { scal(static_cast<long>(x.size()), a, x.begin()); }
+
+} // namespace blas
+} // namespace mpfr
+
+#endif
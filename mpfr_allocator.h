@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_ALLOCATOR_H_
+#define _MPFR_ALLOCATOR_H_
+
+#include <gmp.h>
+#include <mpfr.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Opt-in allocator for GMP/MPFR limb memory, installed through mp_set_memory_functions.
+// Nothing changes at the call sites: every mpfr_init, mpfr_clear and temporary inside
+// MPFR goes through it once mpfr::allocator::install() has been called.
+//
+//   * blocks of 1 .. max_limbs limbs are recycled through per-thread free lists, one
+//     per limb count, so the common case takes no lock;
+//   * inside an arena_scope, allocations are carved out of large chunks and released
+//     all at once when the scope ends. Everything allocated in the scope must be gone
+//     by then (declare the arena_scope before the objects). The chunks are registered
+//     by address, so a block of a live arena may be freed or reallocated from any
+//     thread: a free does nothing, a reallocation copies it out;
+//   * state that outlives the scope must be allocated under an arena_suspend: caches
+//     filled on first use (the constants of const_pi and friends, interned literals,
+//     per-thread scratch such as mpc_class's) and any value handed to another scope.
+//     mpfr_class.h and mpc_class.h do so for their own caches, and ~arena_scope calls
+//     mpfr_free_cache() for MPFR's;
+//   * hits, misses and arena usage are counted per thread and summed by statistics().
+//
+// The sizes GMP and MPFR pass to the free function are exact; blocks are always
+// obtained from the memory functions that were active at install(), so blocks created
+// before install() or freed after uninstall() are handled correctly.
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+namespace allocator {
+
+constexpr size_t max_limbs = 257;           // 256 limbs of significand + MPFR's size header
+constexpr size_t max_cached_blocks = 1024;  // per thread and per limb count
+constexpr size_t arena_chunk_size = 1 << 20; // default arena chunk
+
+struct statistics {
+    unsigned long long hits = 0;              // allocations served from a free list
+    unsigned long long misses = 0;            // pooled sizes taken from the backing allocator
+    unsigned long long passthrough = 0;       // sizes which are not a whole number of limbs <= max_limbs
+    unsigned long long released = 0;          // frees returned to the backing allocator because a list was full
+    unsigned long long arena_allocations = 0; // allocations served by an arena_scope
+    unsigned long long arena_bytes = 0;       // bytes handed out by arena_scopes
+};
+
+class arena_scope;
+
+// Address ranges of the chunks of every live arena_scope, on any thread. Frees look
+// a block up here only while some arena exists.
+inline std::shared_mutex arena_chunks_mutex;
+inline std::map<std::uintptr_t, std::uintptr_t> arena_chunks; // begin -> end
+inline std::atomic<size_t> arena_chunks_live{0};
+
+inline void register_arena_chunk(const void *p, size_t size) {
+    std::unique_lock<std::shared_mutex> lock(arena_chunks_mutex);
+    arena_chunks[reinterpret_cast<std::uintptr_t>(p)] = reinterpret_cast<std::uintptr_t>(p) + size;
+    arena_chunks_live.fetch_add(1, std::memory_order_release);
+}
+inline void unregister_arena_chunk(const void *p) {
+    std::unique_lock<std::shared_mutex> lock(arena_chunks_mutex);
+    arena_chunks.erase(reinterpret_cast<std::uintptr_t>(p));
+    arena_chunks_live.fetch_sub(1, std::memory_order_release);
+}
+// true if p lies in a chunk of a live arena_scope of any thread
+inline bool in_arena(const void *p) {
+    if (arena_chunks_live.load(std::memory_order_acquire) == 0)
+        return false;
+    const std::uintptr_t a = reinterpret_cast<std::uintptr_t>(p);
+    std::shared_lock<std::shared_mutex> lock(arena_chunks_mutex);
+    auto it = arena_chunks.upper_bound(a);
+    if (it == arena_chunks.begin())
+        return false;
+    --it;
+    return a < it->second;
+}
+
+// per-thread counters; written only by the owning thread, read by statistics()
+struct thread_counters {
+    std::atomic<unsigned long long> hits{0}, misses{0}, passthrough{0}, released{0}, arena_allocations{0}, arena_bytes{0};
+    static void bump(std::atomic<unsigned long long> &c, unsigned long long n = 1) { c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    void add_to(statistics &s) const {
+        s.hits += hits.load(std::memory_order_relaxed);
+        s.misses += misses.load(std::memory_order_relaxed);
+        s.passthrough += passthrough.load(std::memory_order_relaxed);
+        s.released += released.load(std::memory_order_relaxed);
+        s.arena_allocations += arena_allocations.load(std::memory_order_relaxed);
+        s.arena_bytes += arena_bytes.load(std::memory_order_relaxed);
+    }
+};
+
+inline void *(*backing_allocate)(size_t) = nullptr;
+inline void *(*backing_reallocate)(void *, size_t, size_t) = nullptr;
+inline void (*backing_free)(void *, size_t) = nullptr;
+inline bool installed = false;
+
+inline std::mutex registry_mutex;
+inline std::vector<thread_counters *> registry;
+inline statistics retired; // counters of threads which have exited
+
+class thread_pool {
+  public:
+    thread_pool() {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(&counters);
+    }
+    ~thread_pool() {
+        flush();
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        counters.add_to(retired);
+        for (auto it = registry.begin(); it != registry.end(); ++it) {
+            if (*it == &counters) {
+                registry.erase(it);
+                break;
+            }
+        }
+    }
+    // returns the cached blocks to the backing allocator
+    void flush() {
+        for (size_t n = 1; n <= max_limbs; n++) {
+            while (free_list[n] != nullptr) {
+                void *p = free_list[n];
+                free_list[n] = *static_cast<void **>(p);
+                backing_free(p, n * sizeof(mp_limb_t));
+            }
+            cached[n] = 0;
+        }
+    }
+    void *free_list[max_limbs + 1] = {};
+    size_t cached[max_limbs + 1] = {};
+    thread_counters counters;
+    arena_scope *arena = nullptr; // innermost active arena_scope of this thread
+};
+
+// The pool is reached through a trivially destructible pointer so that frees which
+// happen late during thread exit, after the pool is gone, still work.
+inline thread_local thread_pool *this_thread_pool_ptr = nullptr;
+inline thread_local bool this_thread_pool_dead = false;
+struct thread_pool_guard {
+    ~thread_pool_guard() {
+        delete this_thread_pool_ptr;
+        this_thread_pool_ptr = nullptr;
+        this_thread_pool_dead = true;
+    }
+};
+inline thread_pool *this_thread_pool() {
+    if (this_thread_pool_ptr == nullptr && !this_thread_pool_dead) {
+        static thread_local thread_pool_guard guard;
+        (void)guard;
+        this_thread_pool_ptr = new thread_pool;
+    }
+    return this_thread_pool_ptr;
+}
+
+// limb count of a pooled size, 0 if the size is passed through
+inline size_t size_class(size_t size) {
+    if (size == 0 || size % sizeof(mp_limb_t) != 0 || size / sizeof(mp_limb_t) > max_limbs)
+        return 0;
+    return size / sizeof(mp_limb_t);
+}
+
+class arena_scope {
+  public:
+    explicit arena_scope(size_t chunk = arena_chunk_size) : chunk_size(chunk) {
+        pool = this_thread_pool();
+        if (pool != nullptr) {
+            outer = pool->arena;
+            pool->arena = this;
+        }
+    }
+    ~arena_scope() {
+        // MPFR's constant caches and mpz pool may hold arena memory
+        mpfr_free_cache();
+        if (pool != nullptr)
+            pool->arena = outer;
+        while (chunks != nullptr) {
+            chunk *next = chunks->next;
+            unregister_arena_chunk(chunks);
+            backing_free(chunks, chunks->size);
+            chunks = next;
+        }
+    }
+    arena_scope(const arena_scope &) = delete;
+    arena_scope &operator=(const arena_scope &) = delete;
+
+    void *allocate(size_t size) {
+        size = (size + alignment - 1) & ~(alignment - 1);
+        if (chunks == nullptr || chunks->used + size > chunks->size) {
+            size_t bytes = header_size + (size > chunk_size ? size : chunk_size);
+            chunk *c = static_cast<chunk *>(backing_allocate(bytes));
+            c->next = chunks;
+            c->size = bytes;
+            c->used = header_size;
+            chunks = c;
+            register_arena_chunk(c, bytes);
+        }
+        void *p = reinterpret_cast<unsigned char *>(chunks) + chunks->used;
+        chunks->used += size;
+        return p;
+    }
+
+  private:
+    struct chunk {
+        chunk *next;
+        size_t size;
+        size_t used;
+    };
+    static constexpr size_t alignment = 16;
+    static constexpr size_t header_size = (sizeof(chunk) + alignment - 1) & ~(alignment - 1);
+    chunk *chunks = nullptr;
+    arena_scope *outer = nullptr;
+    thread_pool *pool = nullptr;
+    size_t chunk_size;
+};
+
+// Allocations of this thread bypass its arenas while an arena_suspend is alive, for
+// state which outlives the innermost arena_scope. Arenas opened under it work as usual.
+class arena_suspend {
+  public:
+    arena_suspend() : pool(this_thread_pool()) {
+        if (pool != nullptr) {
+            saved = pool->arena;
+            pool->arena = nullptr;
+        }
+    }
+    ~arena_suspend() {
+        if (pool != nullptr)
+            pool->arena = saved;
+    }
+    arena_suspend(const arena_suspend &) = delete;
+    arena_suspend &operator=(const arena_suspend &) = delete;
+
+  private:
+    thread_pool *pool;
+    arena_scope *saved = nullptr;
+};
+
+inline void *pool_allocate(size_t size) {
+    thread_pool *pool = this_thread_pool();
+    if (pool == nullptr)
+        return backing_allocate(size);
+    if (pool->arena != nullptr) {
+        thread_counters::bump(pool->counters.arena_allocations);
+        thread_counters::bump(pool->counters.arena_bytes, size);
+        return pool->arena->allocate(size);
+    }
+    size_t n = size_class(size);
+    if (n == 0) {
+        thread_counters::bump(pool->counters.passthrough);
+        return backing_allocate(size);
+    }
+    void *p = pool->free_list[n];
+    if (p != nullptr) {
+        pool->free_list[n] = *static_cast<void **>(p);
+        pool->cached[n]--;
+        thread_counters::bump(pool->counters.hits);
+        return p;
+    }
+    thread_counters::bump(pool->counters.misses);
+    return backing_allocate(size);
+}
+
+inline void pool_free(void *ptr, size_t size) {
+    thread_pool *pool = this_thread_pool();
+    if (pool == nullptr) {
+        backing_free(ptr, size);
+        return;
+    }
+    if (in_arena(ptr))
+        return; // released with its arena, whichever thread frees it
+    size_t n = size_class(size);
+    if (n == 0 || pool->cached[n] >= max_cached_blocks) {
+        if (n != 0)
+            thread_counters::bump(pool->counters.released);
+        backing_free(ptr, size);
+        return;
+    }
+    *static_cast<void **>(ptr) = pool->free_list[n];
+    pool->free_list[n] = ptr;
+    pool->cached[n]++;
+}
+
+inline void *pool_reallocate(void *ptr, size_t old_size, size_t new_size) {
+    if (in_arena(ptr)) { // copied to where this thread allocates now, the arena keeps the old block
+        void *p = pool_allocate(new_size);
+        std::memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+        return p;
+    }
+    // every other block comes from the backing allocator, whatever its size; a block
+    // which lives outside an arena stays outside it.
+    return backing_reallocate(ptr, old_size, new_size);
+}
+
+inline void install() {
+    if (installed)
+        return;
+    mp_get_memory_functions(&backing_allocate, &backing_reallocate, &backing_free);
+    mp_set_memory_functions(pool_allocate, pool_reallocate, pool_free);
+    installed = true;
+}
+
+// Restores the previous memory functions. Free lists of other threads are returned
+// when those threads exit; no arena_scope may be active.
+inline void uninstall() {
+    if (!installed)
+        return;
+    mp_set_memory_functions(backing_allocate, backing_reallocate, backing_free);
+    installed = false;
+    if (thread_pool *pool = this_thread_pool())
+        pool->flush();
+}
+
+inline statistics get_statistics() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    statistics s = retired;
+    for (const thread_counters *c : registry)
+        c->add_to(s);
+    return s;
+}
+
+} // namespace allocator
+} // namespace mpfr
+
+#endif
@@ -0,0 +1,844 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_BACKEND_H_
+#define _MPFR_BACKEND_H_
+
+#include "mpfr_class.h"
+#include "mpfr_fixed.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <math.h>
+#include <string>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Fixed-width backends for the precisions where MPFR's general machinery costs the most.
+//
+//   mpfr_dd        double-double, 106 bits, on hardware FMA where there is one
+//   mpfr_float128  IEEE binary128 (_Float128), 113 bits, correctly rounded in software
+//   mpfr_qd        quad-double, 212 bits
+//
+// They take the mpfr_class API (constructors, compound and mixed operators with the
+// same scalars, comparisons, sqrt/abs/neg, the common transcendentals, operator<<), so
+// templated code is written once. Conversion from mpfr_class rounds to the backend's
+// width with defaults::rnd, so values of up to that many bits convert exactly within
+// the double exponent range. Conversion back is correctly rounded to the destination
+// and is exact when the destination holds every bit.
+//
+// dd and qd arithmetic rounds to nearest and is not correctly rounded. Each operation is
+// within a few units of 2^-106 (2^-212) relative, after Joldes, Muller and Popescu for
+// the double-word operations and Hida, Li and Bailey's QD library for quad-double. The
+// transcendentals go through MPFR at the backend's width.
+//
+// backend_t<Bits> is the fastest of these with at least Bits bits, or mpfr_fixed<Bits>
+// above 212; with_backend(prec, f) makes the same choice at run time:
+//
+//   template <class T> T dot(const std::vector<T> &x, const std::vector<T> &y);
+//   mpfr::backend_t<106> s = dot(x, y); // mpfr_dd
+//   mpfr::with_backend(prec, [&](auto tag) { using T = typename decltype(tag)::type; ... });
+////////////////////////////////////////////////////////////////////////////////////////
+
+namespace mpfr {
+
+// Error-free transformations: each result is the rounded value and the exact error.
+namespace eft {
+inline double two_sum(const double a, const double b, double &e) {
+    const double s = a + b;
+    const double bb = s - a;
+    e = (a - (s - bb)) + (b - bb);
+    return s;
+}
+// |a| >= |b| or a == 0
+inline double fast_two_sum(const double a, const double b, double &e) {
+    const double s = a + b;
+    e = b - (s - a);
+    return s;
+}
+inline double fma(const double a, const double b, const double c) {
+#ifdef FP_FAST_FMA
+    return std::fma(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+inline double two_prod(const double a, const double b, double &e) {
+    const double p = a * b;
+#ifdef FP_FAST_FMA
+    e = std::fma(a, b, -p);
+#else
+    // Dekker's product, with Veltkamp's splitting into 26 + 27 bits
+    const double split = 134217729.0; // 2^27 + 1
+    double t = split * a;
+    const double ah = t - (t - a), al = a - ah;
+    t = split * b;
+    const double bh = t - (t - b), bl = b - bh;
+    e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+    return p;
+}
+// (a, b, c) = a + b + c with |b| <= ulp(a), |c| <= ulp(b) (QD's three_sum)
+inline void three_sum(double &a, double &b, double &c) {
+    double t2, t3;
+    const double t1 = two_sum(a, b, t2);
+    a = two_sum(c, t1, t3);
+    b = two_sum(t2, t3, c);
+}
+// the same into two terms
+inline void three_sum2(double &a, double &b, const double c) {
+    double t2, t3;
+    const double t1 = two_sum(a, b, t2);
+    a = two_sum(c, t1, t3);
+    b = t2 + t3;
+}
+} // namespace eft
+
+// rop = x[0] + ... + x[n - 1], correctly rounded; every double is an exact 53-bit MPFR number
+inline int mpfr_backend_get(mpfr_ptr rop, const double *x, const int n, const mpfr_rnd_t rnd) {
+    if (!std::isfinite(x[0]))
+        return mpfr_set_d(rop, x[0], rnd);
+    mp_limb_t limbs[4][(53 + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS];
+    mpfr_t t[4];
+    mpfr_ptr p[4];
+    for (int i = 0; i < n; i++) {
+        mpfr_custom_init_set(t[i], MPFR_ZERO_KIND, 0, 53, limbs[i]);
+        mpfr_set_d(t[i], x[i], MPFR_RNDN);
+        p[i] = t[i];
+    }
+    return mpfr_sum(rop, p, n, rnd);
+}
+// op rounded to 53 * n bits with rnd, then split exactly into n doubles, largest first
+inline void mpfr_backend_set(double *x, const int n, mpfr_srcptr op, const mpfr_rnd_t rnd) {
+    mp_limb_t limbs[(4 * 53 + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS];
+    mpfr_t t;
+    mpfr_custom_init_set(t, MPFR_ZERO_KIND, 0, 53 * n, limbs);
+    mpfr_set(t, op, rnd);
+    for (int i = 0; i < n; i++) {
+        x[i] = mpfr_get_d(t, MPFR_RNDN);
+        if (!std::isfinite(x[i])) {
+            for (int j = i + 1; j < n; j++)
+                x[j] = 0.0;
+            return;
+        }
+        mpfr_sub_d(t, t, x[i], MPFR_RNDN); // exact: what is left has at most 53 * (n - i - 1) bits
+    }
+}
+
+template <class S> using mpfr_backend_enable_if_scalar = typename std::enable_if<std::is_arithmetic<S>::value && is_mpfr_scalar<S>::value, int>::type;
+
+////////////////////////////////////////////////////////////////////////////////////////
+// mpfr_dd: hi + lo with |lo| <= ulp(hi) / 2
+////////////////////////////////////////////////////////////////////////////////////////
+class mpfr_dd {
+  public:
+    static constexpr mpfr_prec_t prec = 106;
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.1 Initialization Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_dd() noexcept : x{std::numeric_limits<double>::quiet_NaN(), 0.0} {} // NaN, as mpfr_class
+    mpfr_dd(const double hi, const double lo) noexcept { x[0] = eft::two_sum(hi, lo, x[1]); }
+    mpfr_prec_t get_prec() const { return prec; }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.2 Assignment Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const double op) noexcept : x{op, 0.0} {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const float op) noexcept : x{op, 0.0} {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const int op) noexcept : x{static_cast<double>(op), 0.0} {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const unsigned int op) noexcept : x{static_cast<double>(op), 0.0} {}
+    // 64-bit integers in two exact halves
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const long int op) noexcept : mpfr_dd(static_cast<double>(op >> 32) * 4294967296.0, static_cast<double>(op & 0xffffffffL)) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const unsigned long int op) noexcept : mpfr_dd(static_cast<double>(op >> 32) * 4294967296.0, static_cast<double>(op & 0xffffffffUL)) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const long double op) noexcept {
+        x[0] = static_cast<double>(op);
+        x[1] = std::isfinite(x[0]) ? static_cast<double>(op - x[0]) : 0.0;
+    }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const mpfr_t &op, mpfr_rnd_t rnd = defaults::rnd) noexcept { mpfr_backend_set(x, 2, op, rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) noexcept { mpfr_backend_set(x, 2, op.get_mpfr_t(), rnd); }
+#ifdef MPFR_WANT_FLOAT128
+    ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const _Float128 op, mpfr_rnd_t rnd = defaults::rnd) noexcept : mpfr_dd(mpfr_fixed<113>(op), rnd) {}
+#endif
+    mpfr_dd(const char *s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) : mpfr_dd(mpfr_fixed<prec>(s, base, rnd)) {}
+    mpfr_dd(const std::string &s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) : mpfr_dd(mpfr_fixed<prec>(s, base, rnd)) {}
+    template <mpfr_prec_t Bits> ___MPFR_CLASS_EXPLICIT___ mpfr_dd(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) noexcept { mpfr_backend_set(x, 2, op.get_mpfr_t(), rnd); }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.4 Conversion Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // the components, largest first
+    double operator[](const int i) const { return x[i]; }
+    int get_mpfr(mpfr_ptr rop, mpfr_rnd_t rnd = defaults::rnd) const { return mpfr_backend_get(rop, x, 2, rnd); }
+    ___MPFR_CLASS_EXPLICIT___ operator mpfr_class() const {
+        mpfr_class rop;
+        get_mpfr(rop.get_mpfr_t());
+        return rop;
+    }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.5 Arithmetic Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_dd &operator+=(const mpfr_dd &b) { // AccurateDWPlusDW, 3u^2
+        double sl, tl, vl;
+        const double sh = eft::two_sum(x[0], b.x[0], sl);
+        const double th = eft::two_sum(x[1], b.x[1], tl);
+        const double vh = eft::fast_two_sum(sh, sl + th, vl);
+        x[0] = eft::fast_two_sum(vh, tl + vl, x[1]);
+        return special(sh);
+    }
+    mpfr_dd &operator-=(const mpfr_dd &b) { return *this += mpfr_dd(-b.x[0], -b.x[1], 0); }
+    mpfr_dd &operator*=(const mpfr_dd &b) { // DWTimesDW3, 4u^2
+        double cl1;
+        const double ch = eft::two_prod(x[0], b.x[0], cl1);
+        const double cl2 = eft::fma(x[1], b.x[0], eft::fma(x[0], b.x[1], x[1] * b.x[1]));
+        x[0] = eft::fast_two_sum(ch, cl1 + cl2, x[1]);
+        return special(ch);
+    }
+    mpfr_dd &operator/=(const mpfr_dd &b) { // DWDivDW2, 15u^2
+        const double th = x[0] / b.x[0];
+        double rl;
+        const double rh = eft::two_prod(b.x[0], th, rl);
+        const double dl = x[1] - eft::fma(b.x[1], th, rl);
+        const double tl = ((x[0] - rh) + dl) / b.x[0];
+        x[0] = eft::fast_two_sum(th, tl, x[1]);
+        return special(th);
+    }
+    mpfr_dd &operator+=(const double b) { // DWPlusFP, 2u^2
+        double sl;
+        const double sh = eft::two_sum(x[0], b, sl);
+        x[0] = eft::fast_two_sum(sh, x[1] + sl, x[1]);
+        return special(sh);
+    }
+    mpfr_dd &operator-=(const double b) { return *this += -b; }
+    mpfr_dd &operator*=(const double b) { // DWTimesFP3, 2u^2
+        double cl1;
+        const double ch = eft::two_prod(x[0], b, cl1);
+        x[0] = eft::fast_two_sum(ch, eft::fma(x[1], b, cl1), x[1]);
+        return special(ch);
+    }
+    mpfr_dd &operator/=(const double b) { // DWDivFP3, 3u^2
+        const double th = x[0] / b;
+        double pl;
+        const double ph = eft::two_prod(th, b, pl);
+        const double tl = (((x[0] - ph) - pl) + x[1]) / b;
+        x[0] = eft::fast_two_sum(th, tl, x[1]);
+        return special(th);
+    }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_dd &operator+=(const S b) { return *this += mpfr_dd(mpfr_scalar_t<S>(b)); }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_dd &operator-=(const S b) { return *this -= mpfr_dd(mpfr_scalar_t<S>(b)); }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_dd &operator*=(const S b) { return *this *= mpfr_dd(mpfr_scalar_t<S>(b)); }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_dd &operator/=(const S b) { return *this /= mpfr_dd(mpfr_scalar_t<S>(b)); }
+    friend mpfr_dd sqrt(const mpfr_dd &op) {
+        if (!(op.x[0] > 0.0) || std::isinf(op.x[0]))
+            return mpfr_dd(std::sqrt(op.x[0]));
+        // one Newton step from the double square root, with the residual taken exactly
+        const double s = std::sqrt(op.x[0]);
+        double pl;
+        const double ph = eft::two_prod(s, s, pl);
+        const double t = (((op.x[0] - ph) - pl) + op.x[1]) / (2.0 * s);
+        mpfr_dd rop;
+        rop.x[0] = eft::fast_two_sum(s, t, rop.x[1]);
+        return rop;
+    }
+    friend mpfr_dd neg(const mpfr_dd &op) { return mpfr_dd(-op.x[0], -op.x[1], 0); }
+    friend mpfr_dd abs(const mpfr_dd &op) { return op.x[0] < 0.0 ? neg(op) : op; }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.6 Comparison Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    friend bool operator==(const mpfr_dd &a, const mpfr_dd &b) { return a.x[0] == b.x[0] && (a.x[1] == b.x[1] || std::isinf(a.x[0])); }
+    friend bool operator!=(const mpfr_dd &a, const mpfr_dd &b) { return !(a == b) && !a.is_nan() && !b.is_nan(); }
+    friend bool operator<(const mpfr_dd &a, const mpfr_dd &b) { return a.x[0] < b.x[0] || (a.x[0] == b.x[0] && std::isfinite(a.x[0]) && a.x[1] < b.x[1]); }
+    friend bool operator>(const mpfr_dd &a, const mpfr_dd &b) { return b < a; }
+    friend bool operator<=(const mpfr_dd &a, const mpfr_dd &b) { return a < b || a == b; }
+    friend bool operator>=(const mpfr_dd &a, const mpfr_dd &b) { return b < a || a == b; }
+    bool is_nan() const { return std::isnan(x[0]); }
+    bool is_inf() const { return std::isinf(x[0]); }
+
+  private:
+    mpfr_dd(const double hi, const double lo, int) noexcept : x{hi, lo} {} // already normalized
+    // an infinite or NaN result is the double one, the error terms being NaN by then
+    mpfr_dd &special(const double hi) {
+        if (!std::isfinite(x[0])) {
+            x[0] = hi;
+            x[1] = 0.0;
+        }
+        return *this;
+    }
+    double x[2];
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+// mpfr_qd: four non-overlapping doubles, largest first
+////////////////////////////////////////////////////////////////////////////////////////
+namespace eft {
+// QD's renormalization of four or five terms into four non-overlapping ones
+inline void renorm(double &c0, double &c1, double &c2, double &c3) {
+    if (std::isinf(c0))
+        return;
+    double s0, s1, s2 = 0.0, s3 = 0.0;
+    s0 = fast_two_sum(c2, c3, c3);
+    s0 = fast_two_sum(c1, s0, c2);
+    c0 = fast_two_sum(c0, s0, c1);
+    s0 = c0;
+    s1 = c1;
+    if (s1 != 0.0) {
+        s1 = fast_two_sum(s1, c2, s2);
+        if (s2 != 0.0)
+            s2 = fast_two_sum(s2, c3, s3);
+        else
+            s1 = fast_two_sum(s1, c3, s2);
+    } else {
+        s0 = fast_two_sum(s0, c2, s1);
+        if (s1 != 0.0)
+            s1 = fast_two_sum(s1, c3, s2);
+        else
+            s0 = fast_two_sum(s0, c3, s1);
+    }
+    c0 = s0;
+    c1 = s1;
+    c2 = s2;
+    c3 = s3;
+}
+inline void renorm(double &c0, double &c1, double &c2, double &c3, double &c4) {
+    if (std::isinf(c0))
+        return;
+    double s0, s1, s2 = 0.0, s3 = 0.0;
+    s0 = fast_two_sum(c3, c4, c4);
+    s0 = fast_two_sum(c2, s0, c3);
+    s0 = fast_two_sum(c1, s0, c2);
+    c0 = fast_two_sum(c0, s0, c1);
+    s0 = c0;
+    s1 = c1;
+    if (s1 != 0.0) {
+        s1 = fast_two_sum(s1, c2, s2);
+        if (s2 != 0.0) {
+            s2 = fast_two_sum(s2, c3, s3);
+            if (s3 != 0.0)
+                s3 += c4;
+            else
+                s2 = fast_two_sum(s2, c4, s3);
+        } else {
+            s1 = fast_two_sum(s1, c3, s2);
+            if (s2 != 0.0)
+                s2 = fast_two_sum(s2, c4, s3);
+            else
+                s1 = fast_two_sum(s1, c4, s2);
+        }
+    } else {
+        s0 = fast_two_sum(s0, c2, s1);
+        if (s1 != 0.0) {
+            s1 = fast_two_sum(s1, c3, s2);
+            if (s2 != 0.0)
+                s2 = fast_two_sum(s2, c4, s3);
+            else
+                s1 = fast_two_sum(s1, c4, s2);
+        } else {
+            s0 = fast_two_sum(s0, c3, s1);
+            if (s1 != 0.0)
+                s1 = fast_two_sum(s1, c4, s2);
+            else
+                s0 = fast_two_sum(s0, c4, s1);
+        }
+    }
+    c0 = s0;
+    c1 = s1;
+    c2 = s2;
+    c3 = s3;
+}
+// adds c into the accumulator (a, b); returns a finished term, or 0 while it is still open
+inline double three_accum(double &a, double &b, const double c) {
+    double s = two_sum(b, c, b);
+    s = two_sum(a, s, a);
+    const bool za = a != 0.0, zb = b != 0.0;
+    if (za && zb)
+        return s;
+    if (!zb) {
+        b = a;
+        a = s;
+    } else {
+        a = s;
+    }
+    return 0.0;
+}
+} // namespace eft
+
+class mpfr_qd {
+  public:
+    static constexpr mpfr_prec_t prec = 212;
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.1 Initialization Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_qd() noexcept : x{std::numeric_limits<double>::quiet_NaN(), 0.0, 0.0, 0.0} {} // NaN, as mpfr_class
+    mpfr_prec_t get_prec() const { return prec; }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.2 Assignment Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const double op) noexcept : x{op, 0.0, 0.0, 0.0} {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const float op) noexcept : x{op, 0.0, 0.0, 0.0} {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const int op) noexcept : x{static_cast<double>(op), 0.0, 0.0, 0.0} {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const unsigned int op) noexcept : x{static_cast<double>(op), 0.0, 0.0, 0.0} {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const long int op) noexcept : mpfr_qd(mpfr_dd(op)) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const unsigned long int op) noexcept : mpfr_qd(mpfr_dd(op)) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const long double op) noexcept : mpfr_qd(mpfr_dd(op)) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const mpfr_dd &op) noexcept : x{op[0], op[1], 0.0, 0.0} {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const mpfr_t &op, mpfr_rnd_t rnd = defaults::rnd) noexcept { mpfr_backend_set(x, 4, op, rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) noexcept { mpfr_backend_set(x, 4, op.get_mpfr_t(), rnd); }
+#ifdef MPFR_WANT_FLOAT128
+    ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const _Float128 op) noexcept : mpfr_qd(mpfr_fixed<113>(op)) {}
+#endif
+    mpfr_qd(const char *s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) : mpfr_qd(mpfr_fixed<prec>(s, base, rnd)) {}
+    mpfr_qd(const std::string &s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) : mpfr_qd(mpfr_fixed<prec>(s, base, rnd)) {}
+    template <mpfr_prec_t Bits> ___MPFR_CLASS_EXPLICIT___ mpfr_qd(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) noexcept { mpfr_backend_set(x, 4, op.get_mpfr_t(), rnd); }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.4 Conversion Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // the components, largest first
+    double operator[](const int i) const { return x[i]; }
+    int get_mpfr(mpfr_ptr rop, mpfr_rnd_t rnd = defaults::rnd) const { return mpfr_backend_get(rop, x, 4, rnd); }
+    ___MPFR_CLASS_EXPLICIT___ operator mpfr_class() const {
+        mpfr_class rop;
+        get_mpfr(rop.get_mpfr_t());
+        return rop;
+    }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.5 Arithmetic Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_qd &operator+=(const mpfr_qd &b) {
+        // QD's sloppy_add is exact but for O(eps^4 max(|a|, |b|)), so it stands unless the sum cancels
+        double t0, t1, t2, t3;
+        double s0 = eft::two_sum(x[0], b.x[0], t0);
+        double s1 = eft::two_sum(x[1], b.x[1], t1);
+        double s2 = eft::two_sum(x[2], b.x[2], t2);
+        double s3 = eft::two_sum(x[3], b.x[3], t3);
+        s1 = eft::two_sum(s1, t0, t0);
+        eft::three_sum(s2, t0, t1);
+        eft::three_sum2(s3, t0, t2);
+        t0 = t0 + t1 + t3;
+        eft::renorm(s0, s1, s2, s3, t0);
+        const double x0 = x[0] + b.x[0];
+        if (!(std::abs(s0) >= 0.5 * std::max(std::abs(x[0]), std::abs(b.x[0]))))
+            return ieee_add(b).special(x0);
+        set(s0, s1, s2, s3);
+        return special(x0);
+    }
+    mpfr_qd &operator-=(const mpfr_qd &b) { return *this += neg(b); }
+    mpfr_qd &operator*=(const mpfr_qd &b) { // QD's sloppy_mul: the terms down to eps^3, then renormalized
+        const double *a = x;
+        double q0, q1, q2, q3, q4, q5;
+        double p0 = eft::two_prod(a[0], b.x[0], q0);
+        double p1 = eft::two_prod(a[0], b.x[1], q1);
+        double p2 = eft::two_prod(a[1], b.x[0], q2);
+        double p3 = eft::two_prod(a[0], b.x[2], q3);
+        double p4 = eft::two_prod(a[1], b.x[1], q4);
+        double p5 = eft::two_prod(a[2], b.x[0], q5);
+        eft::three_sum(p1, p2, q0);
+        eft::three_sum(p2, q1, q2);
+        eft::three_sum(p3, p4, p5);
+        double t0, t1;
+        double s0 = eft::two_sum(p2, p3, t0);
+        double s1 = eft::two_sum(q1, p4, t1);
+        double s2 = q2 + p5;
+        s1 = eft::two_sum(s1, t0, t0);
+        s2 += t0 + t1;
+        s1 += a[0] * b.x[3] + a[1] * b.x[2] + a[2] * b.x[1] + a[3] * b.x[0] + q0 + q3 + q4 + q5;
+        eft::renorm(p0, p1, s0, s1, s2);
+        const double s[4] = {p0, p1, s0, s1};
+        set(s);
+        return special(a[0] * b.x[0]);
+    }
+    mpfr_qd &operator/=(const mpfr_qd &b) { // long division, one double of quotient at a time
+        const double q0 = x[0] / b.x[0];
+        double q[5];
+        mpfr_qd r = *this;
+        for (int i = 0; i < 4; i++) {
+            q[i] = r.x[0] / b.x[0];
+            r -= b * q[i];
+        }
+        q[4] = r.x[0] / b.x[0];
+        eft::renorm(q[0], q[1], q[2], q[3], q[4]);
+        set(q);
+        return special(q0);
+    }
+    mpfr_qd &operator+=(const double b) { return *this += mpfr_qd(b); }
+    mpfr_qd &operator-=(const double b) { return *this += mpfr_qd(-b); }
+    mpfr_qd &operator*=(const double b) { // QD's qd * double
+        double q0, q1, q2;
+        const double p0 = eft::two_prod(x[0], b, q0);
+        double p1 = eft::two_prod(x[1], b, q1);
+        double p2 = eft::two_prod(x[2], b, q2);
+        double p3 = x[3] * b;
+        double s2;
+        double s1 = eft::two_sum(q0, p1, s2);
+        eft::three_sum(s2, q1, p2);
+        eft::three_sum2(q1, q2, p3);
+        double s0 = p0, s3 = q1, s4 = q2 + p2;
+        eft::renorm(s0, s1, s2, s3, s4);
+        const double s[4] = {s0, s1, s2, s3};
+        set(s);
+        return special(p0);
+    }
+    mpfr_qd &operator/=(const double b) {
+        const double q0 = x[0] / b;
+        double q[5];
+        mpfr_qd r = *this;
+        for (int i = 0; i < 4; i++) {
+            q[i] = r.x[0] / b;
+            double e;
+            const double p = eft::two_prod(q[i], b, e);
+            r -= mpfr_qd(p, e, 0.0, 0.0);
+        }
+        q[4] = r.x[0] / b;
+        eft::renorm(q[0], q[1], q[2], q[3], q[4]);
+        set(q);
+        return special(q0);
+    }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_qd &operator+=(const S b) { return *this += mpfr_qd(mpfr_scalar_t<S>(b)); }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_qd &operator-=(const S b) { return *this -= mpfr_qd(mpfr_scalar_t<S>(b)); }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_qd &operator*=(const S b) { return *this *= mpfr_qd(mpfr_scalar_t<S>(b)); }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_qd &operator/=(const S b) { return *this /= mpfr_qd(mpfr_scalar_t<S>(b)); }
+    friend mpfr_qd operator*(mpfr_qd a, const double b) { return a *= b; }
+    friend mpfr_qd sqrt(const mpfr_qd &op) {
+        if (!(op.x[0] > 0.0) || std::isinf(op.x[0]))
+            return mpfr_qd(std::sqrt(op.x[0]));
+        // Newton's iteration for 1 / sqrt(op), each step doubling the bits, then times op
+        mpfr_qd r(1.0 / std::sqrt(op.x[0])), h(op[0] * 0.5, op[1] * 0.5, op[2] * 0.5, op[3] * 0.5);
+        for (int i = 0; i < 3; i++) {
+            mpfr_qd t = r;
+            t *= r;
+            t *= h;
+            t = mpfr_qd(0.5) -= t;
+            t *= r;
+            r += t;
+        }
+        return r *= op;
+    }
+    friend mpfr_qd neg(const mpfr_qd &op) { return mpfr_qd(-op.x[0], -op.x[1], -op.x[2], -op.x[3]); }
+    friend mpfr_qd abs(const mpfr_qd &op) { return op.x[0] < 0.0 ? neg(op) : op; }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.6 Comparison Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    friend bool operator==(const mpfr_qd &a, const mpfr_qd &b) { return a.x[0] == b.x[0] && ((a.x[1] == b.x[1] && a.x[2] == b.x[2] && a.x[3] == b.x[3]) || std::isinf(a.x[0])); }
+    friend bool operator!=(const mpfr_qd &a, const mpfr_qd &b) { return !(a == b) && !a.is_nan() && !b.is_nan(); }
+    friend bool operator<(const mpfr_qd &a, const mpfr_qd &b) {
+        if (a.x[0] != b.x[0] || !std::isfinite(a.x[0]))
+            return a.x[0] < b.x[0];
+        for (int i = 1; i < 3; i++)
+            if (a.x[i] != b.x[i])
+                return a.x[i] < b.x[i];
+        return a.x[3] < b.x[3];
+    }
+    friend bool operator>(const mpfr_qd &a, const mpfr_qd &b) { return b < a; }
+    friend bool operator<=(const mpfr_qd &a, const mpfr_qd &b) { return a < b || a == b; }
+    friend bool operator>=(const mpfr_qd &a, const mpfr_qd &b) { return b < a || a == b; }
+    bool is_nan() const { return std::isnan(x[0]); }
+    bool is_inf() const { return std::isinf(x[0]); }
+
+  private:
+    mpfr_qd(const double x0, const double x1, const double x2, const double x3) noexcept : x{x0, x1, x2, x3} {}
+    // QD's ieee_add: the terms merged by magnitude, accurate when the sum cancels
+    mpfr_qd &ieee_add(const mpfr_qd &b) {
+        const double *a = x;
+        double s[4] = {0.0, 0.0, 0.0, 0.0}, u, v, t;
+        int i = 0, j = 0, k = 0;
+        u = std::abs(a[i]) > std::abs(b.x[j]) ? a[i++] : b.x[j++];
+        v = std::abs(a[i]) > std::abs(b.x[j]) ? a[i++] : b.x[j++];
+        u = eft::fast_two_sum(u, v, v);
+        while (k < 4) {
+            if (i >= 4 && j >= 4) {
+                s[k] = u;
+                if (k < 3)
+                    s[++k] = v;
+                break;
+            }
+            if (i >= 4)
+                t = b.x[j++];
+            else if (j >= 4)
+                t = a[i++];
+            else if (std::abs(a[i]) > std::abs(b.x[j]))
+                t = a[i++];
+            else
+                t = b.x[j++];
+            const double f = eft::three_accum(u, v, t);
+            if (f != 0.0)
+                s[k++] = f;
+        }
+        for (; i < 4; i++)
+            s[3] += a[i];
+        for (; j < 4; j++)
+            s[3] += b.x[j];
+        eft::renorm(s[0], s[1], s[2], s[3]);
+        set(s);
+        return *this;
+    }
+    void set(const double *s) {
+        x[0] = s[0];
+        x[1] = s[1];
+        x[2] = s[2];
+        x[3] = s[3];
+    }
+    mpfr_qd &special(const double x0) { // as mpfr_dd::special
+        if (!std::isfinite(x[0]))
+            set(x0, 0.0, 0.0, 0.0);
+        return *this;
+    }
+    void set(const double x0, const double x1, const double x2, const double x3) {
+        const double s[4] = {x0, x1, x2, x3};
+        set(s);
+    }
+    double x[4];
+};
+
+#ifdef MPFR_WANT_FLOAT128
+////////////////////////////////////////////////////////////////////////////////////////
+// mpfr_float128: _Float128, correctly rounded to nearest by the compiler's soft float
+////////////////////////////////////////////////////////////////////////////////////////
+class mpfr_float128 {
+  public:
+    static constexpr mpfr_prec_t prec = 113;
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.1 Initialization Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_float128() noexcept : value(std::numeric_limits<double>::quiet_NaN()) {} // NaN, as mpfr_class
+    mpfr_prec_t get_prec() const { return prec; }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.2 Assignment Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // every double, long double and 64-bit integer is exact
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const _Float128 op) noexcept : value(op) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const double op) noexcept : value(op) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const float op) noexcept : value(op) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const int op) noexcept : value(op) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const unsigned int op) noexcept : value(op) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const long int op) noexcept : value(op) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const unsigned long int op) noexcept : value(op) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const long double op) noexcept : value(op) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const mpfr_t &op, mpfr_rnd_t rnd = defaults::rnd) noexcept : value(mpfr_get_float128(op, rnd)) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) noexcept : value(mpfr_get_float128(op.get_mpfr_t(), rnd)) {}
+    ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const mpfr_dd &op) noexcept : value(static_cast<_Float128>(op[0]) + op[1]) {} // exact only when lo lies within the 113-bit window of hi; else rounded to nearest
+    mpfr_float128(const char *s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) : mpfr_float128(mpfr_fixed<prec>(s, base, rnd)) {}
+    mpfr_float128(const std::string &s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) : mpfr_float128(mpfr_fixed<prec>(s, base, rnd)) {}
+    template <mpfr_prec_t Bits> ___MPFR_CLASS_EXPLICIT___ mpfr_float128(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) noexcept : value(mpfr_get_float128(op.get_mpfr_t(), rnd)) {}
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.4 Conversion Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    _Float128 get_float128() const { return value; }
+    int get_mpfr(mpfr_ptr rop, mpfr_rnd_t rnd = defaults::rnd) const { return mpfr_set_float128(rop, value, rnd); }
+    ___MPFR_CLASS_EXPLICIT___ operator mpfr_class() const {
+        mpfr_class rop;
+        get_mpfr(rop.get_mpfr_t());
+        return rop;
+    }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.5 Arithmetic Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_float128 &operator+=(const mpfr_float128 &b) {
+        value += b.value;
+        return *this;
+    }
+    mpfr_float128 &operator-=(const mpfr_float128 &b) {
+        value -= b.value;
+        return *this;
+    }
+    mpfr_float128 &operator*=(const mpfr_float128 &b) {
+        value *= b.value;
+        return *this;
+    }
+    mpfr_float128 &operator/=(const mpfr_float128 &b) {
+        value /= b.value;
+        return *this;
+    }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_float128 &operator+=(const S b) {
+        value += mpfr_scalar_t<S>(b);
+        return *this;
+    }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_float128 &operator-=(const S b) {
+        value -= mpfr_scalar_t<S>(b);
+        return *this;
+    }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_float128 &operator*=(const S b) {
+        value *= mpfr_scalar_t<S>(b);
+        return *this;
+    }
+    template <class S, mpfr_backend_enable_if_scalar<S> = 0> mpfr_float128 &operator/=(const S b) {
+        value /= mpfr_scalar_t<S>(b);
+        return *this;
+    }
+    friend mpfr_float128 sqrt(const mpfr_float128 &op) { return mpfr_float128(sqrtf128(op.value)); }
+    friend mpfr_float128 neg(const mpfr_float128 &op) { return mpfr_float128(-op.value); }
+    friend mpfr_float128 abs(const mpfr_float128 &op) { return mpfr_float128(op.value < 0 ? -op.value : op.value); }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.6 Comparison Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    friend bool operator==(const mpfr_float128 &a, const mpfr_float128 &b) { return a.value == b.value; }
+    friend bool operator!=(const mpfr_float128 &a, const mpfr_float128 &b) { return !(a == b) && !a.is_nan() && !b.is_nan(); }
+    friend bool operator<(const mpfr_float128 &a, const mpfr_float128 &b) { return a.value < b.value; }
+    friend bool operator>(const mpfr_float128 &a, const mpfr_float128 &b) { return a.value > b.value; }
+    friend bool operator<=(const mpfr_float128 &a, const mpfr_float128 &b) { return a.value <= b.value; }
+    friend bool operator>=(const mpfr_float128 &a, const mpfr_float128 &b) { return a.value >= b.value; }
+    bool is_nan() const { return value != value; }
+    bool is_inf() const { return !is_nan() && (value - value) != (value - value); }
+
+  private:
+    _Float128 value;
+};
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+// The operators and functions shared by the backends
+////////////////////////////////////////////////////////////////////////////////////////
+template <class T> struct is_mpfr_backend : std::false_type {};
+template <> struct is_mpfr_backend<mpfr_dd> : std::true_type {};
+template <> struct is_mpfr_backend<mpfr_qd> : std::true_type {};
+#ifdef MPFR_WANT_FLOAT128
+template <> struct is_mpfr_backend<mpfr_float128> : std::true_type {};
+#endif
+template <class T> using mpfr_backend_enable_if = typename std::enable_if<is_mpfr_backend<T>::value, int>::type;
+template <class T, class S> using mpfr_backend_enable_if_mixed = typename std::enable_if<is_mpfr_backend<T>::value && std::is_arithmetic<S>::value && is_mpfr_scalar<S>::value, int>::type;
+
+template <class T, mpfr_backend_enable_if<T> = 0> inline T operator+(T a, const T &b) { return a += b; }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T operator-(T a, const T &b) { return a -= b; }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T operator*(T a, const T &b) { return a *= b; }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T operator/(T a, const T &b) { return a /= b; }
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline T operator+(T a, const S b) { return a += b; }
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline T operator-(T a, const S b) { return a -= b; }
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline T operator*(T a, const S b) { return a *= b; }
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline T operator/(T a, const S b) { return a /= b; }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline T operator+(const S a, T b) { return b += a; }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline T operator-(const S a, const T &b) { return T(mpfr_scalar_t<S>(a)) -= b; }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline T operator*(const S a, T b) { return b *= a; }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline T operator/(const S a, const T &b) { return T(mpfr_scalar_t<S>(a)) /= b; }
+
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator==(const T &a, const S b) { return a == T(mpfr_scalar_t<S>(b)); }
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator!=(const T &a, const S b) { return a != T(mpfr_scalar_t<S>(b)); }
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator<(const T &a, const S b) { return a < T(mpfr_scalar_t<S>(b)); }
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator>(const T &a, const S b) { return a > T(mpfr_scalar_t<S>(b)); }
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator<=(const T &a, const S b) { return a <= T(mpfr_scalar_t<S>(b)); }
+template <class T, class S, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator>=(const T &a, const S b) { return a >= T(mpfr_scalar_t<S>(b)); }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator==(const S a, const T &b) { return b == a; }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator!=(const S a, const T &b) { return b != a; }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator<(const S a, const T &b) { return b > a; }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator>(const S a, const T &b) { return b < a; }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator<=(const S a, const T &b) { return b >= a; }
+template <class S, class T, mpfr_backend_enable_if_mixed<T, S> = 0> inline bool operator>=(const S a, const T &b) { return b <= a; }
+
+// the value rounded to the backend's width, printed as mpfr_class prints
+template <class T, mpfr_backend_enable_if<T> = 0> inline std::ostream &operator<<(std::ostream &os, const T &op) {
+    mpfr_fixed<T::prec> m;
+    op.get_mpfr(m.get_mpfr_t(), MPFR_RNDN);
+    return os << m;
+}
+
+// f evaluated by MPFR at the backend's width
+template <class T, class F> inline T mpfr_backend_apply(F f, const T &op, mpfr_rnd_t rnd) {
+    mpfr_fixed<T::prec> a, rop;
+    op.get_mpfr(a.get_mpfr_t(), MPFR_RNDN);
+    f(rop.get_mpfr_t(), a.get_mpfr_t(), rnd);
+    return T(rop, rnd);
+}
+template <class T, class F> inline T mpfr_backend_apply(F f, const T &op1, const T &op2, mpfr_rnd_t rnd) {
+    mpfr_fixed<T::prec> a, b, rop;
+    op1.get_mpfr(a.get_mpfr_t(), MPFR_RNDN);
+    op2.get_mpfr(b.get_mpfr_t(), MPFR_RNDN);
+    f(rop.get_mpfr_t(), a.get_mpfr_t(), b.get_mpfr_t(), rnd);
+    return T(rop, rnd);
+}
+template <class T, mpfr_backend_enable_if<T> = 0> inline T log(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_log, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T log2(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_log2, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T log10(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_log10, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T log1p(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_log1p, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T exp(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_exp, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T exp2(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_exp2, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T exp10(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_exp10, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T expm1(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_expm1, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T sin(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_sin, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T cos(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_cos, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T tan(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_tan, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T asin(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_asin, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T acos(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_acos, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T atan(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_atan, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T sinh(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_sinh, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T cosh(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_cosh, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T tanh(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_tanh, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T asinh(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_asinh, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T acosh(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_acosh, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T atanh(const T &op, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_atanh, op, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T pow(const T &op1, const T &op2, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_pow, op1, op2, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T atan2(const T &y, const T &x, mpfr_rnd_t rnd = defaults::rnd) { return mpfr_backend_apply(mpfr_atan2, y, x, rnd); }
+template <class T, mpfr_backend_enable_if<T> = 0> inline T const_pi(mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<T::prec> rop;
+    mpfr_const_pi(rop.get_mpfr_t(), rnd);
+    return T(rop, rnd);
+}
+template <class T, mpfr_backend_enable_if<T> = 0> inline T const_log2(mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<T::prec> rop;
+    mpfr_const_log2(rop.get_mpfr_t(), rnd);
+    return T(rop, rnd);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Choosing a backend. backend_t<Bits> is the fastest type with at least Bits bits of
+// significand, in the order measured by benchmarks/00_inner_product; with_backend calls
+// f(backend_tag<T>{}) with the same choice for a run-time precision, and above 212 bits
+// runs f on mpfr_class in a precision_scope of that precision.
+////////////////////////////////////////////////////////////////////////////////////////
+template <class T> struct backend_tag {
+    using type = T;
+};
+template <mpfr_prec_t Bits, class = void> struct backend_for {
+    using type = mpfr_fixed<Bits>;
+};
+template <mpfr_prec_t Bits> struct backend_for<Bits, typename std::enable_if<(Bits <= mpfr_dd::prec)>::type> {
+    using type = mpfr_dd;
+};
+#ifdef MPFR_WANT_FLOAT128
+template <mpfr_prec_t Bits> struct backend_for<Bits, typename std::enable_if<(Bits > mpfr_dd::prec && Bits <= mpfr_float128::prec)>::type> {
+    using type = mpfr_float128;
+};
+template <mpfr_prec_t Bits> struct backend_for<Bits, typename std::enable_if<(Bits > mpfr_float128::prec && Bits <= mpfr_qd::prec)>::type> {
+    using type = mpfr_qd;
+};
+#else
+template <mpfr_prec_t Bits> struct backend_for<Bits, typename std::enable_if<(Bits > mpfr_dd::prec && Bits <= mpfr_qd::prec)>::type> {
+    using type = mpfr_qd;
+};
+#endif
+template <mpfr_prec_t Bits> using backend_t = typename backend_for<Bits>::type;
+
+template <class F> inline auto with_backend(const mpfr_prec_t prec, F &&f) -> decltype(f(backend_tag<mpfr_class>{})) {
+    if (prec <= mpfr_dd::prec)
+        return f(backend_tag<mpfr_dd>{});
+#ifdef MPFR_WANT_FLOAT128
+    if (prec <= mpfr_float128::prec)
+        return f(backend_tag<mpfr_float128>{});
+#endif
+    if (prec <= mpfr_qd::prec)
+        return f(backend_tag<mpfr_qd>{});
+    precision_scope scope(prec);
+    return f(backend_tag<mpfr_class>{});
+}
+
+} // namespace mpfr
+
+#endif
@@ -0,0 +1,802 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_BALL_H_
+#define _MPFR_BALL_H_
+
+#include "mpfr_class.h"
+#include "mpfr_fixed.h"
+#include <climits>
+#include <ostream>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// mpfr_ball: midpoint-radius arithmetic. A ball [m +/- r] stands for every real within r of
+// m, and each operation returns a ball holding f(x) for every x in its operands, so one run
+// at one precision tells how many bits of a result are right: correct_bits() reads it off.
+//
+// The midpoint is an mpfr_class at the default precision of the thread, rounded to nearest
+// whatever defaults::rnd says; the radius is a 30-bit mpfr_fixed and everything computed
+// on it rounds up. When MPFR reports the midpoint inexact, half an ulp of it goes into the
+// radius. Sums, products and quotients propagate the radii as Arb does. A function f
+// widens the radius to r * max |f'| over the ball, the bound being worked out at 30 bits
+// with directed rounding, so a function costs one evaluation at the working precision.
+// Where a ball reaches out of a function's domain (log of a ball around 0, a quotient by
+// a ball holding 0) the radius is infinite: the result is valid and says nothing.
+//
+// Comparisons are certain: a < b when every point of a is below every point of b, so
+// for overlapping balls neither a < b nor a >= b holds.
+//
+// Of the functions mpfr_class wraps, these have no ball version yet: tanpi and tanu, the
+// inverse forms asinpi, acospi, atanpi, asinu, acosu and atanu, atan2pi and atan2u, and
+// the special functions beyond erf and erfc (gamma, zeta, Bessel and the rest). The
+// constants and the scalings by powers of 2 take no ball and stay with mpfr_class.
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+
+template <class S> using mpfr_ball_enable_if_operand = typename std::enable_if<(std::is_arithmetic<S>::value && is_mpfr_scalar<S>::value) || std::is_same<S, mpfr_class>::value, int>::type;
+
+class mpfr_ball {
+  public:
+    static constexpr mpfr_prec_t rad_prec = 30;
+    using radius_t = mpfr_fixed<rad_prec>;
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.1 Initialization Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_ball() noexcept { mpfr_set_inf(r.get_mpfr_t(), 1); } // NaN, as mpfr_class, and nothing known about it
+    // the midpoint as it is, with its precision, and the radius rounded up
+    ___MPFR_CLASS_EXPLICIT___ mpfr_ball(const mpfr_class &mid) : m(mid) { mpfr_set_zero(r.get_mpfr_t(), 1); }
+    mpfr_ball(const mpfr_class &mid, const mpfr_class &rad) : m(mid) { mpfr_abs(r.get_mpfr_t(), rad.get_mpfr_t(), MPFR_RNDU); }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.2 Assignment Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // scalars at the default precision, exact unless that is shorter than they are
+    ___MPFR_CLASS_EXPLICIT___ mpfr_ball(const long double op) noexcept { finish(mpfr_set_ld(exact(), op, MPFR_RNDN)); }
+    template <class S, typename std::enable_if<std::is_arithmetic<S>::value && is_mpfr_scalar<S>::value, int>::type = 0> ___MPFR_CLASS_EXPLICIT___ mpfr_ball(const S op) noexcept {
+        finish(set(exact(), mpfr_scalar_t<S>(op)));
+    }
+    mpfr_ball(const char *s, int base = defaults::base) { from_string(s, base, "const char*"); }
+    mpfr_ball(const std::string &s, int base = defaults::base) { from_string(s.c_str(), base, "std::string"); }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.4 Conversion Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    const mpfr_class &mid() const { return m; }
+    const radius_t &rad() const { return r; }
+    // the ends of the ball, rounded outwards at the default precision
+    mpfr_class lower() const {
+        mpfr_class rop;
+        mpfr_sub(rop.get_mpfr_t(), m.get_mpfr_t(), r.get_mpfr_t(), MPFR_RNDD);
+        return rop;
+    }
+    mpfr_class upper() const {
+        mpfr_class rop;
+        mpfr_add(rop.get_mpfr_t(), m.get_mpfr_t(), r.get_mpfr_t(), MPFR_RNDU);
+        return rop;
+    }
+    // how many leading bits of the midpoint are certain to be right: -log2 of the relative
+    // radius, 0 when the ball holds 0 or is not finite, the midpoint's precision when exact
+    long correct_bits() const {
+        if (!mpfr_number_p(m.get_mpfr_t()) || !mpfr_number_p(r.get_mpfr_t()))
+            return 0;
+        const long prec = static_cast<long>(mpfr_get_prec(m.get_mpfr_t()));
+        if (mpfr_zero_p(r.get_mpfr_t()))
+            return prec;
+        if (mpfr_zero_p(m.get_mpfr_t()))
+            return 0;
+        // |m| >= 2^(EXP(m) - 1) and r < 2^EXP(r)
+        const mpfr_exp_t bits = mpfr_get_exp(m.get_mpfr_t()) - 1 - mpfr_get_exp(r.get_mpfr_t());
+        return bits <= 0 ? 0 : (bits >= prec ? prec : static_cast<long>(bits));
+    }
+    bool is_exact() const { return mpfr_zero_p(r.get_mpfr_t()) != 0; }
+    bool is_finite() const { return mpfr_number_p(m.get_mpfr_t()) && mpfr_number_p(r.get_mpfr_t()); }
+    // x is certainly in the ball
+    bool contains(const mpfr_class &x) const {
+        radius_t d;
+        mpfr_sub(d.get_mpfr_t(), x.get_mpfr_t(), m.get_mpfr_t(), MPFR_RNDA);
+        return mpfr_cmpabs(d.get_mpfr_t(), r.get_mpfr_t()) <= 0 && !mpfr_nan_p(d.get_mpfr_t());
+    }
+    // b is certainly inside the ball
+    bool contains(const mpfr_ball &b) const {
+        radius_t d;
+        mpfr_sub(d.get_mpfr_t(), b.m.get_mpfr_t(), m.get_mpfr_t(), MPFR_RNDA);
+        mpfr_abs(d.get_mpfr_t(), d.get_mpfr_t(), MPFR_RNDU);
+        mpfr_add(d.get_mpfr_t(), d.get_mpfr_t(), b.r.get_mpfr_t(), MPFR_RNDU);
+        return mpfr_lessequal_p(d.get_mpfr_t(), r.get_mpfr_t()) != 0;
+    }
+    // the balls may share a point
+    bool overlaps(const mpfr_ball &b) const { return !(*this < b) && !(b < *this); }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.5 Arithmetic Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // the compound forms keep the precision of the midpoint, as mpfr_class does
+    mpfr_ball &operator+=(const mpfr_ball &b) {
+        add(*this, *this, b, false);
+        return *this;
+    }
+    mpfr_ball &operator-=(const mpfr_ball &b) {
+        add(*this, *this, b, true);
+        return *this;
+    }
+    mpfr_ball &operator*=(const mpfr_ball &b) {
+        mul(*this, *this, b);
+        return *this;
+    }
+    mpfr_ball &operator/=(const mpfr_ball &b) {
+        div(*this, *this, b);
+        return *this;
+    }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> mpfr_ball &operator+=(const S &b) { return *this += mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> mpfr_ball &operator-=(const S &b) { return *this -= mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> mpfr_ball &operator*=(const S &b) { return *this *= mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> mpfr_ball &operator/=(const S &b) { return *this /= mpfr_ball(b); }
+    friend mpfr_ball operator+(const mpfr_ball &a, const mpfr_ball &b) {
+        mpfr_ball rop;
+        add(rop, a, b, false);
+        return rop;
+    }
+    friend mpfr_ball operator-(const mpfr_ball &a, const mpfr_ball &b) {
+        mpfr_ball rop;
+        add(rop, a, b, true);
+        return rop;
+    }
+    friend mpfr_ball operator*(const mpfr_ball &a, const mpfr_ball &b) {
+        mpfr_ball rop;
+        mul(rop, a, b);
+        return rop;
+    }
+    friend mpfr_ball operator/(const mpfr_ball &a, const mpfr_ball &b) {
+        mpfr_ball rop;
+        div(rop, a, b);
+        return rop;
+    }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend mpfr_ball operator+(const mpfr_ball &a, const S &b) { return a + mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend mpfr_ball operator-(const mpfr_ball &a, const S &b) { return a - mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend mpfr_ball operator*(const mpfr_ball &a, const S &b) { return a * mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend mpfr_ball operator/(const mpfr_ball &a, const S &b) { return a / mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend mpfr_ball operator+(const S &a, const mpfr_ball &b) { return mpfr_ball(a) + b; }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend mpfr_ball operator-(const S &a, const mpfr_ball &b) { return mpfr_ball(a) - b; }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend mpfr_ball operator*(const S &a, const mpfr_ball &b) { return mpfr_ball(a) * b; }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend mpfr_ball operator/(const S &a, const mpfr_ball &b) { return mpfr_ball(a) / b; }
+    friend mpfr_ball neg(const mpfr_ball &op) {
+        mpfr_ball rop(op);
+        mpfr_neg(rop.m.get_mpfr_t(), rop.m.get_mpfr_t(), MPFR_RNDN);
+        return rop;
+    }
+    friend mpfr_ball abs(const mpfr_ball &op) {
+        mpfr_ball rop(op);
+        mpfr_abs(rop.m.get_mpfr_t(), rop.m.get_mpfr_t(), MPFR_RNDN);
+        return rop;
+    }
+    friend mpfr_ball sqrt(const mpfr_ball &op) {
+        return apply(op, mpfr_sqrt, [&op](mpfr_ptr d) { // 1 / (2 sqrt(lo))
+            op.low(d);
+            if (mpfr_sgn(d) <= 0)
+                return false;
+            mpfr_sqrt(d, d, MPFR_RNDD);
+            mpfr_mul_2ui(d, d, 1, MPFR_RNDD);
+            mpfr_ui_div(d, 1, d, MPFR_RNDU);
+            return true;
+        });
+    }
+    // x^k, x of any sign
+    friend mpfr_ball pow_si(const mpfr_ball &op, const long k) {
+        const unsigned long n = k < 0 ? 0 - static_cast<unsigned long>(k) : static_cast<unsigned long>(k);
+        return apply(op, [k](mpfr_ptr rop, mpfr_srcptr x, mpfr_rnd_t rnd) { return mpfr_pow_si(rop, x, k, rnd); }, [&op, k, n](mpfr_ptr d) { return op.power_bound(d, k < 0, n); });
+    }
+    friend mpfr_ball pow_ui(const mpfr_ball &op, const unsigned long k) {
+        return apply(op, [k](mpfr_ptr rop, mpfr_srcptr x, mpfr_rnd_t rnd) { return mpfr_pow_ui(rop, x, k, rnd); }, [&op, k](mpfr_ptr d) { return op.power_bound(d, false, k); });
+    }
+#ifdef _MPFR_H_HAVE_INTMAX_T
+    friend mpfr_ball pown(const mpfr_ball &op, const intmax_t k) {
+        const uintmax_t n = k < 0 ? 0 - static_cast<uintmax_t>(k) : static_cast<uintmax_t>(k);
+        if (n > ULONG_MAX) { // beyond the exponents of a long, through mpz
+            mpz_t z;
+            mpz_init(z);
+            mpz_import(z, 1, 1, sizeof(n), 0, 0, &n);
+            if (k < 0)
+                mpz_neg(z, z);
+            mpfr_ball rop = pow_z(op, z);
+            mpz_clear(z);
+            return rop;
+        }
+        return apply(op, [k](mpfr_ptr rop, mpfr_srcptr x, mpfr_rnd_t rnd) { return mpfr_pown(rop, x, k, rnd); }, [&op, k, n](mpfr_ptr d) { return op.power_bound(d, k < 0, static_cast<unsigned long>(n)); });
+    }
+    friend mpfr_ball pow_sj(const mpfr_ball &op, const intmax_t k) { return pown(op, k); }
+    friend mpfr_ball pow_uj(const mpfr_ball &op, const uintmax_t k) {
+        if (k > ULONG_MAX) {
+            mpz_t z;
+            mpz_init(z);
+            mpz_import(z, 1, 1, sizeof(k), 0, 0, &k);
+            mpfr_ball rop = pow_z(op, z);
+            mpz_clear(z);
+            return rop;
+        }
+        return pow_ui(op, static_cast<unsigned long>(k));
+    }
+#endif
+    friend mpfr_ball pow_z(const mpfr_ball &op, const mpz_t k) {
+        return apply(op, [k](mpfr_ptr rop, mpfr_srcptr x, mpfr_rnd_t rnd) { return mpfr_pow_z(rop, x, k, rnd); }, [&op, k](mpfr_ptr d) { return op.power_bound(d, k); });
+    }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.6 Comparison Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    friend bool operator<(const mpfr_ball &a, const mpfr_ball &b) { return b.gap(a) > 0; }
+    friend bool operator>(const mpfr_ball &a, const mpfr_ball &b) { return a.gap(b) > 0; }
+    friend bool operator<=(const mpfr_ball &a, const mpfr_ball &b) { return b.gap(a) >= 0; }
+    friend bool operator>=(const mpfr_ball &a, const mpfr_ball &b) { return a.gap(b) >= 0; }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend bool operator<(const mpfr_ball &a, const S &b) { return a < mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend bool operator>(const mpfr_ball &a, const S &b) { return a > mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend bool operator<=(const mpfr_ball &a, const S &b) { return a <= mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend bool operator>=(const mpfr_ball &a, const S &b) { return a >= mpfr_ball(b); }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend bool operator<(const S &a, const mpfr_ball &b) { return mpfr_ball(a) < b; }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend bool operator>(const S &a, const mpfr_ball &b) { return mpfr_ball(a) > b; }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend bool operator<=(const S &a, const mpfr_ball &b) { return mpfr_ball(a) <= b; }
+    template <class S, mpfr_ball_enable_if_operand<S> = 0> friend bool operator>=(const S &a, const mpfr_ball &b) { return mpfr_ball(a) >= b; }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.7 Transcendental Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    friend mpfr_ball log(const mpfr_ball &op) {
+        return apply(op, mpfr_log, [&op](mpfr_ptr d) { return op.reciprocal_of_low(d, nullptr); });
+    }
+    friend mpfr_ball log2(const mpfr_ball &op) {
+        return apply(op, mpfr_log2, [&op](mpfr_ptr d) { return op.reciprocal_of_low(d, [](mpfr_ptr t) { mpfr_const_log2(t, MPFR_RNDD); }); });
+    }
+    friend mpfr_ball log10(const mpfr_ball &op) {
+        return apply(op, mpfr_log10, [&op](mpfr_ptr d) { return op.reciprocal_of_low(d, [](mpfr_ptr t) { mpfr_log_ui(t, 10, MPFR_RNDD); }); });
+    }
+    friend mpfr_ball log1p(const mpfr_ball &op) {
+        return apply(op, mpfr_log1p, [&op](mpfr_ptr d) { return op.reciprocal_of_low_plus_one(d, nullptr); });
+    }
+    friend mpfr_ball log2p1(const mpfr_ball &op) {
+        return apply(op, mpfr_log2p1, [&op](mpfr_ptr d) { return op.reciprocal_of_low_plus_one(d, [](mpfr_ptr t) { mpfr_const_log2(t, MPFR_RNDD); }); });
+    }
+    friend mpfr_ball log10p1(const mpfr_ball &op) {
+        return apply(op, mpfr_log10p1, [&op](mpfr_ptr d) { return op.reciprocal_of_low_plus_one(d, [](mpfr_ptr t) { mpfr_log_ui(t, 10, MPFR_RNDD); }); });
+    }
+    friend mpfr_ball exp(const mpfr_ball &op) {
+        return apply(op, mpfr_exp, [&op](mpfr_ptr d) { return op.at_high(d, mpfr_exp, nullptr); });
+    }
+    friend mpfr_ball exp2(const mpfr_ball &op) {
+        return apply(op, mpfr_exp2, [&op](mpfr_ptr d) { return op.at_high(d, mpfr_exp2, [](mpfr_ptr t) { mpfr_const_log2(t, MPFR_RNDU); }); });
+    }
+    friend mpfr_ball exp10(const mpfr_ball &op) {
+        return apply(op, mpfr_exp10, [&op](mpfr_ptr d) { return op.at_high(d, mpfr_exp10, [](mpfr_ptr t) { mpfr_log_ui(t, 10, MPFR_RNDU); }); });
+    }
+    friend mpfr_ball expm1(const mpfr_ball &op) {
+        return apply(op, mpfr_expm1, [&op](mpfr_ptr d) { return op.at_high(d, mpfr_exp, nullptr); });
+    }
+    friend mpfr_ball exp2m1(const mpfr_ball &op) {
+        return apply(op, mpfr_exp2m1, [&op](mpfr_ptr d) { return op.at_high(d, mpfr_exp2, [](mpfr_ptr t) { mpfr_const_log2(t, MPFR_RNDU); }); });
+    }
+    friend mpfr_ball exp10m1(const mpfr_ball &op) {
+        return apply(op, mpfr_exp10m1, [&op](mpfr_ptr d) { return op.at_high(d, mpfr_exp10, [](mpfr_ptr t) { mpfr_log_ui(t, 10, MPFR_RNDU); }); });
+    }
+    friend mpfr_ball pow(const mpfr_ball &x, const mpfr_ball &y) {
+        mpfr_ball rop;
+        radius_t rad;
+        if (x.is_exact() && y.is_exact()) {
+            mpfr_set_zero(rad.get_mpfr_t(), 1);
+        } else if (!x.pow_radius(y, rad.get_mpfr_t())) {
+            mpfr_set_inf(rad.get_mpfr_t(), 1);
+        }
+        rop.r = rad;
+        rop.finish(mpfr_pow(rop.m.get_mpfr_t(), x.m.get_mpfr_t(), y.m.get_mpfr_t(), MPFR_RNDN));
+        return rop;
+    }
+    // exp(y log x), which has the radius of pow where it is defined, x > 0
+    friend mpfr_ball powr(const mpfr_ball &x, const mpfr_ball &y) {
+        mpfr_ball rop;
+        radius_t rad;
+        if (x.is_exact() && y.is_exact()) {
+            mpfr_set_zero(rad.get_mpfr_t(), 1);
+        } else if (!x.pow_radius(y, rad.get_mpfr_t())) {
+            mpfr_set_inf(rad.get_mpfr_t(), 1);
+        }
+        rop.r = rad;
+        rop.finish(mpfr_powr(rop.m.get_mpfr_t(), x.m.get_mpfr_t(), y.m.get_mpfr_t(), MPFR_RNDN));
+        return rop;
+    }
+    // a^x: a^hi log a
+    friend mpfr_ball ui_pow(const unsigned long a, const mpfr_ball &op) {
+        const auto f = [a](mpfr_ptr rop, mpfr_srcptr x, mpfr_rnd_t rnd) { return mpfr_ui_pow(rop, a, x, rnd); };
+        return apply(op, f, [&op, a, f](mpfr_ptr d) {
+            if (a == 0) // 0^x jumps at x = 0
+                return false;
+            return op.at_high(d, f, [a](mpfr_ptr t) { mpfr_log_ui(t, a, MPFR_RNDU); });
+        });
+    }
+    friend mpfr_ball sin(const mpfr_ball &op) { return apply(op, mpfr_sin, one); }
+    friend mpfr_ball cos(const mpfr_ball &op) { return apply(op, mpfr_cos, one); }
+    friend mpfr_ball tan(const mpfr_ball &op) {
+        return apply(op, mpfr_tan, [&op](mpfr_ptr d) { return op.inverse_square_of(d, mpfr_cos); });
+    }
+    // |sec'| = |sin| / cos^2 and |csc'| = |cos| / sin^2, at most 1 / cos^2 and 1 / sin^2
+    friend mpfr_ball sec(const mpfr_ball &op) {
+        return apply(op, mpfr_sec, [&op](mpfr_ptr d) { return op.inverse_square_of(d, mpfr_cos); });
+    }
+    friend mpfr_ball csc(const mpfr_ball &op) {
+        return apply(op, mpfr_csc, [&op](mpfr_ptr d) { return op.inverse_square_of(d, mpfr_sin); });
+    }
+    friend mpfr_ball cot(const mpfr_ball &op) {
+        return apply(op, mpfr_cot, [&op](mpfr_ptr d) { return op.inverse_square_of(d, mpfr_sin); });
+    }
+    // sin(pi x) and cos(pi x): pi; sin(2 pi x / u) and cos(2 pi x / u): 2 pi / u
+    friend mpfr_ball sinpi(const mpfr_ball &op) {
+        return apply(op, mpfr_sinpi, [](mpfr_ptr d) { return period_scale(d, 2); });
+    }
+    friend mpfr_ball cospi(const mpfr_ball &op) {
+        return apply(op, mpfr_cospi, [](mpfr_ptr d) { return period_scale(d, 2); });
+    }
+    friend mpfr_ball sinu(const mpfr_ball &op, const unsigned long u) {
+        return apply(op, [u](mpfr_ptr rop, mpfr_srcptr x, mpfr_rnd_t rnd) { return mpfr_sinu(rop, x, u, rnd); }, [u](mpfr_ptr d) { return period_scale(d, u); });
+    }
+    friend mpfr_ball cosu(const mpfr_ball &op, const unsigned long u) {
+        return apply(op, [u](mpfr_ptr rop, mpfr_srcptr x, mpfr_rnd_t rnd) { return mpfr_cosu(rop, x, u, rnd); }, [u](mpfr_ptr d) { return period_scale(d, u); });
+    }
+    friend mpfr_ball asin(const mpfr_ball &op) {
+        return apply(op, mpfr_asin, [&op](mpfr_ptr d) { return op.inverse_sqrt_of(d, -1); });
+    }
+    friend mpfr_ball acos(const mpfr_ball &op) {
+        return apply(op, mpfr_acos, [&op](mpfr_ptr d) { return op.inverse_sqrt_of(d, -1); });
+    }
+    friend mpfr_ball atan2(const mpfr_ball &y, const mpfr_ball &x) {
+        mpfr_ball rop;
+        radius_t rad;
+        if (x.is_exact() && y.is_exact()) {
+            mpfr_set_zero(rad.get_mpfr_t(), 1);
+        } else if (!x.atan2_radius(y, rad.get_mpfr_t())) {
+            mpfr_set_inf(rad.get_mpfr_t(), 1);
+        }
+        rop.r = rad;
+        rop.finish(mpfr_atan2(rop.m.get_mpfr_t(), y.m.get_mpfr_t(), x.m.get_mpfr_t(), MPFR_RNDN));
+        return rop;
+    }
+    friend mpfr_ball agm(const mpfr_ball &x, const mpfr_ball &y) {
+        mpfr_ball rop;
+        radius_t rad;
+        if (x.is_exact() && y.is_exact()) {
+            mpfr_set_zero(rad.get_mpfr_t(), 1);
+        } else if (!x.agm_radius(y, rad.get_mpfr_t())) {
+            mpfr_set_inf(rad.get_mpfr_t(), 1);
+        }
+        rop.r = rad;
+        rop.finish(mpfr_agm(rop.m.get_mpfr_t(), x.m.get_mpfr_t(), y.m.get_mpfr_t(), MPFR_RNDN));
+        return rop;
+    }
+    friend mpfr_ball sinh(const mpfr_ball &op) {
+        return apply(op, mpfr_sinh, [&op](mpfr_ptr d) { // cosh max|x|
+            op.max_abs(d);
+            mpfr_cosh(d, d, MPFR_RNDU);
+            return true;
+        });
+    }
+    friend mpfr_ball cosh(const mpfr_ball &op) {
+        return apply(op, mpfr_cosh, [&op](mpfr_ptr d) { // sinh max|x|
+            op.max_abs(d);
+            mpfr_sinh(d, d, MPFR_RNDU);
+            return true;
+        });
+    }
+    friend mpfr_ball tanh(const mpfr_ball &op) {
+        return apply(op, mpfr_tanh, [&op](mpfr_ptr d) { // 1 / cosh^2 min|x|
+            op.min_abs(d);
+            mpfr_cosh(d, d, MPFR_RNDD);
+            mpfr_sqr(d, d, MPFR_RNDD);
+            mpfr_ui_div(d, 1, d, MPFR_RNDU);
+            return true;
+        });
+    }
+    friend mpfr_ball sech(const mpfr_ball &op) { return apply(op, mpfr_sech, one); } // sech |tanh| < 1
+    friend mpfr_ball csch(const mpfr_ball &op) {
+        return apply(op, mpfr_csch, [&op](mpfr_ptr d) { // cosh / sinh^2 min|x|, for a ball clear of 0
+            radius_t c;
+            op.min_abs(d);
+            if (mpfr_zero_p(d))
+                return false;
+            mpfr_cosh(c.get_mpfr_t(), d, MPFR_RNDU);
+            mpfr_sinh(d, d, MPFR_RNDD);
+            mpfr_sqr(d, d, MPFR_RNDD);
+            mpfr_div(d, c.get_mpfr_t(), d, MPFR_RNDU);
+            return true;
+        });
+    }
+    friend mpfr_ball coth(const mpfr_ball &op) {
+        return apply(op, mpfr_coth, [&op](mpfr_ptr d) { // 1 / sinh^2 min|x|, for a ball clear of 0
+            op.min_abs(d);
+            if (mpfr_zero_p(d))
+                return false;
+            mpfr_sinh(d, d, MPFR_RNDD);
+            mpfr_sqr(d, d, MPFR_RNDD);
+            mpfr_ui_div(d, 1, d, MPFR_RNDU);
+            return true;
+        });
+    }
+    friend mpfr_ball asinh(const mpfr_ball &op) {
+        return apply(op, mpfr_asinh, [&op](mpfr_ptr d) { return op.inverse_sqrt_of(d, 1); });
+    }
+    friend mpfr_ball acosh(const mpfr_ball &op) {
+        return apply(op, mpfr_acosh, [&op](mpfr_ptr d) { // 1 / sqrt(lo^2 - 1)
+            op.low(d);
+            if (mpfr_cmp_ui(d, 1) <= 0)
+                return false;
+            mpfr_sqr(d, d, MPFR_RNDD);
+            mpfr_sub_ui(d, d, 1, MPFR_RNDD);
+            if (mpfr_sgn(d) <= 0)
+                return false;
+            mpfr_rec_sqrt(d, d, MPFR_RNDU);
+            return true;
+        });
+    }
+    friend mpfr_ball atanh(const mpfr_ball &op) {
+        return apply(op, mpfr_atanh, [&op](mpfr_ptr d) { // 1 / (1 - max|x|^2)
+            op.max_abs(d);
+            mpfr_sqr(d, d, MPFR_RNDU);
+            mpfr_ui_sub(d, 1, d, MPFR_RNDD);
+            if (mpfr_sgn(d) <= 0)
+                return false;
+            mpfr_ui_div(d, 1, d, MPFR_RNDU);
+            return true;
+        });
+    }
+    friend mpfr_ball erf(const mpfr_ball &op) {
+        return apply(op, mpfr_erf, [&op](mpfr_ptr d) { return op.gaussian(d); });
+    }
+    friend mpfr_ball erfc(const mpfr_ball &op) {
+        return apply(op, mpfr_erfc, [&op](mpfr_ptr d) { return op.gaussian(d); });
+    }
+    friend std::ostream &operator<<(std::ostream &os, const mpfr_ball &b) {
+        os << '[';
+        mpfr_write(os, b.m.get_mpfr_t());
+        if (b.is_exact())
+            return os << ']';
+        char rad[32]; // rounded up, so still a radius of the ball
+        mpfr_snprintf(rad, sizeof(rad), "%.3RUe", b.r.get_mpfr_t());
+        return os << " +/- " << rad << ']';
+    }
+
+  private:
+    mpfr_class m;
+    radius_t r;
+
+    static int set(mpfr_ptr rop, const double op) { return mpfr_set_d(rop, op, MPFR_RNDN); }
+    static int set(mpfr_ptr rop, const long op) { return mpfr_set_si(rop, op, MPFR_RNDN); }
+    static int set(mpfr_ptr rop, const unsigned long op) { return mpfr_set_ui(rop, op, MPFR_RNDN); }
+    void from_string(const char *s, int base, const char *what) {
+        char *end;
+        const int inex = mpfr_strtofr(exact(), s, &end, base, MPFR_RNDN);
+        if (end == s || *end != '\0') {
+            std::cerr << "Error initializing mpfr_ball from " << what << ": " << s << std::endl;
+            throw std::runtime_error("Failed to initialize mpfr_ball with given string.");
+        }
+        finish(inex);
+    }
+    // a zero radius, and the midpoint to be set
+    mpfr_ptr exact() {
+        mpfr_set_zero(r.get_mpfr_t(), 1);
+        return m.get_mpfr_t();
+    }
+    // adds the rounding error of the midpoint to the radius, from the ternary value of MPFR
+    void finish(const int inexact) {
+        if (!mpfr_number_p(m.get_mpfr_t()) || mpfr_nan_p(r.get_mpfr_t())) {
+            mpfr_set_inf(r.get_mpfr_t(), 1);
+        } else if (inexact != 0 && !mpfr_zero_p(m.get_mpfr_t())) {
+            radius_t half_ulp;
+            mpfr_set_ui_2exp(half_ulp.get_mpfr_t(), 1, mpfr_get_exp(m.get_mpfr_t()) - static_cast<mpfr_exp_t>(mpfr_get_prec(m.get_mpfr_t())) - 1, MPFR_RNDU);
+            mpfr_add(r.get_mpfr_t(), r.get_mpfr_t(), half_ulp.get_mpfr_t(), MPFR_RNDU);
+        } else if (inexact != 0) { // underflow to zero: the smallest number bounds what was lost
+            radius_t tiny;
+            mpfr_set_ui_2exp(tiny.get_mpfr_t(), 1, mpfr_get_emin(), MPFR_RNDU);
+            mpfr_add(r.get_mpfr_t(), r.get_mpfr_t(), tiny.get_mpfr_t(), MPFR_RNDU);
+        }
+    }
+
+    // rop = a +- b; the radius goes first, rop may be a or b
+    static void add(mpfr_ball &rop, const mpfr_ball &a, const mpfr_ball &b, const bool subtract) {
+        radius_t rad;
+        mpfr_add(rad.get_mpfr_t(), a.r.get_mpfr_t(), b.r.get_mpfr_t(), MPFR_RNDU);
+        rop.r = rad;
+        const int inex = subtract ? mpfr_sub(rop.m.get_mpfr_t(), a.m.get_mpfr_t(), b.m.get_mpfr_t(), MPFR_RNDN) : mpfr_add(rop.m.get_mpfr_t(), a.m.get_mpfr_t(), b.m.get_mpfr_t(), MPFR_RNDN);
+        rop.finish(inex);
+    }
+    // |a.m| b.r + a.r (|b.m| + b.r)
+    static void mul(mpfr_ball &rop, const mpfr_ball &a, const mpfr_ball &b) {
+        radius_t rad, t;
+        mpfr_abs(rad.get_mpfr_t(), a.m.get_mpfr_t(), MPFR_RNDU);
+        mpfr_mul(rad.get_mpfr_t(), rad.get_mpfr_t(), b.r.get_mpfr_t(), MPFR_RNDU);
+        mpfr_abs(t.get_mpfr_t(), b.m.get_mpfr_t(), MPFR_RNDU);
+        mpfr_add(t.get_mpfr_t(), t.get_mpfr_t(), b.r.get_mpfr_t(), MPFR_RNDU);
+        mpfr_mul(t.get_mpfr_t(), t.get_mpfr_t(), a.r.get_mpfr_t(), MPFR_RNDU);
+        mpfr_add(rad.get_mpfr_t(), rad.get_mpfr_t(), t.get_mpfr_t(), MPFR_RNDU);
+        rop.r = rad;
+        rop.finish(mpfr_mul(rop.m.get_mpfr_t(), a.m.get_mpfr_t(), b.m.get_mpfr_t(), MPFR_RNDN));
+    }
+    // (|a.m| b.r + |b.m| a.r) / (|b.m| (|b.m| - b.r)), when b keeps away from 0
+    static void div(mpfr_ball &rop, const mpfr_ball &a, const mpfr_ball &b) {
+        radius_t rad, t, low;
+        if (a.is_exact() && b.is_exact()) {
+            mpfr_set_zero(rad.get_mpfr_t(), 1);
+        } else {
+            b.min_abs(low.get_mpfr_t());
+            if (mpfr_zero_p(low.get_mpfr_t())) {
+                mpfr_set_inf(rad.get_mpfr_t(), 1);
+            } else {
+                mpfr_abs(rad.get_mpfr_t(), a.m.get_mpfr_t(), MPFR_RNDU);
+                mpfr_mul(rad.get_mpfr_t(), rad.get_mpfr_t(), b.r.get_mpfr_t(), MPFR_RNDU);
+                mpfr_abs(t.get_mpfr_t(), b.m.get_mpfr_t(), MPFR_RNDU);
+                mpfr_mul(t.get_mpfr_t(), t.get_mpfr_t(), a.r.get_mpfr_t(), MPFR_RNDU);
+                mpfr_add(rad.get_mpfr_t(), rad.get_mpfr_t(), t.get_mpfr_t(), MPFR_RNDU);
+                mpfr_abs(t.get_mpfr_t(), b.m.get_mpfr_t(), MPFR_RNDD);
+                mpfr_mul(t.get_mpfr_t(), t.get_mpfr_t(), low.get_mpfr_t(), MPFR_RNDD);
+                mpfr_div(rad.get_mpfr_t(), rad.get_mpfr_t(), t.get_mpfr_t(), MPFR_RNDU);
+            }
+        }
+        rop.r = rad;
+        rop.finish(mpfr_div(rop.m.get_mpfr_t(), a.m.get_mpfr_t(), b.m.get_mpfr_t(), MPFR_RNDN));
+    }
+    // f at the midpoint, and the radius times d, bound(d) setting d >= |f'| over the ball or
+    // returning false where it has none
+    template <class F, class B> static mpfr_ball apply(const mpfr_ball &op, F f, B bound) {
+        mpfr_ball rop;
+        radius_t d;
+        if (op.is_exact())
+            mpfr_set_zero(rop.r.get_mpfr_t(), 1);
+        else if (op.is_finite() && bound(d.get_mpfr_t()))
+            mpfr_mul(rop.r.get_mpfr_t(), op.r.get_mpfr_t(), d.get_mpfr_t(), MPFR_RNDU);
+        rop.finish(f(rop.m.get_mpfr_t(), op.m.get_mpfr_t(), MPFR_RNDN));
+        return rop;
+    }
+    static bool one(mpfr_ptr d) {
+        mpfr_set_ui(d, 1, MPFR_RNDU);
+        return true;
+    }
+
+    // the bounds of the ball and of its magnitude at 30 bits, rounded outwards
+    void low(mpfr_ptr rop) const { mpfr_sub(rop, m.get_mpfr_t(), r.get_mpfr_t(), MPFR_RNDD); }
+    void high(mpfr_ptr rop) const { mpfr_add(rop, m.get_mpfr_t(), r.get_mpfr_t(), MPFR_RNDU); }
+    void max_abs(mpfr_ptr rop) const {
+        mpfr_abs(rop, m.get_mpfr_t(), MPFR_RNDU);
+        mpfr_add(rop, rop, r.get_mpfr_t(), MPFR_RNDU);
+    }
+    void min_abs(mpfr_ptr rop) const {
+        mpfr_abs(rop, m.get_mpfr_t(), MPFR_RNDD);
+        mpfr_sub(rop, rop, r.get_mpfr_t(), MPFR_RNDD);
+        if (mpfr_sgn(rop) < 0)
+            mpfr_set_zero(rop, 1);
+    }
+    // the derivatives of the functions above, each an upper bound over the ball
+    template <class C> bool reciprocal_of_low(mpfr_ptr d, C scale) const { // 1 / (lo c), c rounded down
+        low(d);
+        if (mpfr_sgn(d) <= 0)
+            return false;
+        scale_by(d, scale, MPFR_RNDD);
+        mpfr_ui_div(d, 1, d, MPFR_RNDU);
+        return true;
+    }
+    template <class C> bool reciprocal_of_low_plus_one(mpfr_ptr d, C scale) const { // 1 / ((1 + lo) c), c rounded down
+        low(d);
+        mpfr_add_ui(d, d, 1, MPFR_RNDD);
+        if (mpfr_sgn(d) <= 0)
+            return false;
+        scale_by(d, scale, MPFR_RNDD);
+        mpfr_ui_div(d, 1, d, MPFR_RNDU);
+        return true;
+    }
+    template <class F, class C> bool at_high(mpfr_ptr d, F f, C scale) const { // f(hi) c, c rounded up
+        high(d);
+        f(d, d, MPFR_RNDU);
+        scale_by(d, scale, MPFR_RNDU);
+        return true;
+    }
+    template <class C> static void scale_by(mpfr_ptr d, C scale, mpfr_rnd_t rnd) {
+        radius_t c;
+        scale(c.get_mpfr_t());
+        mpfr_mul(d, d, c.get_mpfr_t(), rnd);
+    }
+    static void scale_by(mpfr_ptr, std::nullptr_t, mpfr_rnd_t) {}
+    bool inverse_sqrt_of(mpfr_ptr d, const int sign) const { // 1 / sqrt(1 + sign x^2), the largest x^2 for -1, the smallest for 1
+        if (sign < 0) {
+            max_abs(d);
+            mpfr_sqr(d, d, MPFR_RNDU);
+            mpfr_ui_sub(d, 1, d, MPFR_RNDD);
+        } else {
+            min_abs(d);
+            mpfr_sqr(d, d, MPFR_RNDD);
+            mpfr_add_ui(d, d, 1, MPFR_RNDD);
+        }
+        if (mpfr_sgn(d) <= 0)
+            return false;
+        mpfr_rec_sqrt(d, d, MPFR_RNDU);
+        return true;
+    }
+    bool power_bound(mpfr_ptr d, const bool negative, const unsigned long k) const { // k max|x|^(k - 1), or k / min|x|^(k + 1) for x^-k
+        if (k == 0) {
+            mpfr_set_zero(d, 1);
+        } else if (!negative) {
+            max_abs(d);
+            mpfr_pow_ui(d, d, k - 1, MPFR_RNDU);
+            mpfr_mul_ui(d, d, k, MPFR_RNDU);
+        } else {
+            radius_t m;
+            min_abs(m.get_mpfr_t());
+            if (mpfr_zero_p(m.get_mpfr_t()))
+                return false;
+            mpfr_pow_ui(d, m.get_mpfr_t(), k, MPFR_RNDD);
+            mpfr_mul(d, d, m.get_mpfr_t(), MPFR_RNDD);
+            mpfr_ui_div(d, k, d, MPFR_RNDU);
+        }
+        return true;
+    }
+    bool power_bound(mpfr_ptr d, mpz_srcptr k) const { // the same, for an mpz exponent
+        if (mpz_fits_slong_p(k)) {
+            const long n = mpz_get_si(k);
+            return power_bound(d, n < 0, n < 0 ? 0 - static_cast<unsigned long>(n) : static_cast<unsigned long>(n));
+        }
+        radius_t m;
+        mpz_t e;
+        mpz_init(e);
+        mpz_abs(e, k);
+        bool bounded = true;
+        if (mpz_sgn(k) > 0) {
+            max_abs(m.get_mpfr_t());
+            mpz_sub_ui(e, e, 1);
+            mpfr_pow_z(d, m.get_mpfr_t(), e, MPFR_RNDU);
+            mpfr_mul_z(d, d, k, MPFR_RNDU);
+        } else {
+            min_abs(m.get_mpfr_t());
+            if (mpfr_zero_p(m.get_mpfr_t())) {
+                bounded = false;
+            } else {
+                mpz_add_ui(e, e, 1);
+                mpfr_pow_z(d, m.get_mpfr_t(), e, MPFR_RNDD);
+                mpz_sub_ui(e, e, 1);
+                mpfr_div_z(d, d, e, MPFR_RNDD);
+                mpfr_ui_div(d, 1, d, MPFR_RNDU);
+            }
+        }
+        mpz_clear(e);
+        return bounded;
+    }
+    template <class F> bool inverse_square_of(mpfr_ptr d, F f) const { // 1 / min f^2, f = sin or cos taken at 30 bits: its error and r bound the change
+        f(d, m.get_mpfr_t(), MPFR_RNDN);
+        mpfr_abs(d, d, MPFR_RNDD);
+        mpfr_sub(d, d, r.get_mpfr_t(), MPFR_RNDD);
+        mpfr_sub_d(d, d, 0x1p-30, MPFR_RNDD);
+        if (mpfr_sgn(d) <= 0)
+            return false;
+        mpfr_sqr(d, d, MPFR_RNDD);
+        mpfr_ui_div(d, 1, d, MPFR_RNDU);
+        return true;
+    }
+    static bool period_scale(mpfr_ptr d, const unsigned long u) { // 2 pi / u, for f(2 pi x / u) with |f'| <= 1
+        mpfr_const_pi(d, MPFR_RNDU);
+        mpfr_mul_2ui(d, d, 1, MPFR_RNDU);
+        mpfr_div_ui(d, d, u, MPFR_RNDU);
+        return true;
+    }
+    bool gaussian(mpfr_ptr d) const { // 2 / sqrt(pi) exp(-min|x|^2)
+        radius_t c;
+        min_abs(d);
+        mpfr_sqr(d, d, MPFR_RNDD);
+        mpfr_neg(d, d, MPFR_RNDU);
+        mpfr_exp(d, d, MPFR_RNDU);
+        mpfr_const_pi(c.get_mpfr_t(), MPFR_RNDD);
+        mpfr_rec_sqrt(c.get_mpfr_t(), c.get_mpfr_t(), MPFR_RNDU);
+        mpfr_mul(d, d, c.get_mpfr_t(), MPFR_RNDU);
+        mpfr_mul_2ui(d, d, 1, MPFR_RNDU);
+        return true;
+    }
+    // x^y: |y| x^(y - 1) r_x + x^y |log x| r_y, for x > 0; x^y is largest at a corner of the box
+    bool pow_radius(const mpfr_ball &y, mpfr_ptr rad) const {
+        radius_t lo, hi, p, t, ylo, yhi;
+        low(lo.get_mpfr_t());
+        if (mpfr_sgn(lo.get_mpfr_t()) <= 0 || !is_finite() || !y.is_finite())
+            return false;
+        high(hi.get_mpfr_t());
+        y.low(ylo.get_mpfr_t());
+        y.high(yhi.get_mpfr_t());
+        mpfr_set_zero(p.get_mpfr_t(), 1);
+        for (const radius_t *x : {&lo, &hi}) {
+            for (const radius_t *e : {&ylo, &yhi}) {
+                mpfr_pow(t.get_mpfr_t(), x->get_mpfr_t(), e->get_mpfr_t(), MPFR_RNDU);
+                mpfr_max(p.get_mpfr_t(), p.get_mpfr_t(), t.get_mpfr_t(), MPFR_RNDU);
+            }
+        }
+        y.max_abs(t.get_mpfr_t());
+        mpfr_mul(t.get_mpfr_t(), t.get_mpfr_t(), p.get_mpfr_t(), MPFR_RNDU);
+        mpfr_div(t.get_mpfr_t(), t.get_mpfr_t(), lo.get_mpfr_t(), MPFR_RNDU);
+        mpfr_mul(rad, t.get_mpfr_t(), r.get_mpfr_t(), MPFR_RNDU);
+        mpfr_log(lo.get_mpfr_t(), lo.get_mpfr_t(), MPFR_RNDA);
+        mpfr_log(hi.get_mpfr_t(), hi.get_mpfr_t(), MPFR_RNDA);
+        mpfr_abs(lo.get_mpfr_t(), lo.get_mpfr_t(), MPFR_RNDU);
+        mpfr_abs(hi.get_mpfr_t(), hi.get_mpfr_t(), MPFR_RNDU);
+        mpfr_max(t.get_mpfr_t(), lo.get_mpfr_t(), hi.get_mpfr_t(), MPFR_RNDU);
+        mpfr_mul(t.get_mpfr_t(), t.get_mpfr_t(), p.get_mpfr_t(), MPFR_RNDU);
+        mpfr_mul(t.get_mpfr_t(), t.get_mpfr_t(), y.r.get_mpfr_t(), MPFR_RNDU);
+        mpfr_add(rad, rad, t.get_mpfr_t(), MPFR_RNDU);
+        return true;
+    }
+    // agm(x, y): increasing in both and of degree 1, so x d/dx + y d/dy = agm bounds each
+    // term; agm(hi_x, hi_y) (r_x / lo_x + r_y / lo_y), for x, y > 0
+    bool agm_radius(const mpfr_ball &y, mpfr_ptr rad) const {
+        radius_t t, u;
+        low(t.get_mpfr_t());
+        y.low(u.get_mpfr_t());
+        if (mpfr_sgn(t.get_mpfr_t()) <= 0 || mpfr_sgn(u.get_mpfr_t()) <= 0 || !is_finite() || !y.is_finite())
+            return false;
+        mpfr_div(t.get_mpfr_t(), r.get_mpfr_t(), t.get_mpfr_t(), MPFR_RNDU);
+        mpfr_div(u.get_mpfr_t(), y.r.get_mpfr_t(), u.get_mpfr_t(), MPFR_RNDU);
+        mpfr_add(rad, t.get_mpfr_t(), u.get_mpfr_t(), MPFR_RNDU);
+        high(t.get_mpfr_t());
+        y.high(u.get_mpfr_t());
+        mpfr_agm(t.get_mpfr_t(), t.get_mpfr_t(), u.get_mpfr_t(), MPFR_RNDU);
+        mpfr_mul(rad, rad, t.get_mpfr_t(), MPFR_RNDU);
+        return true;
+    }
+    // atan2(y, x): |grad| = 1 / |(x, y)|, so (r_x + r_y) / min |(x, y)|, for a box clear of
+    // the origin and of the cut along the negative x axis
+    bool atan2_radius(const mpfr_ball &y, mpfr_ptr rad) const {
+        radius_t t, u;
+        low(t.get_mpfr_t());
+        y.min_abs(u.get_mpfr_t());
+        if (!is_finite() || !y.is_finite() || (mpfr_sgn(t.get_mpfr_t()) < 0 && mpfr_zero_p(u.get_mpfr_t())))
+            return false;
+        min_abs(t.get_mpfr_t());
+        mpfr_sqr(t.get_mpfr_t(), t.get_mpfr_t(), MPFR_RNDD);
+        mpfr_sqr(u.get_mpfr_t(), u.get_mpfr_t(), MPFR_RNDD);
+        mpfr_add(t.get_mpfr_t(), t.get_mpfr_t(), u.get_mpfr_t(), MPFR_RNDD);
+        if (mpfr_zero_p(t.get_mpfr_t()))
+            return false;
+        mpfr_rec_sqrt(t.get_mpfr_t(), t.get_mpfr_t(), MPFR_RNDU);
+        mpfr_add(rad, r.get_mpfr_t(), y.r.get_mpfr_t(), MPFR_RNDU);
+        mpfr_mul(rad, rad, t.get_mpfr_t(), MPFR_RNDU);
+        return true;
+    }
+    // how far a lies above b, rounded down: positive when a > b for certain
+    int gap(const mpfr_ball &b) const {
+        radius_t d, s;
+        mpfr_sub(d.get_mpfr_t(), m.get_mpfr_t(), b.m.get_mpfr_t(), MPFR_RNDD);
+        mpfr_add(s.get_mpfr_t(), r.get_mpfr_t(), b.r.get_mpfr_t(), MPFR_RNDU);
+        if (mpfr_nan_p(d.get_mpfr_t()) || mpfr_nan_p(s.get_mpfr_t()) || mpfr_inf_p(s.get_mpfr_t()))
+            return -1;
+        return mpfr_cmp(d.get_mpfr_t(), s.get_mpfr_t());
+    }
+};
+
+// pi, log 2, Euler's and Catalan's constants at the default precision, each within half an ulp
+inline mpfr_ball mpfr_ball_constant(const mpfr_class &c) {
+    const long half_ulp = static_cast<long>(mpfr_get_exp(c.get_mpfr_t()) - static_cast<mpfr_exp_t>(mpfr_get_prec(c.get_mpfr_t()))) - 1;
+    return mpfr_ball(c, mul_2si(mpfr_class(1.0), half_ulp, MPFR_RNDN));
+}
+template <class T, typename std::enable_if<std::is_same<T, mpfr_ball>::value, int>::type = 0> inline T const_pi() { return mpfr_ball_constant(const_pi(MPFR_RNDN)); }
+template <class T, typename std::enable_if<std::is_same<T, mpfr_ball>::value, int>::type = 0> inline T const_log2() { return mpfr_ball_constant(const_log2(MPFR_RNDN)); }
+template <class T, typename std::enable_if<std::is_same<T, mpfr_ball>::value, int>::type = 0> inline T const_euler() { return mpfr_ball_constant(const_euler(MPFR_RNDN)); }
+template <class T, typename std::enable_if<std::is_same<T, mpfr_ball>::value, int>::type = 0> inline T const_catalan() { return mpfr_ball_constant(const_catalan(MPFR_RNDN)); }
+
+} // namespace mpfr
+
+#endif
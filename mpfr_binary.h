@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_BINARY_H_
+#define _MPFR_BINARY_H_
+
+#include <cstdio>
+#ifndef MPFR_USE_FILE
+#define MPFR_USE_FILE // declares mpfr_fpif_export / mpfr_fpif_import, also if mpfr.h came first
+#endif
+#include <mpfr.h>
+#include "mpfr_class.h"
+#include "mpfr_vector.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Binary save and load, exact and much smaller and faster than text.
+//
+//   * single values use MPFR's portable format, mpfr_fpif_export / mpfr_fpif_import:
+//     precision, sign, exponent and the significant bytes. Loading sets the precision.
+//   * arrays of one precision (mpfr_vector, std::vector<mpfr_class>) use a block:
+//
+//       | header (48 bytes) | exponents, int64[n] | kinds, int8[n], padded to 8 | limbs[n * stride] |
+//
+//     The limbs are MPFR's, in the byte order and limb size of the machine, which the
+//     header records and load() checks; an mpfr_vector is read with one read of the limbs.
+//
+// Every function takes a FILE * or an iostream:
+//
+//   mpfr::binary::save(f, v);        // FILE *f = std::fopen("state.bin", "wb")
+//   mpfr::binary::load(is, v);       // std::ifstream is("state.bin", std::ios::binary)
+//
+// Errors (short reads and writes, bad headers, invalid values) throw std::runtime_error.
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+namespace binary {
+
+struct header {
+    char magic[8];         // "MPFRVEC"
+    uint32_t version;      // 1
+    uint32_t limb_bytes;   // sizeof(mp_limb_t)
+    uint32_t byte_order;   // 0x01020304 as stored by the machine which wrote it
+    uint32_t stride;       // limbs per element
+    int64_t prec;
+    uint64_t count;
+    uint64_t reserved;
+};
+static_assert(sizeof(header) == 48, "the header is written as it is laid out");
+
+constexpr uint32_t version = 1;
+constexpr size_t chunk_bytes = 1 << 20; // limbs are staged through a buffer of this size when gathered
+
+namespace detail {
+
+inline void fail(const char *what) {
+    std::cerr << "Error in mpfr::binary: " << what << std::endl;
+    throw std::runtime_error(std::string("mpfr::binary: ") + what);
+}
+
+// where the bytes go and come from; FILE * and iostreams
+struct file_io {
+    std::FILE *f;
+    void write(const void *p, size_t bytes) {
+        if (bytes != 0 && std::fwrite(p, 1, bytes, f) != bytes)
+            fail("write failed");
+    }
+    void read(void *p, size_t bytes) {
+        if (bytes != 0 && std::fread(p, 1, bytes, f) != bytes)
+            fail("unexpected end of file");
+    }
+};
+struct stream_io {
+    std::ostream *os;
+    std::istream *is;
+    void write(const void *p, size_t bytes) {
+        if (!os->write(static_cast<const char *>(p), static_cast<std::streamsize>(bytes)))
+            fail("write failed");
+    }
+    void read(void *p, size_t bytes) {
+        if (!is->read(static_cast<char *>(p), static_cast<std::streamsize>(bytes)))
+            fail("unexpected end of stream");
+    }
+};
+
+// An unbuffered FILE * on top of an iostream, for mpfr_fpif_*. Unbuffered, so that it
+// reads no further into the stream than MPFR asks for.
+#if defined(__GLIBC__)
+inline ssize_t cookie_read(void *c, char *buf, size_t size) {
+    std::istream *is = static_cast<std::istream *>(c);
+    is->read(buf, static_cast<std::streamsize>(size));
+    return static_cast<ssize_t>(is->gcount());
+}
+inline ssize_t cookie_write(void *c, const char *buf, size_t size) {
+    std::ostream *os = static_cast<std::ostream *>(c);
+    return os->write(buf, static_cast<std::streamsize>(size)) ? static_cast<ssize_t>(size) : -1;
+}
+inline std::FILE *open_stream(std::istream *is, std::ostream *os) {
+    cookie_io_functions_t functions = {};
+    functions.read = is != nullptr ? cookie_read : nullptr;
+    functions.write = os != nullptr ? cookie_write : nullptr;
+    std::FILE *f = fopencookie(is != nullptr ? static_cast<void *>(is) : static_cast<void *>(os), is != nullptr ? "r" : "w", functions);
+#else
+inline int cookie_read(void *c, char *buf, int size) {
+    std::istream *is = static_cast<std::istream *>(c);
+    is->read(buf, size);
+    return static_cast<int>(is->gcount());
+}
+inline int cookie_write(void *c, const char *buf, int size) {
+    std::ostream *os = static_cast<std::ostream *>(c);
+    return os->write(buf, size) ? size : -1;
+}
+inline std::FILE *open_stream(std::istream *is, std::ostream *os) {
+    std::FILE *f = funopen(is != nullptr ? static_cast<void *>(is) : static_cast<void *>(os), is != nullptr ? cookie_read : nullptr, os != nullptr ? cookie_write : nullptr, nullptr, nullptr);
+#endif
+    if (f == nullptr)
+        fail("cannot open a FILE on the stream");
+    std::setvbuf(f, nullptr, _IONBF, 0);
+    return f;
+}
+struct stream_file {
+    std::FILE *f;
+    stream_file(std::istream *is, std::ostream *os) : f(open_stream(is, os)) {}
+    ~stream_file() { std::fclose(f); }
+    stream_file(const stream_file &) = delete;
+    stream_file &operator=(const stream_file &) = delete;
+};
+
+inline header make_header(const mpfr_prec_t prec, const size_t stride, const size_t count) {
+    header h = {};
+    std::memcpy(h.magic, "MPFRVEC", 8);
+    h.version = version;
+    h.limb_bytes = sizeof(mp_limb_t);
+    h.byte_order = 0x01020304;
+    h.stride = static_cast<uint32_t>(stride);
+    h.prec = prec;
+    h.count = count;
+    return h;
+}
+
+inline void check_header(const header &h) {
+    if (std::memcmp(h.magic, "MPFRVEC", 8) != 0)
+        fail("not an mpfr array");
+    if (h.version != version)
+        fail("unsupported version");
+    if (h.limb_bytes != sizeof(mp_limb_t) || h.byte_order != 0x01020304)
+        fail("written with another limb size or byte order");
+    if (h.prec < MPFR_PREC_MIN || h.prec > MPFR_PREC_MAX)
+        fail("invalid precision");
+    if (h.stride != mpfr_custom_get_size(static_cast<mpfr_prec_t>(h.prec)) / sizeof(mp_limb_t))
+        fail("limb count does not match the precision");
+}
+
+inline size_t kinds_bytes(const size_t count) { return (count + 7) / 8 * 8; }
+
+// An element as MPFR requires it: a known kind, for regular values an exponent in the
+// current range, the top bit set and the bits beyond the precision clear.
+inline void check_element(const int8_t kind, const int64_t exp, const mp_limb_t *limbs, const mpfr_prec_t prec, const size_t stride) {
+    const int k = kind < 0 ? -kind : kind;
+    if (k != MPFR_NAN_KIND && k != MPFR_INF_KIND && k != MPFR_ZERO_KIND && k != MPFR_REGULAR_KIND)
+        fail("invalid element kind");
+    if (k != MPFR_REGULAR_KIND)
+        return;
+    if (exp < mpfr_get_emin() || exp > mpfr_get_emax())
+        fail("exponent out of the current range");
+    const unsigned unused = static_cast<unsigned>(stride * GMP_NUMB_BITS - prec);
+    if ((limbs[stride - 1] >> (GMP_NUMB_BITS - 1)) == 0 || (unused != 0 && (limbs[0] & ((mp_limb_t(1) << unused) - 1)) != 0))
+        fail("invalid significand");
+}
+
+// the exponent and kind arrays of n elements of one precision
+template <class IO, class Get> void write_array(IO &io, const mpfr_prec_t prec, const size_t n, Get get) {
+    const size_t stride = mpfr_custom_get_size(prec) / sizeof(mp_limb_t);
+    const header h = make_header(prec, stride, n);
+    io.write(&h, sizeof(h));
+    std::vector<int64_t> exps(n);
+    std::vector<int8_t> kinds(kinds_bytes(n), 0);
+    for (size_t i = 0; i < n; i++) {
+        mpfr_srcptr x = get(i);
+        if (mpfr_get_prec(x) != prec)
+            fail("the elements differ in precision");
+        kinds[i] = static_cast<int8_t>(mpfr_custom_get_kind(x));
+        exps[i] = mpfr_regular_p(x) ? mpfr_get_exp(x) : 0;
+    }
+    io.write(exps.data(), n * sizeof(int64_t));
+    io.write(kinds.data(), kinds.size());
+    // the limbs of singular values are undefined; they are written as zeros
+    std::vector<mp_limb_t> buffer(std::max<size_t>(stride, chunk_bytes / sizeof(mp_limb_t) / stride * stride));
+    size_t used = 0;
+    for (size_t i = 0; i < n; i++) {
+        mpfr_srcptr x = get(i);
+        if (mpfr_regular_p(x))
+            std::memcpy(&buffer[used], mpfr_custom_get_significand(x), stride * sizeof(mp_limb_t));
+        else
+            std::memset(&buffer[used], 0, stride * sizeof(mp_limb_t));
+        used += stride;
+        if (used == buffer.size() || i + 1 == n) {
+            io.write(buffer.data(), used * sizeof(mp_limb_t));
+            used = 0;
+        }
+    }
+}
+
+template <class IO> header read_header(IO &io, std::vector<int64_t> &exps, std::vector<int8_t> &kinds) {
+    header h;
+    io.read(&h, sizeof(h));
+    check_header(h);
+    // grow with the data actually read, so that a corrupt count fails on the read
+    const size_t n = static_cast<size_t>(h.count);
+    exps.clear();
+    for (size_t done = 0; done < n;) {
+        const size_t part = std::min(n - done, chunk_bytes / sizeof(int64_t));
+        exps.resize(done + part);
+        io.read(exps.data() + done, part * sizeof(int64_t));
+        done += part;
+    }
+    kinds.resize(kinds_bytes(n));
+    io.read(kinds.data(), kinds.size());
+    return h;
+}
+
+template <class IO> void save(IO &io, const mpfr_vector &v) {
+    const size_t n = v.size();
+    const mpfr_prec_t prec = v.get_prec();
+    const size_t stride = v.limb_stride();
+    bool singular = false;
+    for (size_t i = 0; i < n && !singular; i++)
+        singular = !mpfr_regular_p(v[i].get_mpfr_t());
+    if (singular) {
+        write_array(io, prec, n, [&v](size_t i) { return v[i].get_mpfr_t(); });
+        return;
+    }
+    // all regular: the limb block goes out as it is
+    const header h = make_header(prec, stride, n);
+    io.write(&h, sizeof(h));
+    std::vector<int64_t> exps(n);
+    std::vector<int8_t> kinds(kinds_bytes(n), 0);
+    for (size_t i = 0; i < n; i++) {
+        exps[i] = mpfr_get_exp(v[i].get_mpfr_t());
+        kinds[i] = static_cast<int8_t>(mpfr_custom_get_kind(v[i].get_mpfr_t()));
+    }
+    io.write(exps.data(), n * sizeof(int64_t));
+    io.write(kinds.data(), kinds.size());
+    io.write(v.limb_data(), n * stride * sizeof(mp_limb_t));
+}
+
+template <class IO> void load(IO &io, mpfr_vector &v) {
+    std::vector<int64_t> exps;
+    std::vector<int8_t> kinds;
+    const header h = read_header(io, exps, kinds);
+    const size_t n = static_cast<size_t>(h.count);
+    const mpfr_prec_t prec = static_cast<mpfr_prec_t>(h.prec);
+    mpfr_vector w(n, prec);
+    io.read(w.limb_data(), n * h.stride * sizeof(mp_limb_t));
+    mp_limb_t *limbs = w.limb_data();
+    for (size_t i = 0; i < n; i++) {
+        check_element(kinds[i], exps[i], limbs + i * h.stride, prec, h.stride);
+        mpfr_custom_init_set(w.data()[i], kinds[i], static_cast<mpfr_exp_t>(exps[i]), prec, limbs + i * h.stride);
+    }
+    v.swap(w);
+}
+
+template <class IO> void save(IO &io, const std::vector<mpfr_class> &v) {
+    const mpfr_prec_t prec = v.empty() ? defaults::prec : v[0].get_prec();
+    write_array(io, prec, v.size(), [&v](size_t i) { return v[i].get_mpfr_t(); });
+}
+
+template <class IO> void load(IO &io, std::vector<mpfr_class> &v) {
+    std::vector<int64_t> exps;
+    std::vector<int8_t> kinds;
+    const header h = read_header(io, exps, kinds);
+    const size_t n = static_cast<size_t>(h.count);
+    const mpfr_prec_t prec = static_cast<mpfr_prec_t>(h.prec);
+    std::vector<mpfr_class> w(n);
+    std::vector<mp_limb_t> buffer(std::max<size_t>(h.stride, chunk_bytes / sizeof(mp_limb_t) / h.stride * h.stride));
+    for (size_t i = 0; i < n;) {
+        const size_t part = std::min(n - i, buffer.size() / h.stride);
+        io.read(buffer.data(), part * h.stride * sizeof(mp_limb_t));
+        for (size_t j = 0; j < part; j++, i++) {
+            const mp_limb_t *limbs = &buffer[j * h.stride];
+            check_element(kinds[i], exps[i], limbs, prec, h.stride);
+            w[i].set_prec(prec);
+            mpfr_ptr x = w[i].get_mpfr_t();
+            std::memcpy(mpfr_custom_get_significand(x), limbs, h.stride * sizeof(mp_limb_t));
+            mpfr_custom_init_set(x, kinds[i], static_cast<mpfr_exp_t>(exps[i]), prec, mpfr_custom_get_significand(x));
+        }
+    }
+    v.swap(w);
+}
+
+} // namespace detail
+
+// A single value, in the format of mpfr_fpif_export.
+inline void save(std::FILE *f, const mpfr_class &x) {
+    if (mpfr_fpif_export(f, const_cast<mpfr_ptr>(x.get_mpfr_t())) != 0)
+        detail::fail("mpfr_fpif_export failed");
+}
+inline void load(std::FILE *f, mpfr_class &x) {
+    if (mpfr_fpif_import(x.get_mpfr_t(), f) != 0)
+        detail::fail("mpfr_fpif_import failed");
+}
+inline void save(std::ostream &os, const mpfr_class &x) {
+    detail::stream_file f(nullptr, &os);
+    save(f.f, x);
+}
+inline void load(std::istream &is, mpfr_class &x) {
+    detail::stream_file f(&is, nullptr);
+    load(f.f, x);
+}
+
+// Arrays of one precision, in the block format above.
+inline void save(std::FILE *f, const mpfr_vector &v) {
+    detail::file_io io{f};
+    detail::save(io, v);
+}
+inline void load(std::FILE *f, mpfr_vector &v) {
+    detail::file_io io{f};
+    detail::load(io, v);
+}
+inline void save(std::ostream &os, const mpfr_vector &v) {
+    detail::stream_io io{&os, nullptr};
+    detail::save(io, v);
+}
+inline void load(std::istream &is, mpfr_vector &v) {
+    detail::stream_io io{nullptr, &is};
+    detail::load(io, v);
+}
+inline void save(std::FILE *f, const std::vector<mpfr_class> &v) {
+    detail::file_io io{f};
+    detail::save(io, v);
+}
+inline void load(std::FILE *f, std::vector<mpfr_class> &v) {
+    detail::file_io io{f};
+    detail::load(io, v);
+}
+inline void save(std::ostream &os, const std::vector<mpfr_class> &v) {
+    detail::stream_io io{&os, nullptr};
+    detail::save(io, v);
+}
+inline void load(std::istream &is, std::vector<mpfr_class> &v) {
+    detail::stream_io io{nullptr, &is};
+    detail::load(io, v);
+}
+
+} // namespace binary
+} // namespace mpfr
+
+#endif
@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef _MPFR_BLAS_H_
+#define _MPFR_BLAS_H_
+
+#include "mpfr_class.h"
+#include "mpfr_vector.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// BLAS kernels on mpfr_class, mpfr_fixed<Bits> and mpfr_vector storage.
+//
+// x and y are anything indexable with [] that yields an mpfr leaf: mpfr_class *,
+// mpfr_fixed<Bits> *, mpfr_vector::iterator, ... Strided entry points follow the
+// reference BLAS (a negative increment walks the vector backwards); the unit-stride
+// ones drop the increments, and mpfr_vector ones the length too. Scalar results are
+// mpfr_class at the default precision.
+//
+// Level 1:
+//   dot      correctly rounded (mpfr_dot)            dot_fma  running mpfr_fma, faster
+//   axpy     y = a * x + y                           scal     x = a * x
+//   nrm2     ||x||_2, scaled by a power of two       asum     sum |x_i|
+//   iamax    first index of the largest |x_i| (from 0, as in CBLAS)
+//
+// Level 2:
+//   gemv     y = alpha * op(A) * x + beta * y        symv     the same, A symmetric
+//   trsv     x = op(A)^-1 * x, A triangular          ger      A = alpha * x * y^T + A
+//
+// Level 3:
+//   gemm     C = alpha * op(A) * op(B) + beta * C, packed and cache blocked
+//
+// With set_num_threads(k), kernels split vectors of at least 2 * min_per_thread
+// elements across up to k threads. Reductions then combine per-thread partial results
+// in order, so they depend on the thread count but not on scheduling. dot is always
+// correctly rounded and is not split. Level 2 kernels split rows and gemm C tiles
+// instead; each result is then computed by one thread and does not depend on the
+// thread count.
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+namespace blas {
+
+constexpr long min_per_thread = 1024;
+inline std::atomic<int> num_threads{1};
+inline void set_num_threads(const int n) { num_threads = n < 1 ? 1 : n; }
+inline int get_num_threads() { return num_threads; }
+
+inline int parts_for(const long n) {
+    const long parts = n / min_per_thread;
+    const int k = num_threads;
+    return parts < 1 ? 1 : (parts > k ? k : static_cast<int>(parts));
+}
+// Calls body(part, begin, end) for `parts` contiguous blocks of [0, n); part 0 runs on
+// the calling thread. The workers take over the caller's precision and rounding mode.
+template <class F> inline void parallel_for(const int parts, const long n, F body) {
+    if (parts <= 1) {
+        body(0, 0L, n);
+        return;
+    }
+    const mpfr_prec_t prec = defaults::prec;
+    const mpfr_rnd_t rnd = defaults::rnd;
+    std::vector<std::thread> workers;
+    for (int p = 1; p < parts; p++) {
+        workers.emplace_back([&, p] {
+            precision_scope scope(prec, rnd);
+            body(p, n * p / parts, n * (p + 1) / parts);
+        });
+    }
+    body(0, 0L, n / parts);
+    for (auto &w : workers)
+        w.join();
+}
+// first index touched by a strided loop, as in the reference BLAS
+inline long first_index(const long n, const long inc) { return inc < 0 ? (1 - n) * inc : 0; }
+// the vectors x and y of a whole-vector overload have the same size
+inline void check_sizes(const size_t nx, const size_t ny) {
+    if (nx != ny) {
+        std::cerr << "Error: x has " << nx << " elements and y has " << ny << std::endl;
+        throw std::runtime_error("Vector sizes differ.");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Level 1
+////////////////////////////////////////////////////////////////////////////////////////
+template <class X, class Y> inline mpfr_class dot(const long n, X x, const long incx, Y y, const long incy) {
+    mpfr_class rop(0.0);
+    if (n <= 0)
+        return rop;
+    std::vector<mpfr_ptr> px(n), py(n); // mpfr_dot only reads through these
+    const long ix = first_index(n, incx), iy = first_index(n, incy);
+    for (long i = 0; i < n; i++) {
+        px[i] = const_cast<mpfr_ptr>(static_cast<mpfr_srcptr>(x[ix + i * incx].get_mpfr_t()));
+        py[i] = const_cast<mpfr_ptr>(static_cast<mpfr_srcptr>(y[iy + i * incy].get_mpfr_t()));
+    }
+    mpfr_dot(rop.get_mpfr_t(), px.data(), py.data(), n, defaults::rnd);
+    return rop;
+}
+template <class X, class Y> inline mpfr_class dot(const long n, X x, Y y) { return dot(n, x, 1, y, 1); }
+inline mpfr_class dot(const mpfr_vector &x, const mpfr_vector &y) {
+    check_sizes(x.size(), y.size());
+    mpfr_class rop(0.0);
+    mpfr_dot(rop.get_mpfr_t(), x.data(), y.data(), x.size(), defaults::rnd);
+    return rop;
+}
+
+template <class X, class Y> inline mpfr_class dot_fma(const long n, X x, const long incx, Y y, const long incy) {
+    const int parts = parts_for(n);
+    std::vector<mpfr_class> acc(parts);
+    const long ix = first_index(n, incx), iy = first_index(n, incy);
+    parallel_for(parts, n, [&](int p, long begin, long end) {
+        mpfr_class &s = acc[p];
+        s = 0.0;
+        for (long i = begin; i < end; i++)
+            s += x[ix + i * incx] * y[iy + i * incy];
+    });
+    for (int p = 1; p < parts; p++)
+        acc[0] += acc[p];
+    return std::move(acc[0]);
+}
+template <class X, class Y> inline mpfr_class dot_fma(const long n, X x, Y y) { return dot_fma(n, x, 1, y, 1); }
+inline mpfr_class dot_fma(const mpfr_vector &x, const mpfr_vector &y) {
+    check_sizes(x.size(), y.size());
+    return dot_fma(static_cast<long>(x.size()), x.begin(), y.begin());
+}
+
+// a is an mpfr leaf or a scalar
+template <class A, class X, class Y> inline void axpy(const long n, const A &a, X x, const long incx, Y y, const long incy) {
+    const long ix = first_index(n, incx), iy = first_index(n, incy);
+    parallel_for(parts_for(n), n, [&](int, long begin, long end) {
+        for (long i = begin; i < end; i++)
+            y[iy + i * incy] += a * x[ix + i * incx];
+    });
+}
+template <class A, class X, class Y> inline void axpy(const long n, const A &a, X x, Y y) { axpy(n, a, x, 1, y, 1); }
+template <class A> inline void axpy(const A &a, const mpfr_vector &x, mpfr_vector &y) {
+    check_sizes(x.size(), y.size());
+    axpy(static_cast<long>(x.size()), a, x.begin(), y.begin());
+}
+
+template <class A, class X> inline void scal(const long n, const A &a, X x, const long incx) {
+    const long ix = first_index(n, incx);
+    parallel_for(parts_for(n), n, [&](int, long begin, long end) {
+        for (long i = begin; i < end; i++)
+            x[ix + i * incx] *= a;
+    });
+}
+template <class A, class X> inline void scal(const long n, const A &a, X x) { scal(n, a, x, 1); }
+template <class A> inline void scal(const A &a, mpfr_vector &x) { scal(static_cast<long>(x.size()), a, x.begin()); }
+
+// sqrt(sum (x_i 2^-e)^2) 2^e, e the largest exponent: scaling by a power of two is exact
+// and keeps the squares away from overflow and underflow whatever the exponent range.
+template <class X> inline mpfr_class nrm2(const long n, X x, const long incx) {
+    mpfr_class rop(0.0);
+    const long ix = first_index(n, incx);
+    mpfr_exp_t e = 0;
+    bool regular = false;
+    for (long i = 0; i < n; i++) {
+        mpfr_srcptr xi = x[ix + i * incx].get_mpfr_t();
+        if (mpfr_nan_p(xi) || mpfr_inf_p(xi)) {
+            mpfr_abs(rop.get_mpfr_t(), xi, defaults::rnd);
+            return rop;
+        }
+        if (mpfr_regular_p(xi) && (!regular || mpfr_get_exp(xi) > e)) {
+            e = mpfr_get_exp(xi);
+            regular = true;
+        }
+    }
+    if (!regular)
+        return rop;
+    const int parts = parts_for(n);
+    std::vector<mpfr_class> acc(parts);
+    parallel_for(parts, n, [&](int p, long begin, long end) {
+        mpfr_class &s = acc[p];
+        s = 0.0;
+        mpfr_t t;
+        mpfr_init2(t, MPFR_PREC_MIN);
+        for (long i = begin; i < end; i++) {
+            mpfr_srcptr xi = x[ix + i * incx].get_mpfr_t();
+            if (mpfr_get_prec(t) != mpfr_get_prec(xi))
+                mpfr_set_prec(t, mpfr_get_prec(xi));
+            mpfr_mul_2si(t, xi, -e, MPFR_RNDN);
+            mpfr_fma(s.get_mpfr_t(), t, t, s.get_mpfr_t(), defaults::rnd);
+        }
+        mpfr_clear(t);
+    });
+    for (int p = 1; p < parts; p++)
+        acc[0] += acc[p];
+    mpfr_sqrt(rop.get_mpfr_t(), acc[0].get_mpfr_t(), defaults::rnd);
+    mpfr_mul_2si(rop.get_mpfr_t(), rop.get_mpfr_t(), e, defaults::rnd);
+    return rop;
+}
+template <class X> inline mpfr_class nrm2(const long n, X x) { return nrm2(n, x, 1); }
+inline mpfr_class nrm2(const mpfr_vector &x) { return nrm2(static_cast<long>(x.size()), x.begin()); }
+
+template <class X> inline mpfr_class asum(const long n, X x, const long incx) {
+    const int parts = parts_for(n);
+    std::vector<mpfr_class> acc(parts);
+    const long ix = first_index(n, incx);
+    parallel_for(parts, n, [&](int p, long begin, long end) {
+        mpfr_class &s = acc[p];
+        s = 0.0;
+        for (long i = begin; i < end; i++) {
+            if (mpfr_signbit(x[ix + i * incx].get_mpfr_t()))
+                s -= x[ix + i * incx];
+            else
+                s += x[ix + i * incx];
+        }
+    });
+    for (int p = 1; p < parts; p++)
+        acc[0] += acc[p];
+    return std::move(acc[0]);
+}
+template <class X> inline mpfr_class asum(const long n, X x) { return asum(n, x, 1); }
+inline mpfr_class asum(const mpfr_vector &x) { return asum(static_cast<long>(x.size()), x.begin()); }
+
+// counts i, not memory positions: with incx < 0, i = 0 is x[(1 - n) * incx]
+template <class X> inline long iamax(const long n, X x, const long incx) {
+    if (n <= 0)
+        return 0;
+    const int parts = parts_for(n);
+    std::vector<long> best(parts);
+    const long ix = first_index(n, incx);
+    parallel_for(parts, n, [&](int p, long begin, long end) {
+        long b = begin;
+        for (long i = begin + 1; i < end; i++)
+            if (mpfr_cmpabs(x[ix + i * incx].get_mpfr_t(), x[ix + b * incx].get_mpfr_t()) > 0)
+                b = i;
+        best[p] = b;
+    });
+    long b = best[0];
+    for (int p = 1; p < parts; p++)
+        if (mpfr_cmpabs(x[ix + best[p] * incx].get_mpfr_t(), x[ix + b * incx].get_mpfr_t()) > 0)
+            b = best[p];
+    return b;
+}
+template <class X> inline long iamax(const long n, X x) { return iamax(n, x, 1); }
+inline long iamax(const mpfr_vector &x) { return iamax(static_cast<long>(x.size()), x.begin()); }
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Matrices
+////////////////////////////////////////////////////////////////////////////////////////
+// Matrices are stored with a leading dimension, column-major by default as in the
+// reference BLAS: element (i, j) of A is A[i + j * lda], or A[i * lda + j] row-major.
+enum layout { col_major, row_major };
+
+inline bool is_trans(const char trans) {
+    switch (trans) {
+    case 'N':
+    case 'n':
+        return false;
+    case 'T':
+    case 't':
+    case 'C':
+    case 'c':
+        return true;
+    }
+    std::cerr << "Error: invalid transpose argument '" << trans << "'" << std::endl;
+    throw std::runtime_error("Invalid transpose argument.");
+}
+inline bool is_lower(const char uplo) {
+    switch (uplo) {
+    case 'U':
+    case 'u':
+        return false;
+    case 'L':
+    case 'l':
+        return true;
+    }
+    std::cerr << "Error: invalid uplo argument '" << uplo << "'" << std::endl;
+    throw std::runtime_error("Invalid uplo argument.");
+}
+inline bool is_unit(const char diag) {
+    switch (diag) {
+    case 'N':
+    case 'n':
+        return false;
+    case 'U':
+    case 'u':
+        return true;
+    }
+    std::cerr << "Error: invalid diag argument '" << diag << "'" << std::endl;
+    throw std::runtime_error("Invalid diag argument.");
+}
+// ld must cover the extent of the leading dimension: rows column-major, columns row-major
+inline void check_ld(const char *name, const long ld, const long extent) {
+    if (ld < (extent > 1 ? extent : 1)) {
+        std::cerr << "Error: " << name << " = " << ld << " is smaller than " << extent << std::endl;
+        throw std::runtime_error("Invalid leading dimension.");
+    }
+}
+// the vector under a whole-vector overload holds its rows x cols matrix with leading dimension ld
+inline void check_sizes(const char *name, const size_t size, const long rows, const long cols, const long ld) {
+    const size_t needed = rows > 0 && cols > 0 ? static_cast<size_t>(ld * (cols - 1) + rows) : 0;
+    if (size < needed) {
+        std::cerr << "Error: " << name << " has " << size << " elements and needs " << needed << std::endl;
+        throw std::runtime_error("Vector too short for its matrix.");
+    }
+}
+
+// op(A)(i, j) is A[i * rs + j * cs]
+struct strides {
+    long rs, cs;
+};
+inline strides strides_for(const layout order, const bool trans, const long lda) { return (order == row_major) != trans ? strides{lda, 1} : strides{1, lda}; }
+
+// rop = alpha * r + beta * rop, without reading rop when beta is zero
+template <class A_, class R, class B_, class T> inline void scale_add(T &&rop, const A_ &alpha, const R &r, const B_ &beta) {
+    if (beta == 0)
+        rop = alpha * r;
+    else
+        rop = alpha * r + beta * rop;
+}
+
+// rows are split across threads once there are min_per_thread elements per thread
+inline int parts_for_rows(const long rows, const long cols) {
+    const int parts = parts_for(rows * (cols > 1 ? cols : 1));
+    return rows < parts ? static_cast<int>(rows) : parts;
+}
+
+// Per-thread row accumulator: running mpfr_fma, or with exact set, exact products
+// summed once by mpfr_sum. The storage is sized up front and reused row after row.
+class row_accumulator {
+  public:
+    row_accumulator(const long n, const bool exact, const mpfr_prec_t product_prec) : exact(exact), products(exact ? n : 0, product_prec) { mpfr_init2(sum, defaults::prec); }
+    ~row_accumulator() { mpfr_clear(sum); }
+    row_accumulator(const row_accumulator &) = delete;
+    row_accumulator &operator=(const row_accumulator &) = delete;
+
+    void clear() {
+        mpfr_set_zero(sum, 1);
+        count = 0;
+    }
+    void add(mpfr_srcptr a, mpfr_srcptr b) {
+        if (exact)
+            mpfr_mul(products.data()[count++], a, b, MPFR_RNDN); // exact at product_prec
+        else
+            mpfr_fma(sum, a, b, sum, defaults::rnd);
+    }
+    mpfr_srcptr result() {
+        if (exact)
+            mpfr_sum(sum, products.data(), count, defaults::rnd);
+        return sum;
+    }
+
+  private:
+    bool exact;
+    mpfr_vector products;
+    unsigned long count = 0;
+    mpfr_t sum;
+};
+// precision that holds every product of an element of the m x n matrix A and of x exactly
+template <class TA, class X> inline mpfr_prec_t product_prec(const long m, const long n, TA A, const strides s, const long len, X x, const long incx) {
+    mpfr_prec_t pa = MPFR_PREC_MIN, px = MPFR_PREC_MIN;
+    for (long i = 0; i < m; i++)
+        for (long j = 0; j < n; j++)
+            pa = std::max(pa, mpfr_get_prec(A[i * s.rs + j * s.cs].get_mpfr_t()));
+    const long ix = first_index(len, incx);
+    for (long i = 0; i < len; i++)
+        px = std::max(px, mpfr_get_prec(x[ix + i * incx].get_mpfr_t()));
+    return pa + px;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Level 2
+////////////////////////////////////////////////////////////////////////////////////////
+// Rows of the result are split across threads and each row is accumulated by one
+// thread in increasing column order, so results do not depend on the thread count.
+// With exact set, every row sum is correctly rounded through mpfr_sum; alpha and beta
+// are then applied with one more rounding.
+
+// y = alpha * op(A) * x + beta * y, A m x n
+template <class A_, class TA, class X, class B_, class Y>
+inline void gemv(const layout order, const char trans, const long m, const long n, const A_ &alpha, TA A, const long lda, X x, const long incx, const B_ &beta, Y y, const long incy,
+                 const bool exact = false) {
+    const bool ta = is_trans(trans);
+    check_ld("lda", lda, order == col_major ? m : n);
+    const long rows = ta ? n : m, cols = ta ? m : n;
+    if (rows <= 0)
+        return;
+    const strides s = strides_for(order, ta, lda);
+    const long ix = first_index(cols, incx), iy = first_index(rows, incy);
+    const mpfr_prec_t pp = exact ? product_prec(rows, cols, A, s, cols, x, incx) : MPFR_PREC_MIN;
+    parallel_for(parts_for_rows(rows, cols), rows, [&](int, long begin, long end) {
+        row_accumulator acc(cols, exact, pp);
+        for (long i = begin; i < end; i++) {
+            acc.clear();
+            for (long j = 0; j < cols; j++)
+                acc.add(A[i * s.rs + j * s.cs].get_mpfr_t(), x[ix + j * incx].get_mpfr_t());
+            scale_add(y[iy + i * incy], alpha, mpfr_cref(acc.result()), beta);
+        }
+    });
+}
+
+// y = alpha * A * x + beta * y, A n x n symmetric; only the uplo triangle is read
+template <class A_, class TA, class X, class B_, class Y>
+inline void symv(const layout order, const char uplo, const long n, const A_ &alpha, TA A, const long lda, X x, const long incx, const B_ &beta, Y y, const long incy, const bool exact = false) {
+    const bool lower = is_lower(uplo);
+    check_ld("lda", lda, n);
+    if (n <= 0)
+        return;
+    const strides s = strides_for(order, false, lda);
+    // (i, j) of the full matrix, read from the stored triangle
+    auto at = [&](long i, long j) { return ((i >= j) == lower) ? i * s.rs + j * s.cs : j * s.rs + i * s.cs; };
+    const long ix = first_index(n, incx), iy = first_index(n, incy);
+    const mpfr_prec_t pp = exact ? product_prec(n, n, A, s, n, x, incx) : MPFR_PREC_MIN;
+    parallel_for(parts_for_rows(n, n), n, [&](int, long begin, long end) {
+        row_accumulator acc(n, exact, pp);
+        for (long i = begin; i < end; i++) {
+            acc.clear();
+            for (long j = 0; j < n; j++)
+                acc.add(A[at(i, j)].get_mpfr_t(), x[ix + j * incx].get_mpfr_t());
+            scale_add(y[iy + i * incy], alpha, mpfr_cref(acc.result()), beta);
+        }
+    });
+}
+
+// Solves op(A) * x = b in place (x holds b on entry), A n x n triangular; diag 'U'
+// takes the diagonal as ones without reading it. Blocks of trsv_nb unknowns are solved
+// in turn and the rows below them updated in parallel, so the rounding depends on
+// trsv_nb but not on the thread count.
+constexpr long trsv_nb = 64;
+template <class TA, class X> inline void trsv(const layout order, const char uplo, const char trans, const char diag, const long n, TA A, const long lda, X x, const long incx) {
+    const bool ta = is_trans(trans), unit = is_unit(diag);
+    const bool forward = is_lower(uplo) != ta; // op(A) lower triangular
+    check_ld("lda", lda, n);
+    if (n <= 0)
+        return;
+    const strides s = strides_for(order, ta, lda);
+    const long ix = first_index(n, incx);
+    // k-th unknown in solve order
+    auto row = [&](long k) { return forward ? k : n - 1 - k; };
+    auto xp = [&](long i) -> mpfr_ptr { return x[ix + i * incx].get_mpfr_t(); };
+    // x_r -= sum of op(A)(r, c) x_c over the unknowns c = row(k), k in [k0, k1)
+    auto update = [&](mpfr_ptr sum, long r, long k0, long k1) {
+        mpfr_set_zero(sum, 1);
+        for (long k = k0; k < k1; k++)
+            mpfr_fma(sum, A[r * s.rs + row(k) * s.cs].get_mpfr_t(), xp(row(k)), sum, defaults::rnd);
+        mpfr_sub(xp(r), xp(r), sum, defaults::rnd);
+    };
+    mpfr_class sum;
+    for (long k0 = 0; k0 < n; k0 += trsv_nb) {
+        const long k1 = k0 + trsv_nb < n ? k0 + trsv_nb : n;
+        for (long k = k0; k < k1; k++) {
+            const long r = row(k);
+            update(sum.get_mpfr_t(), r, k0, k);
+            if (!unit)
+                mpfr_div(xp(r), xp(r), A[r * s.rs + r * s.cs].get_mpfr_t(), defaults::rnd);
+        }
+        parallel_for(parts_for_rows(n - k1, k1 - k0), n - k1, [&](int, long begin, long end) {
+            mpfr_class t;
+            for (long k = k1 + begin; k < k1 + end; k++)
+                update(t.get_mpfr_t(), row(k), k0, k1);
+        });
+    }
+}
+
+// A = alpha * x * y^T + A, A m x n
+template <class A_, class X, class Y, class TA>
+inline void ger(const layout order, const long m, const long n, const A_ &alpha, X x, const long incx, Y y, const long incy, TA A, const long lda) {
+    check_ld("lda", lda, order == col_major ? m : n);
+    if (m <= 0 || n <= 0)
+        return;
+    const strides s = strides_for(order, false, lda);
+    const long ix = first_index(m, incx), iy = first_index(n, incy);
+    parallel_for(parts_for_rows(m, n), m, [&](int, long begin, long end) {
+        mpfr_class t;
+        for (long i = begin; i < end; i++) {
+            t = alpha * x[ix + i * incx];
+            for (long j = 0; j < n; j++) {
+                mpfr_ptr a = A[i * s.rs + j * s.cs].get_mpfr_t();
+                mpfr_fma(a, t.get_mpfr_t(), y[iy + j * incy].get_mpfr_t(), a, defaults::rnd);
+            }
+        }
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Level 3
+////////////////////////////////////////////////////////////////////////////////////////
+// gemm register block (mr x nr) and cache blocks. A packed kc x nr sliver of B stays in
+// L1 while the kernel streams an mr x kc sliver of A; the packed mc x kc block of A
+// stays in L2 and the kc x nc panel of B in L3. Sizes follow the bytes a value takes.
+constexpr long gemm_mr = 4, gemm_nr = 4;
+struct gemm_blocking {
+    long mc, nc, kc;
+};
+inline gemm_blocking gemm_blocking_for(const mpfr_prec_t prec) {
+    const long bytes = static_cast<long>(sizeof(__mpfr_struct) + mpfr_custom_get_size(prec));
+    auto fit = [](long cache, long per, long lo, long hi, long step) {
+        long v = cache / per;
+        v = v < lo ? lo : (v > hi ? hi : v);
+        return v / step * step;
+    };
+    gemm_blocking b;
+    b.kc = fit(32 * 1024, gemm_nr * bytes, 16, 256, 1);
+    b.mc = fit(256 * 1024, b.kc * bytes, gemm_mr, 256, gemm_mr);
+    b.nc = fit(2 * 1024 * 1024, b.kc * bytes, gemm_nr, 256, gemm_nr);
+    return b;
+}
+
+// C = alpha * op(A) * op(B) + beta * C, op(A) m x k and op(B) k x n; trans is 'N' or 'T'.
+// alpha and beta are mpfr leaves or scalars. Each C(i, j) is accumulated by one thread
+// with mpfr_fma in increasing p at the default precision, then combined once with alpha
+// and beta, so the result does not depend on the blocking or the thread count. A and B
+// are packed at the default precision; wider inputs are rounded. With beta == 0, C is
+// not read.
+template <class A_, class TA, class TB, class TC, class B_>
+inline void gemm(const char transa, const char transb, const long m, const long n, const long k, const A_ &alpha, TA A, const long lda, TB B, const long ldb, const B_ &beta, TC C,
+                 const long ldc) {
+    const bool ta = is_trans(transa), tb = is_trans(transb);
+    check_ld("lda", lda, ta ? k : m);
+    check_ld("ldb", ldb, tb ? n : k);
+    check_ld("ldc", ldc, m);
+    if (m <= 0 || n <= 0)
+        return;
+
+    const mpfr_prec_t prec = defaults::prec;
+    const mpfr_rnd_t rnd = defaults::rnd;
+    const gemm_blocking blk = gemm_blocking_for(prec);
+    const long mtiles = (m + blk.mc - 1) / blk.mc, ntiles = (n + blk.nc - 1) / blk.nc;
+    const long tiles = mtiles * ntiles;
+    const int parts = static_cast<int>(tiles < num_threads ? tiles : num_threads.load());
+    std::atomic<long> next{0};
+
+    parallel_for(parts, parts, [&](int, long, long) {
+        // all the workspace of this thread; nothing below allocates
+        mpfr_vector pa(blk.mc * blk.kc, prec), pb(blk.kc * blk.nc, prec), acc(blk.mc * blk.nc, prec);
+        mpfr_ptr *const a = pa.data(), *const b = pb.data(), *const c = acc.data();
+        for (long t; (t = next++) < tiles;) {
+            const long ic = t % mtiles * blk.mc, jc = t / mtiles * blk.nc;
+            const long mc = m - ic < blk.mc ? m - ic : blk.mc, nc = n - jc < blk.nc ? n - jc : blk.nc;
+            const long ms = (mc + gemm_mr - 1) / gemm_mr, ns = (nc + gemm_nr - 1) / gemm_nr; // slivers
+            for (long i = 0; i < ms * ns * gemm_mr * gemm_nr; i++)
+                mpfr_set_zero(c[i], 1);
+            for (long pc = 0; pc < k; pc += blk.kc) {
+                const long kc = k - pc < blk.kc ? k - pc : blk.kc;
+                // pack op(B)(pc:pc+kc, jc:jc+nc) as kc x nr slivers, op(A)(ic:ic+mc, pc:pc+kc)
+                // as mr x kc slivers; the ragged edges are padded with zeros
+                for (long s = 0; s < ns; s++)
+                    for (long p = 0; p < kc; p++)
+                        for (long j = 0; j < gemm_nr; j++) {
+                            mpfr_ptr d = b[(s * kc + p) * gemm_nr + j];
+                            const long jj = jc + s * gemm_nr + j, pp = pc + p;
+                            if (jj < jc + nc)
+                                mpfr_set(d, B[tb ? jj + pp * ldb : pp + jj * ldb].get_mpfr_t(), rnd);
+                            else
+                                mpfr_set_zero(d, 1);
+                        }
+                for (long s = 0; s < ms; s++)
+                    for (long p = 0; p < kc; p++)
+                        for (long i = 0; i < gemm_mr; i++) {
+                            mpfr_ptr d = a[(s * kc + p) * gemm_mr + i];
+                            const long ii = ic + s * gemm_mr + i, pp = pc + p;
+                            if (ii < ic + mc)
+                                mpfr_set(d, A[ta ? pp + ii * lda : ii + pp * lda].get_mpfr_t(), rnd);
+                            else
+                                mpfr_set_zero(d, 1);
+                        }
+                // micro-kernel: an mr x nr block of accumulators, updated in place
+                for (long sj = 0; sj < ns; sj++)
+                    for (long si = 0; si < ms; si++) {
+                        mpfr_ptr const *r = c + (sj * ms + si) * gemm_mr * gemm_nr;
+                        mpfr_ptr const *x = a + si * kc * gemm_mr, *y = b + sj * kc * gemm_nr;
+                        for (long p = 0; p < kc; p++, x += gemm_mr, y += gemm_nr)
+                            for (long j = 0; j < gemm_nr; j++)
+                                for (long i = 0; i < gemm_mr; i++)
+                                    mpfr_fma(r[j * gemm_mr + i], x[i], y[j], r[j * gemm_mr + i], rnd);
+                    }
+            }
+            for (long j = 0; j < nc; j++)
+                for (long i = 0; i < mc; i++) {
+                    mpfr_ref r(c[((j / gemm_nr) * ms + i / gemm_mr) * gemm_mr * gemm_nr + (j % gemm_nr) * gemm_mr + i % gemm_mr]);
+                    scale_add(C[ic + i + (jc + j) * ldc], alpha, r, beta);
+                }
+        }
+    });
+}
+template <class A_, class B_> inline void gemm(const char transa, const char transb, const long m, const long n, const long k, const A_ &alpha, const mpfr_vector &A, const long lda, const mpfr_vector &B, const long ldb, const B_ &beta, mpfr_vector &C, const long ldc) {
+    const bool ta = is_trans(transa), tb = is_trans(transb);
+    check_ld("lda", lda, ta ? k : m);
+    check_ld("ldb", ldb, tb ? n : k);
+    check_ld("ldc", ldc, m);
+    check_sizes("A", A.size(), ta ? k : m, ta ? m : k, lda);
+    check_sizes("B", B.size(), tb ? n : k, tb ? k : n, ldb);
+    check_sizes("C", C.size(), m, n, ldc);
+    gemm(transa, transb, m, n, k, alpha, A.begin(), lda, B.begin(), ldb, beta, C.begin(), ldc);
+}
+
+} // namespace blas
+} // namespace mpfr
+
+#endif
@@ -26,41 +26,77 @@
  *
  */
 
+#ifndef _MPFR_CLASS_H_
+#define _MPFR_CLASS_H_
+
 #if __cplusplus < 201703L
 #error "This class only runs on C++ 17 and later"
 #endif
 
+// <mpfr.h> declares the _Float128 functions only when this comes first; if it was included
+// before, MPFR_WANT_FLOAT128 stays undefined and the _Float128 overloads are left out.
+#ifndef __MPFR_H
 #define MPFR_WANT_FLOAT128
+#endif
+// likewise for the intmax_t functions (pow_uj, pow_sj, pown), which are left out when
+// <mpfr.h> was included first without <cstdint>
+#ifndef __MPFR_H
+#define MPFR_USE_INTMAX_T
+#endif
 
+#include <cstdint>
 #include <mpfr.h>
 #include <iostream>
 #include <utility>
 #include <limits>
+#include <type_traits>
+#include <array>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <vector>
+#include "mpfr_stats.h"
+#include "mpfr_profile.h"
+#include "mpfr_allocator.h"
 
 #define ___MPFR_CLASS_EXPLICIT___ explicit
 
 namespace mpfr {
 
+// The defaults are the context of the calling thread: every thread starts with 512 bits,
+// MPFR_RNDN and base 10, and changing them (directly or through precision_scope) affects
+// that thread only. The exponent range is MPFR's own, which is per-thread as well when
+// MPFR is built with TLS support (mpfr_buildopt_tls_p()).
 class defaults {
   public:
-    static mpfr_prec_t prec;
-    static mpfr_rnd_t rnd;
-    static int base;
+    static inline thread_local mpfr_prec_t prec = 512;
+    static inline thread_local mpfr_rnd_t rnd = MPFR_RNDN;
+    static inline thread_local int base = 10;
     static mpfr_exp_t emin;
     static mpfr_exp_t emax;
 
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.1 Initialization Functions (part II)
     ////////////////////////////////////////////////////////////////////////////////////////
-    static inline mpfr_prec_t get_default_prec() { return mpfr_get_default_prec(); }
-    static inline void set_default_prec(const mpfr_prec_t prec) { mpfr_set_default_prec(prec); }
+    static inline mpfr_prec_t get_default_prec() { return prec; }
+    static inline void set_default_prec(const mpfr_prec_t _prec) {
+        prec = _prec;
+        mpfr_set_default_prec(_prec); // keep plain mpfr_init() in this thread in step
+    }
     static inline mpfr_prec_t get_default_base() { return base; }
     static inline void set_default_base(const int _base) { base = _base; }
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.11 Rounding-Related Functions (part II)
     ////////////////////////////////////////////////////////////////////////////////////////
-    static inline mpfr_rnd_t get_default_rounding_mode() { return mpfr_get_default_rounding_mode(); }
-    static inline void set_default_rounding_mode(const mpfr_rnd_t r = MPFR_RNDN) { mpfr_set_default_rounding_mode(r); }
+    static inline mpfr_rnd_t get_default_rounding_mode() { return rnd; }
+    static inline void set_default_rounding_mode(const mpfr_rnd_t r = MPFR_RNDN) {
+        rnd = r;
+        mpfr_set_default_rounding_mode(r);
+    }
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.13 Exception Related Functions (part II)
     ////////////////////////////////////////////////////////////////////////////////////////
@@ -74,113 +110,352 @@ class defaults {
     static inline mpfr_exp_t get_emax_max(void) { return mpfr_get_emax_max(); }
 };
 
+// Sets the precision and rounding mode of the calling thread for the lifetime of the
+// scope and restores the previous ones on exit:
+//     mpfr::precision_scope p(1024, MPFR_RNDZ);
+class precision_scope {
+  public:
+    explicit precision_scope(const mpfr_prec_t prec, const mpfr_rnd_t rnd = defaults::rnd) : saved_prec(defaults::prec), saved_rnd(defaults::rnd) {
+        defaults::set_default_prec(prec);
+        defaults::set_default_rounding_mode(rnd);
+    }
+    ~precision_scope() {
+        defaults::set_default_prec(saved_prec);
+        defaults::set_default_rounding_mode(saved_rnd);
+    }
+    precision_scope(const precision_scope &) = delete;
+    precision_scope &operator=(const precision_scope &) = delete;
+
+  private:
+    mpfr_prec_t saved_prec;
+    mpfr_rnd_t saved_rnd;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Expression templates
+// Binary operators on mpfr_class return mpfr_expr nodes which hold references to their
+// mpfr_class operands and are evaluated straight into the destination. a * b + c,
+// a * b - c, c + a * b, c - a * b, a * b + c * d and a * b - c * d are fused into single
+// mpfr_fma / mpfr_fms / mpfr_fmma / mpfr_fmms calls. Do not keep a node around with
+// auto; assign it to an mpfr_class.
+////////////////////////////////////////////////////////////////////////////////////////
+class mpfr_class;
+template <class Op, class L, class R> class mpfr_expr;
+
+// Scalars mixed into the arithmetic go to MPFR as the type it takes directly: floating point
+// as double, integers as long / unsigned long, mpz_t and mpq_t as mpz_srcptr / mpq_srcptr.
+// Integers wider than long keep converting to double as they always did.
+template <class T, class = void> struct mpfr_scalar {};
+template <class T> struct mpfr_scalar<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    using type = double;
+};
+template <class T> struct mpfr_scalar<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    using type = typename std::conditional<(sizeof(T) > sizeof(long)), double, typename std::conditional<std::is_signed<T>::value, long, unsigned long>::type>::type;
+};
+template <> struct mpfr_scalar<mpz_ptr> {
+    using type = mpz_srcptr;
+};
+template <> struct mpfr_scalar<mpz_srcptr> {
+    using type = mpz_srcptr;
+};
+template <> struct mpfr_scalar<mpq_ptr> {
+    using type = mpq_srcptr;
+};
+template <> struct mpfr_scalar<mpq_srcptr> {
+    using type = mpq_srcptr;
+};
+template <class T> using mpfr_scalar_t = typename mpfr_scalar<T>::type;
+template <class T, class = void> struct is_mpfr_scalar : std::false_type {};
+template <class T> struct is_mpfr_scalar<T, std::void_t<mpfr_scalar_t<T>>> : std::true_type {};
+
+// -(x) rounded with rnd equals x rounded with mpfr_expr_invert_rnd(rnd)
+inline mpfr_rnd_t mpfr_expr_invert_rnd(mpfr_rnd_t rnd) { return rnd == MPFR_RNDU ? MPFR_RNDD : (rnd == MPFR_RNDD ? MPFR_RNDU : rnd); }
+// MPFR has no z / x nor q / x; the integer is converted exactly and divided.
+inline int mpfr_z_div(mpfr_ptr rop, mpz_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) {
+    mpfr_t z;
+    mpfr_prec_t bits = static_cast<mpfr_prec_t>(mpz_sizeinbase(op1, 2));
+    mpfr_init2(z, bits < MPFR_PREC_MIN ? MPFR_PREC_MIN : bits);
+    mpfr_set_z(z, op1, MPFR_RNDN);
+    int inex = mpfr_div(rop, z, op2, rnd);
+    mpfr_clear(z);
+    return inex;
+}
+// n / d / x = n / (d * x), with d * x exact
+inline int mpfr_q_div(mpfr_ptr rop, mpq_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) {
+    mpfr_t t;
+    mpfr_init2(t, mpfr_get_prec(op2) + static_cast<mpfr_prec_t>(mpz_sizeinbase(mpq_denref(op1), 2)));
+    mpfr_mul_z(t, op2, mpq_denref(op1), MPFR_RNDN);
+    int inex = mpfr_z_div(rop, mpq_numref(op1), t, rnd);
+    mpfr_clear(t);
+    return inex;
+}
+
+struct mpfr_add_op {
+    static constexpr stats::op_kind kind = stats::add;
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_add(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, double op2, mpfr_rnd_t rnd) { return mpfr_add_d(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, double op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_add_d(rop, op2, op1, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) { return mpfr_add_si(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, long op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_add_si(rop, op2, op1, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, unsigned long op2, mpfr_rnd_t rnd) { return mpfr_add_ui(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, unsigned long op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_add_ui(rop, op2, op1, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpz_srcptr op2, mpfr_rnd_t rnd) { return mpfr_add_z(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpz_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_add_z(rop, op2, op1, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpq_srcptr op2, mpfr_rnd_t rnd) { return mpfr_add_q(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpq_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_add_q(rop, op2, op1, rnd); }
+};
+struct mpfr_sub_op {
+    static constexpr stats::op_kind kind = stats::sub;
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_sub(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, double op2, mpfr_rnd_t rnd) { return mpfr_sub_d(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, double op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_d_sub(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) { return mpfr_sub_si(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, long op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_si_sub(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, unsigned long op2, mpfr_rnd_t rnd) { return mpfr_sub_ui(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, unsigned long op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_ui_sub(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpz_srcptr op2, mpfr_rnd_t rnd) { return mpfr_sub_z(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpz_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_z_sub(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpq_srcptr op2, mpfr_rnd_t rnd) { return mpfr_sub_q(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpq_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) {
+        // q - x = -(x - q); negation is exact
+        int inex = mpfr_sub_q(rop, op2, op1, mpfr_expr_invert_rnd(rnd));
+        mpfr_neg(rop, rop, rnd);
+        return -inex;
+    }
+};
+struct mpfr_mul_op {
+    static constexpr stats::op_kind kind = stats::mul;
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_mul(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, double op2, mpfr_rnd_t rnd) { return mpfr_mul_d(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, double op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_mul_d(rop, op2, op1, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) { return mpfr_mul_si(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, long op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_mul_si(rop, op2, op1, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, unsigned long op2, mpfr_rnd_t rnd) { return mpfr_mul_ui(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, unsigned long op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_mul_ui(rop, op2, op1, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpz_srcptr op2, mpfr_rnd_t rnd) { return mpfr_mul_z(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpz_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_mul_z(rop, op2, op1, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpq_srcptr op2, mpfr_rnd_t rnd) { return mpfr_mul_q(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpq_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_mul_q(rop, op2, op1, rnd); }
+};
+struct mpfr_div_op {
+    static constexpr stats::op_kind kind = stats::div;
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_div(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, double op2, mpfr_rnd_t rnd) { return mpfr_div_d(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, double op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_d_div(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) { return mpfr_div_si(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, long op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_si_div(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, unsigned long op2, mpfr_rnd_t rnd) { return mpfr_div_ui(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, unsigned long op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_ui_div(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpz_srcptr op2, mpfr_rnd_t rnd) { return mpfr_div_z(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpz_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_z_div(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpfr_srcptr op1, mpq_srcptr op2, mpfr_rnd_t rnd) { return mpfr_div_q(rop, op1, op2, rnd); }
+    static int apply(mpfr_ptr rop, mpq_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) { return mpfr_q_div(rop, op1, op2, rnd); }
+};
+
+// Op::apply, the fused multiply-adds below and the compound assignments go through these,
+// which show the operands and the result to the precision profiler when it is compiled in.
+template <class Op, class A, class B> inline int mpfr_expr_apply(mpfr_ptr rop, const A op1, const B op2, mpfr_rnd_t rnd) {
+#ifdef MPFR_CLASS_PROFILE
+    const profile::detail::operand x = profile::detail::describe(op1), y = profile::detail::describe(op2);
+    const int inex = Op::apply(rop, op1, op2, rnd);
+    profile::detail::note(x, y, Op::kind == stats::add || Op::kind == stats::sub, rop);
+    return inex;
+#else
+    return Op::apply(rop, op1, op2, rnd);
+#endif
+}
+// rop = a * b + c, or a * b - c if Sub
+template <bool Sub> inline int mpfr_expr_fma_apply(mpfr_ptr rop, mpfr_srcptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_rnd_t rnd) {
+#ifdef MPFR_CLASS_PROFILE
+    const profile::detail::operand x = profile::detail::product(profile::detail::describe(a), profile::detail::describe(b)), y = profile::detail::describe(c);
+    const int inex = Sub ? mpfr_fms(rop, a, b, c, rnd) : mpfr_fma(rop, a, b, c, rnd);
+    profile::detail::note(x, y, true, rop);
+    return inex;
+#else
+    return Sub ? mpfr_fms(rop, a, b, c, rnd) : mpfr_fma(rop, a, b, c, rnd);
+#endif
+}
+// rop = a * b + c * d, or a * b - c * d if Sub
+template <bool Sub> inline int mpfr_expr_fmma_apply(mpfr_ptr rop, mpfr_srcptr a, mpfr_srcptr b, mpfr_srcptr c, mpfr_srcptr d, mpfr_rnd_t rnd) {
+#ifdef MPFR_CLASS_PROFILE
+    using profile::detail::describe;
+    const profile::detail::operand x = profile::detail::product(describe(a), describe(b)), y = profile::detail::product(describe(c), describe(d));
+    const int inex = Sub ? mpfr_fmms(rop, a, b, c, d, rnd) : mpfr_fmma(rop, a, b, c, d, rnd);
+    profile::detail::note(x, y, true, rop);
+    return inex;
+#else
+    return Sub ? mpfr_fmms(rop, a, b, c, d, rnd) : mpfr_fmma(rop, a, b, c, d, rnd);
+#endif
+}
+
+template <class T> struct is_mpfr_expr : std::false_type {};
+template <class Op, class L, class R> struct is_mpfr_expr<mpfr_expr<Op, L, R>> : std::true_type {};
+// leaves own an mpfr_t reachable through get_mpfr_t(): mpfr_class, mpfr_fixed<Bits>
+template <class T> struct is_mpfr_leaf : std::false_type {};
+template <> struct is_mpfr_leaf<mpfr_class> : std::true_type {};
+// mpfr valued operands: leaves and expression nodes, as opposed to scalars
+template <class T> struct is_mpfr_operand : std::integral_constant<bool, is_mpfr_leaf<T>::value || is_mpfr_expr<T>::value> {};
+template <class T, class S> using mpfr_enable_if_operand_scalar = typename std::enable_if<is_mpfr_operand<T>::value && is_mpfr_scalar<S>::value, int>::type;
+// a * b with both factors being leaves
+template <class T> struct is_mpfr_product : std::false_type {};
+template <class L, class R> struct is_mpfr_product<mpfr_expr<mpfr_mul_op, L, R>> : std::integral_constant<bool, is_mpfr_leaf<L>::value && is_mpfr_leaf<R>::value> {};
+// leaves are held by reference, sub-expressions and scalars by value
+template <class T, bool = is_mpfr_leaf<T>::value> struct mpfr_expr_operand {
+    using type = const T;
+};
+template <class T> struct mpfr_expr_operand<T, true> {
+    using type = const T &;
+};
+
 class mpfr_class {
   public:
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.1 Initialization Functions (part I)
     ////////////////////////////////////////////////////////////////////////////////////////
-    mpfr_class() { mpfr_init(value); }
-    ~mpfr_class() { mpfr_clear(value); }
-    void set_prec(const mpfr_prec_t prec) { mpfr_set_prec(value, prec); }
+    // No limbs are allocated until the object is first used, see materialize().
+    mpfr_class() noexcept { mpfr_custom_init_set(value, MPFR_NAN_KIND, 0, defaults::prec, nullptr); }
+    ~mpfr_class() {
+        if (has_limbs()) {
+            MPFR_CLASS_STATS_CLEAR(get_prec());
+            mpfr_clear(value);
+        }
+    }
+    void set_prec(const mpfr_prec_t prec) {
+        if (has_limbs()) {
+            MPFR_CLASS_STATS_REALLOC(get_prec(), prec);
+            mpfr_set_prec(value, prec);
+        } else {
+            init2(prec);
+        }
+    }
     mpfr_prec_t get_prec() const { return mpfr_get_prec(value); }
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.2 Assignment Functions
     ////////////////////////////////////////////////////////////////////////////////////////
-    mpfr_class(mpfr_class &&op) noexcept { mpfr_swap(value, op.value); }
+    mpfr_class(mpfr_class &&op) noexcept {
+        value[0] = op.value[0]; // take over the limbs of op and leave it without any
+        mpfr_custom_init_set(op.value, MPFR_NAN_KIND, 0, mpfr_get_prec(value), nullptr);
+    }
     mpfr_class(const mpfr_class &op) {
-        mpfr_init2(value, mpfr_get_prec(op.value));
+        if (!op.has_limbs()) { // copying an empty object costs nothing either
+            value[0] = op.value[0];
+            return;
+        }
+        init2(mpfr_get_prec(op.value));
         mpfr_set(value, op.value, defaults::rnd);
     }
+    // other leaves (mpfr_fixed<Bits>, elements of an mpfr_vector) are copied at their own precision
+    template <class T, typename std::enable_if<is_mpfr_leaf<T>::value && !std::is_same<T, mpfr_class>::value, int>::type = 0> mpfr_class(const T &op) {
+        init2(mpfr_get_prec(op.get_mpfr_t()));
+        mpfr_set(value, op.get_mpfr_t(), defaults::rnd);
+    }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const mpfr_t &op) {
         mpfr_prec_t _prec;
         _prec = mpfr_get_prec(op);
-        mpfr_init2(value, _prec);
+        init2(_prec);
         mpfr_set(value, op, defaults::rnd);
     }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const unsigned int op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_ui(value, (unsigned long int)op, defaults::rnd);
     }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const int op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_si(value, (long int)op, defaults::rnd);
     }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const unsigned long int op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_ui(value, op, defaults::rnd);
     }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const long int op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_si(value, op, defaults::rnd);
     }
     //    ___MPFR_CLASS_EXPLICIT___ mpfr_class(const uintmax_t op) noexcept {
-    //        mpfr_init(value);
+    //        mpfr_init2(value, defaults::prec);
     //        mpfr_set_uj(value, op, defaults::rnd);
     //    }
     //    ___MPFR_CLASS_EXPLICIT___ mpfr_class(const intmax_t op) noexcept {
-    //        mpfr_init(value);
+    //        mpfr_init2(value, defaults::prec);
     //        mpfr_set_sj(value, op, defaults::rnd);
     //    }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const float op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_flt(value, op, defaults::rnd);
     }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const double op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_d(value, op, defaults::rnd);
     }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const long double op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_ld(value, op, defaults::rnd);
     }
-    //    ___MPFR_CLASS_EXPLICIT___ mpfr_class(_Float128 op) noexcept {
-    //        mpfr_init(value);
-    //        mpfr_set_float128(value, op, defaults::rnd);
-    //    }
+#ifdef MPFR_WANT_FLOAT128
+    ___MPFR_CLASS_EXPLICIT___ mpfr_class(const _Float128 op) noexcept {
+        init2(defaults::prec);
+        mpfr_set_float128(value, op, defaults::rnd);
+    }
+#endif
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const mpz_t op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_z(value, op, defaults::rnd);
     }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const mpq_t op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_q(value, op, defaults::rnd);
     }
     ___MPFR_CLASS_EXPLICIT___ mpfr_class(const mpf_t op) noexcept {
-        mpfr_init(value);
+        init2(defaults::prec);
         mpfr_set_f(value, op, defaults::rnd);
     }
     mpfr_class(const char *s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) {
-        mpfr_init(value);
+        init2(defaults::prec);
         if (mpfr_set_str(value, s, base, rnd) != 0) {
             std::cerr << "Error initializing mpfr_t from const char*: " << s << std::endl;
             throw std::runtime_error("Failed to initialize mpfr_t with given string.");
         }
     }
     mpfr_class(const std::string &s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) {
-        mpfr_init(value);
+        init2(defaults::prec);
         if (mpfr_set_str(value, s.c_str(), base, rnd) != 0) {
             std::cerr << "Error initializing mpfr_t from std::string: " << s << std::endl;
             throw std::runtime_error("Failed to initialize mpfr_t with given string.");
         }
     }
+    // Expressions are evaluated straight into the new object at the default precision
+    template <class Op, class L, class R> mpfr_class(const mpfr_expr<Op, L, R> &e) {
+        init2(defaults::prec);
+        e.eval(value, defaults::rnd);
+    }
     // Initialization using assignment operator
+    // Which precision the destination ends up with depends on the source:
+    //   x = y;          an mpfr_class, copied or moved: x takes the precision of y
+    //   x = sqrt(y);    a function returns an mpfr_class at the default precision, and x takes it
+    //   x = y + z * w;  an expression is evaluated into x, which keeps its own precision (cf. gmpxx)
+    //   x = 0.5; x = "0.1";  scalars and strings are rounded to the precision x already has
+    // Wrap an expression as mpfr_class(y + z) to get the default precision instead.
     mpfr_class &operator=(mpfr_class op) noexcept { // Copy-and-Swap Idiom; it does both the copy assignment and the move assignment.
         mpfr_swap(value, op.value);
         return *this;
     }
+    template <class Op, class L, class R> mpfr_class &operator=(const mpfr_expr<Op, L, R> &e) {
+        e.eval(materialize(), defaults::rnd);
+        return *this;
+    }
     mpfr_class &operator=(double op) noexcept {
-        mpfr_set_d(value, op, defaults::rnd);
+        mpfr_set_d(materialize(), op, defaults::rnd);
         return *this;
     }
     mpfr_class &operator=(const char *s) {
-        if (mpfr_set_str(value, s, defaults::base, defaults::rnd) != 0) {
+        if (mpfr_set_str(materialize(), s, defaults::base, defaults::rnd) != 0) {
             std::cerr << "Error assigning mpfr_t from char:" << std::endl;
             throw std::runtime_error("Failed to initialize mpfr_t with given string.");
         }
         return *this;
     }
     mpfr_class &operator=(const std::string &s) {
-        if (mpfr_set_str(value, s.c_str(), defaults::base, defaults::rnd) != 0) {
+        if (mpfr_set_str(materialize(), s.c_str(), defaults::base, defaults::rnd) != 0) {
             std::cerr << "Error assigning mpfr_t from string: " << s << std::endl;
             throw std::runtime_error("Failed to initialize mpfr_t with given string.");
         }
@@ -248,74 +523,81 @@ class mpfr_class {
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.5 Arithmetic Functions
     ////////////////////////////////////////////////////////////////////////////////////////
-    mpfr_class operator+(const mpfr_class &rhs) const {
-        mpfr_class rop;
-        mpfr_add(rop.value, value, rhs.value, defaults::rnd);
-        return rop;
-    }
     mpfr_class &operator+=(const mpfr_class &rhs) {
-        mpfr_add(value, value, rhs.value, defaults::rnd);
+        MPFR_CLASS_STATS_OP(stats::add, get_prec());
+        mpfr_expr_apply<mpfr_add_op>(materialize(), value, rhs.get_mpfr_t(), defaults::rnd);
         return *this;
     }
-    mpfr_class operator*(const mpfr_class &rhs) const {
-        mpfr_class rop;
-        mpfr_mul(rop.value, this->value, rhs.value, defaults::rnd);
-        return rop;
-    }
     mpfr_class &operator*=(const mpfr_class &rhs) {
-        mpfr_mul(value, value, rhs.value, defaults::rnd);
+        MPFR_CLASS_STATS_OP(stats::mul, get_prec());
+        mpfr_expr_apply<mpfr_mul_op>(materialize(), value, rhs.get_mpfr_t(), defaults::rnd);
         return *this;
     }
-    mpfr_class operator-(const mpfr_class &rhs) const {
-        mpfr_class rop;
-        mpfr_sub(rop.value, this->value, rhs.value, defaults::rnd);
-        return rop;
-    }
     mpfr_class &operator-=(const mpfr_class &rhs) {
-        mpfr_sub(value, value, rhs.value, defaults::rnd);
+        MPFR_CLASS_STATS_OP(stats::sub, get_prec());
+        mpfr_expr_apply<mpfr_sub_op>(materialize(), value, rhs.get_mpfr_t(), defaults::rnd);
         return *this;
     }
-    mpfr_class operator/(const mpfr_class &rhs) const {
-        mpfr_class rop;
-        mpfr_div(rop.value, this->value, rhs.value, defaults::rnd);
-        return rop;
-    }
     mpfr_class &operator/=(const mpfr_class &rhs) {
-        mpfr_div(value, value, rhs.value, defaults::rnd);
+        MPFR_CLASS_STATS_OP(stats::div, get_prec());
+        mpfr_expr_apply<mpfr_div_op>(materialize(), value, rhs.get_mpfr_t(), defaults::rnd);
         return *this;
     }
-    mpfr_class &operator+=(double rhs) {
-        mpfr_add_d(this->value, this->value, rhs, defaults::rnd);
+    template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> mpfr_class &operator+=(const S rhs) {
+        MPFR_CLASS_STATS_OP(stats::add, get_prec());
+        mpfr_expr_apply<mpfr_add_op>(materialize(), value, mpfr_scalar_t<S>(rhs), defaults::rnd);
         return *this;
     }
-    mpfr_class &operator-=(double rhs) {
-        mpfr_sub_d(this->value, this->value, rhs, defaults::rnd);
+    template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> mpfr_class &operator-=(const S rhs) {
+        MPFR_CLASS_STATS_OP(stats::sub, get_prec());
+        mpfr_expr_apply<mpfr_sub_op>(materialize(), value, mpfr_scalar_t<S>(rhs), defaults::rnd);
         return *this;
     }
-    mpfr_class &operator*=(double rhs) {
-        mpfr_mul_d(this->value, this->value, rhs, defaults::rnd);
+    template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> mpfr_class &operator*=(const S rhs) {
+        MPFR_CLASS_STATS_OP(stats::mul, get_prec());
+        mpfr_expr_apply<mpfr_mul_op>(materialize(), value, mpfr_scalar_t<S>(rhs), defaults::rnd);
         return *this;
     }
-    mpfr_class &operator/=(double rhs) {
-        mpfr_div_d(this->value, this->value, rhs, defaults::rnd);
+    template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> mpfr_class &operator/=(const S rhs) {
+        MPFR_CLASS_STATS_OP(stats::div, get_prec());
+        mpfr_expr_apply<mpfr_div_op>(materialize(), value, mpfr_scalar_t<S>(rhs), defaults::rnd);
+        return *this;
+    }
+    // x += a * b and x -= a * b end up in mpfr_fma / mpfr_fms, see mpfr_expr below.
+    template <class Op, class L, class R> mpfr_class &operator+=(const mpfr_expr<Op, L, R> &rhs) {
+        (*this + rhs).eval(materialize(), defaults::rnd);
+        return *this;
+    }
+    template <class Op, class L, class R> mpfr_class &operator-=(const mpfr_expr<Op, L, R> &rhs) {
+        (*this - rhs).eval(materialize(), defaults::rnd);
+        return *this;
+    }
+    template <class Op, class L, class R> mpfr_class &operator*=(const mpfr_expr<Op, L, R> &rhs) {
+        (*this * rhs).eval(materialize(), defaults::rnd);
+        return *this;
+    }
+    template <class Op, class L, class R> mpfr_class &operator/=(const mpfr_expr<Op, L, R> &rhs) {
+        (*this / rhs).eval(materialize(), defaults::rnd);
         return *this;
     }
-    friend mpfr_class operator+(const mpfr_class &lhs, const double rhs);
-    friend mpfr_class operator+(const double lhs, const mpfr_class &rhs);
-    friend mpfr_class operator-(const mpfr_class &lhs, const double rhs);
-    friend mpfr_class operator-(const double lhs, const mpfr_class &rhs);
-    friend mpfr_class operator*(const mpfr_class &lhs, const double rhs);
-    friend mpfr_class operator*(const double lhs, const mpfr_class &rhs);
-    friend mpfr_class operator/(const mpfr_class &lhs, double rhs);
-    friend mpfr_class operator/(const double lhs, const mpfr_class &rhs);
+
+    template <class Op, class L, class R> friend mpfr_class mpfr_expr_reuse(mpfr_class &&rop, const L &lhs, const R &rhs);
+    friend class mpfr_literal_cache;
 
     friend mpfr_class sqrt(const mpfr_class &a, mpfr_rnd_t rnd);
+    friend mpfr_class sqrt(mpfr_class &&a, mpfr_rnd_t rnd);
     friend mpfr_class neg(const mpfr_class &a, mpfr_rnd_t rnd);
+    friend mpfr_class neg(mpfr_class &&a, mpfr_rnd_t rnd);
     friend mpfr_class abs(const mpfr_class &a, mpfr_rnd_t rnd);
+    friend mpfr_class abs(mpfr_class &&a, mpfr_rnd_t rnd);
     friend mpfr_class mul_2ui(const mpfr_class &op1, unsigned long int op2, mpfr_rnd_t rnd);
+    friend mpfr_class mul_2ui(mpfr_class &&op1, unsigned long int op2, mpfr_rnd_t rnd);
     friend mpfr_class mul_2si(const mpfr_class &op1, long int op2, mpfr_rnd_t rnd);
+    friend mpfr_class mul_2si(mpfr_class &&op1, long int op2, mpfr_rnd_t rnd);
     friend mpfr_class div_2ui(const mpfr_class &op1, unsigned long int op2, mpfr_rnd_t rnd);
+    friend mpfr_class div_2ui(mpfr_class &&op1, unsigned long int op2, mpfr_rnd_t rnd);
     friend mpfr_class div_2si(const mpfr_class &op1, long int op2, mpfr_rnd_t rnd);
+    friend mpfr_class div_2si(mpfr_class &&op1, long int op2, mpfr_rnd_t rnd);
     // int mpfr_add (mpfr_t rop, mpfr_t op1, mpfr_t op2, mpfr_rnd_t rnd)
     // int mpfr_add_ui (mpfr_t rop, mpfr_t op1, unsigned long int op2, mpfr_rnd_t rnd)
     // int mpfr_add_si (mpfr_t rop, mpfr_t op1, long int op2, mpfr_rnd_t rnd)
@@ -368,19 +650,19 @@ class mpfr_class {
     // int mpfr_fmma (mpfr_t rop, mpfr_t op1, mpfr_t op2, mpfr_t op3, mpfr_t op4, mpfr_rnd_t rnd)
     // int mpfr_fmms (mpfr_t rop, mpfr_t op1, mpfr_t op2, mpfr_t op3, mpfr_t op4, mpfr_rnd_t rnd)
     // int mpfr_hypot (mpfr_t rop, mpfr_t x, mpfr_t y, mpfr_rnd_t rnd)
-    // int mpfr_sum (mpfr_t rop, const mpfr_ptr tab[], unsigned long int n, mpfr_rnd_t rnd)
+    // int mpfr_sum (mpfr_t rop, const mpfr_ptr tab[], unsigned long int n, mpfr_rnd_t rnd): mpfr::sum in mpfr_reduce.h
     // int mpfr_dot (mpfr_t rop, const mpfr_ptr a[], const mpfr_ptr b[], unsigned long int n, mpfr_rnd_t rnd)
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.6 Comparison Functions
     ////////////////////////////////////////////////////////////////////////////////////////
-    friend inline bool operator==(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_equal_p(op1.value, op2.value) != 0; }
-    friend inline bool operator!=(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_lessgreater_p(op1.value, op2.value) != 0; }
-    friend inline bool operator<(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_less_p(op1.value, op2.value) != 0; }
-    friend inline bool operator>(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_greater_p(op1.value, op2.value) != 0; }
-    friend inline bool operator<=(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_lessequal_p(op1.value, op2.value) != 0; }
-    friend inline bool operator>=(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_greaterequal_p(op1.value, op2.value) != 0; }
-    bool is_nan() const { return mpfr_nan_p(value) != 0; }
-    bool is_inf() const { return mpfr_inf_p(value) != 0; }
+    friend inline bool operator==(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_equal_p(op1.get_mpfr_t(), op2.get_mpfr_t()) != 0; }
+    friend inline bool operator!=(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_lessgreater_p(op1.get_mpfr_t(), op2.get_mpfr_t()) != 0; }
+    friend inline bool operator<(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_less_p(op1.get_mpfr_t(), op2.get_mpfr_t()) != 0; }
+    friend inline bool operator>(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_greater_p(op1.get_mpfr_t(), op2.get_mpfr_t()) != 0; }
+    friend inline bool operator<=(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_lessequal_p(op1.get_mpfr_t(), op2.get_mpfr_t()) != 0; }
+    friend inline bool operator>=(const mpfr_class &op1, const mpfr_class &op2) { return mpfr_greaterequal_p(op1.get_mpfr_t(), op2.get_mpfr_t()) != 0; }
+    bool is_nan() const { return mpfr_nan_p(get_mpfr_t()) != 0; }
+    bool is_inf() const { return mpfr_inf_p(get_mpfr_t()) != 0; }
     // int mpfr_cmp (mpfr_t op1, mpfr_t op2)
     // int mpfr_cmp_ui (mpfr_t op1, unsigned long int op2)
     // int mpfr_cmp_si (mpfr_t op1, long int op2)
@@ -410,82 +692,156 @@ class mpfr_class {
     // 5.7 Transcendental Functions
     ////////////////////////////////////////////////////////////////////////////////////////
     friend mpfr_class log(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class log(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class log_ui(unsigned long int op, mpfr_rnd_t rnd);
     friend mpfr_class log2(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class log2(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class log10(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class log10(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class log1p(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class log1p(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class log2p1(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class log2p1(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class log10p1(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class log10p1(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class exp(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class exp(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class exp2(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class exp2(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class exp10(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class exp10(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class expm1(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class expm1(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class exp2m1(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class exp2m1(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class exp10m1(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class exp10m1(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class pow(const mpfr_class &op1, const mpfr_class &op2, mpfr_rnd_t rnd);
+    friend mpfr_class pow(mpfr_class &&op1, const mpfr_class &op2, mpfr_rnd_t rnd);
     friend mpfr_class powr(const mpfr_class &op1, const mpfr_class &op2, mpfr_rnd_t rnd);
+    friend mpfr_class powr(mpfr_class &&op1, const mpfr_class &op2, mpfr_rnd_t rnd);
     friend mpfr_class pow_ui(const mpfr_class &op1, unsigned long int op2, mpfr_rnd_t rnd);
+    friend mpfr_class pow_ui(mpfr_class &&op1, unsigned long int op2, mpfr_rnd_t rnd);
     friend mpfr_class pow_si(const mpfr_class &op1, long int op2, mpfr_rnd_t rnd);
+    friend mpfr_class pow_si(mpfr_class &&op1, long int op2, mpfr_rnd_t rnd);
+#ifdef _MPFR_H_HAVE_INTMAX_T
     friend mpfr_class pow_uj(const mpfr_class &op1, uintmax_t op2, mpfr_rnd_t rnd);
+    friend mpfr_class pow_uj(mpfr_class &&op1, uintmax_t op2, mpfr_rnd_t rnd);
     friend mpfr_class pow_sj(const mpfr_class &op1, intmax_t op2, mpfr_rnd_t rnd);
+    friend mpfr_class pow_sj(mpfr_class &&op1, intmax_t op2, mpfr_rnd_t rnd);
     friend mpfr_class pown(const mpfr_class &op1, intmax_t n, mpfr_rnd_t rnd);
+    friend mpfr_class pown(mpfr_class &&op1, intmax_t n, mpfr_rnd_t rnd);
+#endif
     friend mpfr_class pow_z(const mpfr_class &op1, const mpz_t op2, mpfr_rnd_t rnd);
+    friend mpfr_class pow_z(mpfr_class &&op1, const mpz_t op2, mpfr_rnd_t rnd);
     friend mpfr_class ui_pow_ui(unsigned long int op1, unsigned long int op2, mpfr_rnd_t rnd);
     friend mpfr_class ui_pow(unsigned long int op1, const mpfr_class &op2, mpfr_rnd_t rnd);
+    friend mpfr_class ui_pow(unsigned long int op1, mpfr_class &&op2, mpfr_rnd_t rnd);
     friend mpfr_class cos(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class cos(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class sin(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class sin(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class tan(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class tan(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class cosu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd);
+    friend mpfr_class cosu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd);
     friend mpfr_class sinu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd);
+    friend mpfr_class sinu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd);
     friend mpfr_class tanu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd);
+    friend mpfr_class tanu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd);
     friend mpfr_class cospi(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class cospi(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class sinpi(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class sinpi(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class tanpi(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class tanpi(mpfr_class &&op, mpfr_rnd_t rnd);
     friend void sin_cos(mpfr_class &sop, mpfr_class &cop, const mpfr_class &op, mpfr_rnd_t rnd);
     friend mpfr_class sec(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class sec(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class csc(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class csc(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class cot(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class cot(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class acos(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class acos(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class asin(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class asin(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class acosu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd);
+    friend mpfr_class acosu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd);
     friend mpfr_class asinu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd);
+    friend mpfr_class asinu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd);
     friend mpfr_class atanu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd);
+    friend mpfr_class atanu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd);
     friend mpfr_class acospi(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class acospi(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class asinpi(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class asinpi(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class atanpi(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class atanpi(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class atan2(const mpfr_class &y, const mpfr_class &x, mpfr_rnd_t rnd);
+    friend mpfr_class atan2(mpfr_class &&y, const mpfr_class &x, mpfr_rnd_t rnd);
     friend mpfr_class atan2u(const mpfr_class &y, const mpfr_class &x, unsigned long int u, mpfr_rnd_t rnd);
+    friend mpfr_class atan2u(mpfr_class &&y, const mpfr_class &x, unsigned long int u, mpfr_rnd_t rnd);
     friend mpfr_class atan2pi(const mpfr_class &y, const mpfr_class &x, mpfr_rnd_t rnd);
+    friend mpfr_class atan2pi(mpfr_class &&y, const mpfr_class &x, mpfr_rnd_t rnd);
     friend mpfr_class cosh(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class cosh(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class sinh(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class sinh(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class tanh(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class tanh(mpfr_class &&op, mpfr_rnd_t rnd);
     friend void sinh_cosh(mpfr_class &sop, mpfr_class &cop, const mpfr_class &op, mpfr_rnd_t rnd);
     friend mpfr_class sech(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class sech(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class csch(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class csch(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class coth(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class coth(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class acosh(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class acosh(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class asinh(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class asinh(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class atanh(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class atanh(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class eint(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class eint(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class li2(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class li2(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class gamma(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class gamma(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class gamma_inc(const mpfr_class &op, const mpfr_class &op2, mpfr_rnd_t rnd);
+    friend mpfr_class gamma_inc(mpfr_class &&op, const mpfr_class &op2, mpfr_rnd_t rnd);
     friend mpfr_class lngamma(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class lngamma(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class lgamma(const mpfr_class &op, int &signp, mpfr_rnd_t rnd);
+    friend mpfr_class lgamma(mpfr_class &&op, int &signp, mpfr_rnd_t rnd);
     friend mpfr_class digamma(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class digamma(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class beta(const mpfr_class &op1, const mpfr_class &op2, mpfr_rnd_t rnd);
+    friend mpfr_class beta(mpfr_class &&op1, const mpfr_class &op2, mpfr_rnd_t rnd);
     friend mpfr_class zeta(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class zeta(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class zeta_ui(unsigned long int op, mpfr_rnd_t rnd);
     friend mpfr_class erf(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class erf(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class erfc(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class erfc(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class j0(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class j0(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class j1(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class j1(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class jn(long int n, const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class jn(long int n, mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class y0(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class y0(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class y1(const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class y1(mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class yn(long int n, const mpfr_class &op, mpfr_rnd_t rnd);
+    friend mpfr_class yn(long int n, mpfr_class &&op, mpfr_rnd_t rnd);
     friend mpfr_class agm(const mpfr_class &op1, const mpfr_class &op2, mpfr_rnd_t rnd);
+    friend mpfr_class agm(mpfr_class &&op1, const mpfr_class &op2, mpfr_rnd_t rnd);
     friend mpfr_class ai(const mpfr_class &x, mpfr_rnd_t rnd);
+    friend mpfr_class ai(mpfr_class &&x, mpfr_rnd_t rnd);
     friend mpfr_class const_log2(mpfr_rnd_t rnd);
     friend mpfr_class const_pi(mpfr_rnd_t rnd);
     friend mpfr_class const_euler(mpfr_rnd_t rnd);
@@ -552,504 +908,1706 @@ class mpfr_class {
     // int mpfr_buildopt_gmpinternals_p (void)
     // int mpfr_buildopt_sharedcache_p (void)
     // const char * mpfr_buildopt_tune_case (void)
+    // an object without limbs reads as a NaN header, as MPFR never reads the significand of
+    // a NaN; so reading allocates nothing and concurrent readers of a shared object are safe
     mpfr_srcptr get_mpfr_t() const { return value; }
+    mpfr_ptr get_mpfr_t() { return materialize(); } // for calling MPFR directly
 
   private:
-    mpfr_t value;
+    mutable mpfr_t value;
+    bool has_limbs() const { return mpfr_custom_get_significand(value) != nullptr; }
+    // Default-constructed and moved-from objects own no limbs; they read as NaN and get their
+    // limbs, at the precision they were created with, the first time they are written.
+    mpfr_ptr materialize() const {
+        if (!has_limbs())
+            init2(mpfr_get_prec(value));
+        return value;
+    }
+    void init2(const mpfr_prec_t prec) const {
+        mpfr_init2(value, prec);
+        MPFR_CLASS_STATS_INIT(prec);
+    }
 };
 
-std::ostream &operator<<(std::ostream &os, const mpfr_class &m) {
-    std::streamsize prec = os.precision();
-    std::ios_base::fmtflags flags = os.flags();
+////////////////////////////////////////////////////////////////////////////////////////
+// to_chars writes x into [first, last) without allocating, as std::to_chars does for
+// double: what mpfr_printf writes for %.*Re, %.*Rf and %.*Rg (round to nearest, the
+// sign of zeros and NaNs, "inf", "nan", two exponent digits at least), or, without a
+// format, the shortest scientific form which reads back to x in its precision,
+// mpfr_get_str_ndigits(10, prec) digits. A buffer of to_chars_size() bytes is always
+// large enough; a smaller one may give std::errc::value_too_large.
+// The digits come from mpfr_get_str into a per-thread scratch buffer that is kept.
+////////////////////////////////////////////////////////////////////////////////////////
+enum class chars_format { scientific, fixed, general };
+
+inline char *mpfr_chars_scratch(const size_t bytes) {
+    static thread_local std::vector<char> scratch;
+    if (scratch.size() < bytes)
+        scratch.resize(bytes);
+    return scratch.data();
+}
+// the n leading decimal digits of |x|, x regular, with |x| ~ 0.d1d2...dn * 10^exp10
+inline const char *mpfr_chars_digits(mpfr_srcptr x, const size_t n, mpfr_exp_t &exp10, const mpfr_rnd_t rnd) {
+    mpfr_t ax; // |x| on the limbs of x, so that no sign is written
+    mpfr_custom_init_set(ax, MPFR_REGULAR_KIND, mpfr_get_exp(x), mpfr_get_prec(x), mpfr_custom_get_significand(x));
+    char *digits = mpfr_chars_scratch(n + 2);
+    mpfr_get_str(digits, &exp10, 10, n, ax, rnd);
+    return digits;
+}
+inline size_t to_chars_size(mpfr_srcptr x, const chars_format fmt, int precision) {
+    if (precision < 0)
+        precision = 6;
+    if (!mpfr_number_p(x))
+        return 4;
+    if (fmt != chars_format::fixed || mpfr_zero_p(x))
+        return static_cast<size_t>(precision) + 32; // digits, sign, point and exponent
+    // 10^X <= |x| < 2^e, so X < e * log10(2) < e * 0.30103
+    const mpfr_exp_t e = mpfr_get_exp(x);
+    return static_cast<size_t>(precision) + static_cast<size_t>(e > 0 ? e / 3 : 0) + 8;
+}
+inline size_t to_chars_size(mpfr_srcptr x) { return static_cast<size_t>(mpfr_get_str_ndigits(10, mpfr_get_prec(x))) + 32; }
+
+inline std::to_chars_result to_chars(char *first, char *last, mpfr_srcptr x, const chars_format fmt, int precision) {
+    if (precision < 0)
+        precision = 6; // as printf
+    const std::to_chars_result overflow = {last, std::errc::value_too_large};
+    char *p = first;
+    auto put = [&](const char c) {
+        if (p == last)
+            return false;
+        *p++ = c;
+        return true;
+    };
+    auto put_n = [&](const char *s, const size_t n) {
+        if (static_cast<size_t>(last - p) < n)
+            return false;
+        p = std::copy(s, s + n, p);
+        return true;
+    };
+    auto put_zeros = [&](const size_t n) {
+        if (static_cast<size_t>(last - p) < n)
+            return false;
+        p = std::fill_n(p, n, '0');
+        return true;
+    };
+    // d[0] '.' d[1..n) 'e' X
+    auto put_scientific = [&](const char *d, const size_t n, const mpfr_exp_t exponent) {
+        if (!put(d[0]) || (n > 1 && (!put('.') || !put_n(d + 1, n - 1))) || !put('e') || !put(exponent < 0 ? '-' : '+'))
+            return false;
+        char e[24];
+        const std::to_chars_result r = std::to_chars(e, e + sizeof(e), exponent < 0 ? -exponent : exponent);
+        return (r.ptr - e > 1 || put('0')) && put_n(e, r.ptr - e);
+    };
+    // 0.d[0..n) * 10^exponent with `decimals` digits after the point, the digits past n
+    // being zeros
+    auto put_fixed = [&](const char *d, const size_t n, const mpfr_exp_t exponent, const size_t decimals) {
+        auto digits = [&](const mpfr_exp_t from, const mpfr_exp_t to) { // d[from..to), from >= 0
+            if (to <= from)
+                return true;
+            const mpfr_exp_t have = std::min<mpfr_exp_t>(to, static_cast<mpfr_exp_t>(n));
+            return (have <= from || put_n(d + from, have - from)) && put_zeros(to - std::max(from, have));
+        };
+        if (!(exponent > 0 ? digits(0, exponent) : put('0')))
+            return false;
+        if (decimals == 0)
+            return true;
+        const size_t leading = exponent < 0 ? std::min<size_t>(-exponent, decimals) : 0;
+        return put('.') && put_zeros(leading) && digits(std::max<mpfr_exp_t>(exponent, 0), exponent + static_cast<mpfr_exp_t>(decimals));
+    };
 
-    char *str = nullptr;
-    if (flags & std::ios::scientific) {
-        mpfr_asprintf(&str, "%.*Re", static_cast<int>(prec), m.value);
-    } else if (flags & std::ios::fixed) {
-        mpfr_asprintf(&str, "%.*Rf", static_cast<int>(prec), m.value);
+    if (mpfr_signbit(x) && !put('-'))
+        return overflow;
+    if (mpfr_nan_p(x))
+        return put_n("nan", 3) ? std::to_chars_result{p, std::errc()} : overflow;
+    if (mpfr_inf_p(x))
+        return put_n("inf", 3) ? std::to_chars_result{p, std::errc()} : overflow;
+    const size_t prec = static_cast<size_t>(precision);
+    bool ok = true;
+    mpfr_exp_t e;
+    if (mpfr_zero_p(x)) {
+        switch (fmt) {
+        case chars_format::scientific:
+            ok = put('0') && (prec == 0 || (put('.') && put_zeros(prec))) && put_n("e+00", 4);
+            break;
+        case chars_format::fixed:
+            ok = put('0') && (prec == 0 || (put('.') && put_zeros(prec)));
+            break;
+        case chars_format::general:
+            ok = put('0');
+            break;
+        }
+    } else if (fmt == chars_format::scientific) {
+        const char *d = mpfr_chars_digits(x, prec + 1, e, MPFR_RNDN);
+        ok = put_scientific(d, prec + 1, e - 1);
+    } else if (fmt == chars_format::general) {
+        // P significant digits; fixed notation if the exponent X is in [-4, P), with the
+        // trailing zeros removed
+        const size_t digits = prec == 0 ? 1 : prec;
+        const char *d = mpfr_chars_digits(x, digits, e, MPFR_RNDN);
+        size_t n = digits;
+        while (n > 1 && d[n - 1] == '0')
+            n--;
+        const mpfr_exp_t exponent = e - 1;
+        if (exponent >= -4 && exponent < static_cast<mpfr_exp_t>(digits))
+            ok = put_fixed(d, n, e, static_cast<mpfr_exp_t>(n) > e ? n - e : 0);
+        else
+            ok = put_scientific(d, n, exponent);
     } else {
-        mpfr_asprintf(&str, "%.*Rg", static_cast<int>(prec), m.value);
+        // the exponent of the leading digit, exact, decides how many digits there are
+        mpfr_exp_t e0;
+        const char lead = mpfr_chars_digits(x, 1, e0, MPFR_RNDZ)[0];
+        const mpfr_exp_t n = e0 + static_cast<mpfr_exp_t>(prec);
+        if (n > 0) {
+            const char *d = mpfr_chars_digits(x, n, e, MPFR_RNDN);
+            ok = put_fixed(d, n, e, prec); // e == e0 + 1 when rounding carried into a new digit
+        } else {
+            // nothing but the rounding of the leading digit is left: up past half an
+            // ulp, and at exactly 0.5 to even, that is 0
+            const bool up = n == 0 && (lead > '5' || (lead == '5' && !(mpfr_cmp_ui_2exp(x, 1, -1) == 0 || mpfr_cmp_si_2exp(x, -1, -1) == 0)));
+            if (up)
+                ok = put_fixed("1", 1, 1 - static_cast<mpfr_exp_t>(prec), prec);
+            else
+                ok = put('0') && (prec == 0 || (put('.') && put_zeros(prec)));
+        }
     }
-    os << str;
-    mpfr_free_str(str);
-
-    return os;
-}
-inline mpfr_class operator+(const mpfr_class &lhs, const double rhs) {
-    mpfr_class result(lhs);
-    result += rhs;
-    return result;
+    return ok ? std::to_chars_result{p, std::errc()} : overflow;
 }
-inline mpfr_class operator+(const double lhs, const mpfr_class &rhs) {
-    mpfr_class result(rhs);
-    result += lhs;
-    return result;
+inline std::to_chars_result to_chars(char *first, char *last, mpfr_srcptr x) {
+    const size_t digits = static_cast<size_t>(mpfr_get_str_ndigits(10, mpfr_get_prec(x)));
+    return to_chars(first, last, x, chars_format::scientific, static_cast<int>(digits - 1));
 }
-inline mpfr_class operator-(const mpfr_class &lhs, const double rhs) {
-    mpfr_class result(lhs);
-    result -= rhs;
-    return result;
-}
-inline mpfr_class operator-(const double lhs, const mpfr_class &rhs) {
-    mpfr_class result;
-    mpfr_d_sub(result.value, lhs, rhs.value, defaults::rnd);
-    return result;
-}
-inline mpfr_class operator*(const mpfr_class &lhs, const double rhs) {
-    mpfr_class result(lhs);
-    result *= rhs;
-    return result;
-}
-inline mpfr_class operator*(const double lhs, const mpfr_class &rhs) {
-    mpfr_class result(rhs);
-    result *= lhs;
-    return result;
+
+// the format of a stream: std::scientific, std::fixed or, with neither, general
+inline chars_format mpfr_chars_format(const std::ios_base &s) {
+    const std::ios_base::fmtflags flags = s.flags();
+    return (flags & std::ios::scientific) ? chars_format::scientific : (flags & std::ios::fixed) ? chars_format::fixed : chars_format::general;
+}
+inline std::ostream &mpfr_write(std::ostream &os, mpfr_srcptr op) {
+    const chars_format fmt = mpfr_chars_format(os);
+    const int prec = static_cast<int>(os.precision());
+
+    static thread_local std::vector<char> buffer;
+    const size_t size = to_chars_size(op, fmt, prec);
+    if (buffer.size() < size)
+        buffer.resize(size);
+    const std::to_chars_result r = to_chars(buffer.data(), buffer.data() + size, op, fmt, prec);
+    return os << std::string_view(buffer.data(), r.ptr - buffer.data());
+}
+inline std::ostream &operator<<(std::ostream &os, const mpfr_class &m) { return mpfr_write(os, m.get_mpfr_t()); }
+template <class T, typename std::enable_if<is_mpfr_leaf<T>::value, int>::type = 0> inline mpfr_srcptr mpfr_expr_leaf(const T &op) { return op.get_mpfr_t(); }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline S mpfr_expr_leaf(const S op) { return op; }
+template <class T, typename std::enable_if<is_mpfr_leaf<T>::value, int>::type = 0> inline bool mpfr_expr_aliases(const T &op, mpfr_srcptr p) { return op.get_mpfr_t() == p; }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline bool mpfr_expr_aliases(const S, mpfr_srcptr) { return false; }
+template <class Op, class L, class R> inline bool mpfr_expr_aliases(const mpfr_expr<Op, L, R> &e, mpfr_srcptr p) { return e.aliases(p); }
+
+// A sub-expression which cannot be evaluated into the destination goes to a temporary.
+// Up to MPFR_EXPR_TEMP_LIMBS limbs the significand lives on the stack (mpfr_custom_*).
+#ifndef MPFR_EXPR_TEMP_LIMBS
+#define MPFR_EXPR_TEMP_LIMBS (4096 / GMP_NUMB_BITS)
+#endif
+template <class E> class mpfr_expr_temp {
+  public:
+    mpfr_expr_temp(const E &e, mpfr_prec_t prec, mpfr_rnd_t rnd) {
+        on_heap = mpfr_custom_get_size(prec) > sizeof(limbs);
+        MPFR_CLASS_STATS_TEMPORARY(prec, on_heap);
+        if (on_heap) {
+            mpfr_init2(tmp, prec);
+        } else {
+            mpfr_custom_init(limbs, prec);
+            mpfr_custom_init_set(tmp, MPFR_NAN_KIND, 0, prec, limbs);
+        }
+        e.eval(tmp, rnd);
+    }
+    ~mpfr_expr_temp() {
+        if (on_heap) {
+            MPFR_CLASS_STATS_TEMPORARY_FREED(mpfr_get_prec(tmp));
+            mpfr_clear(tmp);
+        }
+    }
+    mpfr_expr_temp(const mpfr_expr_temp &) = delete;
+    mpfr_expr_temp &operator=(const mpfr_expr_temp &) = delete;
+    mpfr_srcptr get() const { return tmp; }
+
+  private:
+    mpfr_t tmp;
+    bool on_heap;
+    mp_limb_t limbs[MPFR_EXPR_TEMP_LIMBS];
+};
+
+// rop = a * b + c, or rop = a * b - c if Sub; an expression c is rounded in c_rnd
+template <bool Sub, class C> inline void mpfr_expr_fma(mpfr_ptr rop, mpfr_srcptr a, mpfr_srcptr b, const C &c, mpfr_rnd_t rnd, mpfr_rnd_t c_rnd) {
+    if constexpr (is_mpfr_expr<C>::value) {
+        if (a != rop && b != rop) {
+            c.eval(rop, c_rnd);
+            mpfr_expr_fma_apply<Sub>(rop, a, b, rop, rnd);
+        } else {
+            mpfr_expr_temp<C> t(c, mpfr_get_prec(rop), c_rnd);
+            mpfr_expr_fma_apply<Sub>(rop, a, b, t.get(), rnd);
+        }
+    } else {
+        mpfr_expr_fma_apply<Sub>(rop, a, b, c.get_mpfr_t(), rnd);
+    }
 }
-inline mpfr_class operator/(const mpfr_class &lhs, const double rhs) {
-    mpfr_class result(lhs);
-    result /= rhs;
-    return result;
+
+template <class Op, class L, class R> class mpfr_expr {
+  public:
+    mpfr_expr(const L &l, const R &r) : lhs(l), rhs(r) {}
+    bool aliases(mpfr_srcptr p) const { return mpfr_expr_aliases(lhs, p) || mpfr_expr_aliases(rhs, p); }
+    void eval(mpfr_ptr rop, mpfr_rnd_t rnd) const {
+        constexpr bool add = std::is_same<Op, mpfr_add_op>::value;
+        constexpr bool sub = std::is_same<Op, mpfr_sub_op>::value;
+        [[maybe_unused]] constexpr bool fused = (add || sub) && ((is_mpfr_product<L>::value && is_mpfr_operand<R>::value) || (is_mpfr_operand<L>::value && is_mpfr_product<R>::value));
+        MPFR_CLASS_STATS_OP(fused ? stats::fma : Op::kind, mpfr_get_prec(rop));
+        if constexpr ((add || sub) && is_mpfr_product<L>::value && is_mpfr_product<R>::value) {
+            mpfr_expr_fmma_apply<sub>(rop, lhs.lhs.get_mpfr_t(), lhs.rhs.get_mpfr_t(), rhs.lhs.get_mpfr_t(), rhs.rhs.get_mpfr_t(), rnd);
+        } else if constexpr ((add || sub) && is_mpfr_product<L>::value && is_mpfr_operand<R>::value) {
+            mpfr_expr_fma<sub>(rop, lhs.lhs.get_mpfr_t(), lhs.rhs.get_mpfr_t(), rhs, rnd, rnd);
+        } else if constexpr (add && is_mpfr_operand<L>::value && is_mpfr_product<R>::value) {
+            mpfr_expr_fma<false>(rop, rhs.lhs.get_mpfr_t(), rhs.rhs.get_mpfr_t(), lhs, rnd, rnd);
+        } else if constexpr (sub && is_mpfr_operand<L>::value && is_mpfr_product<R>::value) {
+            // c - a * b = -(a * b - c); negation is exact, and c itself is rounded in rnd
+            mpfr_expr_fma<true>(rop, rhs.lhs.get_mpfr_t(), rhs.rhs.get_mpfr_t(), lhs, mpfr_expr_invert_rnd(rnd), rnd);
+            mpfr_neg(rop, rop, rnd);
+        } else if constexpr (!is_mpfr_expr<L>::value && !is_mpfr_expr<R>::value) {
+            mpfr_expr_apply<Op>(rop, mpfr_expr_leaf(lhs), mpfr_expr_leaf(rhs), rnd);
+        } else if constexpr (!is_mpfr_expr<R>::value) {
+            if (!mpfr_expr_aliases(rhs, rop)) {
+                lhs.eval(rop, rnd);
+                mpfr_expr_apply<Op>(rop, rop, mpfr_expr_leaf(rhs), rnd);
+            } else {
+                mpfr_expr_temp<L> l(lhs, mpfr_get_prec(rop), rnd);
+                mpfr_expr_apply<Op>(rop, l.get(), mpfr_expr_leaf(rhs), rnd);
+            }
+        } else if constexpr (!is_mpfr_expr<L>::value) {
+            if (!mpfr_expr_aliases(lhs, rop)) {
+                rhs.eval(rop, rnd);
+                mpfr_expr_apply<Op>(rop, mpfr_expr_leaf(lhs), rop, rnd);
+            } else {
+                mpfr_expr_temp<R> r(rhs, mpfr_get_prec(rop), rnd);
+                mpfr_expr_apply<Op>(rop, mpfr_expr_leaf(lhs), r.get(), rnd);
+            }
+        } else {
+            if (!rhs.aliases(rop)) {
+                lhs.eval(rop, rnd);
+                mpfr_expr_temp<R> r(rhs, mpfr_get_prec(rop), rnd);
+                mpfr_expr_apply<Op>(rop, rop, r.get(), rnd);
+            } else {
+                mpfr_expr_temp<L> l(lhs, mpfr_get_prec(rop), rnd);
+                rhs.eval(rop, rnd);
+                mpfr_expr_apply<Op>(rop, l.get(), rop, rnd);
+            }
+        }
+    }
+    typename mpfr_expr_operand<L>::type lhs;
+    typename mpfr_expr_operand<R>::type rhs;
+};
+
+template <class L, class R> using mpfr_enable_if_operands = typename std::enable_if<is_mpfr_operand<L>::value && is_mpfr_operand<R>::value, int>::type;
+template <class T> using mpfr_enable_if_operand = typename std::enable_if<is_mpfr_operand<T>::value, int>::type;
+
+template <class L, class R, mpfr_enable_if_operands<L, R> = 0> inline mpfr_expr<mpfr_add_op, L, R> operator+(const L &lhs, const R &rhs) { return mpfr_expr<mpfr_add_op, L, R>(lhs, rhs); }
+template <class L, class R, mpfr_enable_if_operands<L, R> = 0> inline mpfr_expr<mpfr_sub_op, L, R> operator-(const L &lhs, const R &rhs) { return mpfr_expr<mpfr_sub_op, L, R>(lhs, rhs); }
+template <class L, class R, mpfr_enable_if_operands<L, R> = 0> inline mpfr_expr<mpfr_mul_op, L, R> operator*(const L &lhs, const R &rhs) { return mpfr_expr<mpfr_mul_op, L, R>(lhs, rhs); }
+template <class L, class R, mpfr_enable_if_operands<L, R> = 0> inline mpfr_expr<mpfr_div_op, L, R> operator/(const L &lhs, const R &rhs) { return mpfr_expr<mpfr_div_op, L, R>(lhs, rhs); }
+template <class L, class S, mpfr_enable_if_operand_scalar<L, S> = 0> inline mpfr_expr<mpfr_add_op, L, mpfr_scalar_t<S>> operator+(const L &lhs, const S rhs) { return mpfr_expr<mpfr_add_op, L, mpfr_scalar_t<S>>(lhs, rhs); }
+template <class S, class R, mpfr_enable_if_operand_scalar<R, S> = 0> inline mpfr_expr<mpfr_add_op, mpfr_scalar_t<S>, R> operator+(const S lhs, const R &rhs) { return mpfr_expr<mpfr_add_op, mpfr_scalar_t<S>, R>(lhs, rhs); }
+template <class L, class S, mpfr_enable_if_operand_scalar<L, S> = 0> inline mpfr_expr<mpfr_sub_op, L, mpfr_scalar_t<S>> operator-(const L &lhs, const S rhs) { return mpfr_expr<mpfr_sub_op, L, mpfr_scalar_t<S>>(lhs, rhs); }
+template <class S, class R, mpfr_enable_if_operand_scalar<R, S> = 0> inline mpfr_expr<mpfr_sub_op, mpfr_scalar_t<S>, R> operator-(const S lhs, const R &rhs) { return mpfr_expr<mpfr_sub_op, mpfr_scalar_t<S>, R>(lhs, rhs); }
+template <class L, class S, mpfr_enable_if_operand_scalar<L, S> = 0> inline mpfr_expr<mpfr_mul_op, L, mpfr_scalar_t<S>> operator*(const L &lhs, const S rhs) { return mpfr_expr<mpfr_mul_op, L, mpfr_scalar_t<S>>(lhs, rhs); }
+template <class S, class R, mpfr_enable_if_operand_scalar<R, S> = 0> inline mpfr_expr<mpfr_mul_op, mpfr_scalar_t<S>, R> operator*(const S lhs, const R &rhs) { return mpfr_expr<mpfr_mul_op, mpfr_scalar_t<S>, R>(lhs, rhs); }
+template <class L, class S, mpfr_enable_if_operand_scalar<L, S> = 0> inline mpfr_expr<mpfr_div_op, L, mpfr_scalar_t<S>> operator/(const L &lhs, const S rhs) { return mpfr_expr<mpfr_div_op, L, mpfr_scalar_t<S>>(lhs, rhs); }
+template <class S, class R, mpfr_enable_if_operand_scalar<R, S> = 0> inline mpfr_expr<mpfr_div_op, mpfr_scalar_t<S>, R> operator/(const S lhs, const R &rhs) { return mpfr_expr<mpfr_div_op, mpfr_scalar_t<S>, R>(lhs, rhs); }
+
+// An expiring mpfr_class operand is used as the destination and moved out as the result,
+// so chains such as (a + b) * sqrt(c) / d allocate once. Only one at the default precision
+// is reused, here and in the functions below, so that the precision of a result does not
+// depend on whether an operand is a temporary.
+template <class Op, class L, class R> inline mpfr_class mpfr_expr_reuse(mpfr_class &&rop, const L &lhs, const R &rhs) {
+    if (rop.get_prec() != defaults::prec)
+        return mpfr_class(mpfr_expr<Op, L, R>(lhs, rhs));
+    mpfr_expr<Op, L, R>(lhs, rhs).eval(rop.materialize(), defaults::rnd);
+    return std::move(rop);
+}
+inline mpfr_class operator+(mpfr_class &&lhs, const mpfr_class &rhs) { return mpfr_expr_reuse<mpfr_add_op>(std::move(lhs), lhs, rhs); }
+inline mpfr_class operator+(const mpfr_class &lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_add_op>(std::move(rhs), lhs, rhs); }
+inline mpfr_class operator+(mpfr_class &&lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_add_op>(std::move(lhs), lhs, rhs); }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline mpfr_class operator+(mpfr_class &&lhs, const S rhs) { return mpfr_expr_reuse<mpfr_add_op>(std::move(lhs), lhs, mpfr_scalar_t<S>(rhs)); }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline mpfr_class operator+(const S lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_add_op>(std::move(rhs), mpfr_scalar_t<S>(lhs), rhs); }
+template <class Op, class L, class R> inline mpfr_class operator+(mpfr_class &&lhs, const mpfr_expr<Op, L, R> &rhs) { return mpfr_expr_reuse<mpfr_add_op>(std::move(lhs), lhs, rhs); }
+template <class Op, class L, class R> inline mpfr_class operator+(const mpfr_expr<Op, L, R> &lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_add_op>(std::move(rhs), lhs, rhs); }
+inline mpfr_class operator-(mpfr_class &&lhs, const mpfr_class &rhs) { return mpfr_expr_reuse<mpfr_sub_op>(std::move(lhs), lhs, rhs); }
+inline mpfr_class operator-(const mpfr_class &lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_sub_op>(std::move(rhs), lhs, rhs); }
+inline mpfr_class operator-(mpfr_class &&lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_sub_op>(std::move(lhs), lhs, rhs); }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline mpfr_class operator-(mpfr_class &&lhs, const S rhs) { return mpfr_expr_reuse<mpfr_sub_op>(std::move(lhs), lhs, mpfr_scalar_t<S>(rhs)); }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline mpfr_class operator-(const S lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_sub_op>(std::move(rhs), mpfr_scalar_t<S>(lhs), rhs); }
+template <class Op, class L, class R> inline mpfr_class operator-(mpfr_class &&lhs, const mpfr_expr<Op, L, R> &rhs) { return mpfr_expr_reuse<mpfr_sub_op>(std::move(lhs), lhs, rhs); }
+template <class Op, class L, class R> inline mpfr_class operator-(const mpfr_expr<Op, L, R> &lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_sub_op>(std::move(rhs), lhs, rhs); }
+inline mpfr_class operator*(mpfr_class &&lhs, const mpfr_class &rhs) { return mpfr_expr_reuse<mpfr_mul_op>(std::move(lhs), lhs, rhs); }
+inline mpfr_class operator*(const mpfr_class &lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_mul_op>(std::move(rhs), lhs, rhs); }
+inline mpfr_class operator*(mpfr_class &&lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_mul_op>(std::move(lhs), lhs, rhs); }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline mpfr_class operator*(mpfr_class &&lhs, const S rhs) { return mpfr_expr_reuse<mpfr_mul_op>(std::move(lhs), lhs, mpfr_scalar_t<S>(rhs)); }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline mpfr_class operator*(const S lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_mul_op>(std::move(rhs), mpfr_scalar_t<S>(lhs), rhs); }
+template <class Op, class L, class R> inline mpfr_class operator*(mpfr_class &&lhs, const mpfr_expr<Op, L, R> &rhs) { return mpfr_expr_reuse<mpfr_mul_op>(std::move(lhs), lhs, rhs); }
+template <class Op, class L, class R> inline mpfr_class operator*(const mpfr_expr<Op, L, R> &lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_mul_op>(std::move(rhs), lhs, rhs); }
+inline mpfr_class operator/(mpfr_class &&lhs, const mpfr_class &rhs) { return mpfr_expr_reuse<mpfr_div_op>(std::move(lhs), lhs, rhs); }
+inline mpfr_class operator/(const mpfr_class &lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_div_op>(std::move(rhs), lhs, rhs); }
+inline mpfr_class operator/(mpfr_class &&lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_div_op>(std::move(lhs), lhs, rhs); }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline mpfr_class operator/(mpfr_class &&lhs, const S rhs) { return mpfr_expr_reuse<mpfr_div_op>(std::move(lhs), lhs, mpfr_scalar_t<S>(rhs)); }
+template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> inline mpfr_class operator/(const S lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_div_op>(std::move(rhs), mpfr_scalar_t<S>(lhs), rhs); }
+template <class Op, class L, class R> inline mpfr_class operator/(mpfr_class &&lhs, const mpfr_expr<Op, L, R> &rhs) { return mpfr_expr_reuse<mpfr_div_op>(std::move(lhs), lhs, rhs); }
+template <class Op, class L, class R> inline mpfr_class operator/(const mpfr_expr<Op, L, R> &lhs, mpfr_class &&rhs) { return mpfr_expr_reuse<mpfr_div_op>(std::move(rhs), lhs, rhs); }
+
+// Comparisons with scalars through mpfr_cmp_d / _si / _ui / _z / _q. As for two mpfr
+// operands, every relation is false when the operands are unordered (NaN).
+template <class S> inline bool mpfr_scalar_cmp(mpfr_srcptr op1, const S op2, int &c) {
+    if (mpfr_nan_p(op1))
+        return false;
+    if constexpr (std::is_same<S, double>::value) {
+        if (op2 != op2)
+            return false;
+        c = mpfr_cmp_d(op1, op2);
+    } else if constexpr (std::is_same<S, long>::value) {
+        c = mpfr_cmp_si(op1, op2);
+    } else if constexpr (std::is_same<S, unsigned long>::value) {
+        c = mpfr_cmp_ui(op1, op2);
+    } else if constexpr (std::is_same<S, mpz_srcptr>::value) {
+        c = mpfr_cmp_z(op1, op2);
+    } else {
+        c = mpfr_cmp_q(op1, op2);
+    }
+    return true;
 }
-inline mpfr_class operator/(const double lhs, const mpfr_class &rhs) {
-    mpfr_class result;
-    mpfr_d_div(result.value, lhs, rhs.value, defaults::rnd);
-    return result;
+template <class T, class S> inline bool mpfr_operand_cmp(const T &op1, const S op2, int &c) {
+    if constexpr (is_mpfr_leaf<T>::value) {
+        return mpfr_scalar_cmp(op1.get_mpfr_t(), mpfr_scalar_t<S>(op2), c);
+    } else {
+        const mpfr_class tmp(op1);
+        return mpfr_scalar_cmp(tmp.get_mpfr_t(), mpfr_scalar_t<S>(op2), c);
+    }
 }
+template <class T, class S, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator==(const T &op1, const S op2) { int c = 0; return mpfr_operand_cmp(op1, op2, c) && c == 0; }
+template <class S, class T, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator==(const S op1, const T &op2) { int c = 0; return mpfr_operand_cmp(op2, op1, c) && c == 0; }
+template <class T, class S, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator!=(const T &op1, const S op2) { int c = 0; return mpfr_operand_cmp(op1, op2, c) && c != 0; }
+template <class S, class T, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator!=(const S op1, const T &op2) { int c = 0; return mpfr_operand_cmp(op2, op1, c) && c != 0; }
+template <class T, class S, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator<(const T &op1, const S op2) { int c = 0; return mpfr_operand_cmp(op1, op2, c) && c < 0; }
+template <class S, class T, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator<(const S op1, const T &op2) { int c = 0; return mpfr_operand_cmp(op2, op1, c) && c > 0; }
+template <class T, class S, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator>(const T &op1, const S op2) { int c = 0; return mpfr_operand_cmp(op1, op2, c) && c > 0; }
+template <class S, class T, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator>(const S op1, const T &op2) { int c = 0; return mpfr_operand_cmp(op2, op1, c) && c < 0; }
+template <class T, class S, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator<=(const T &op1, const S op2) { int c = 0; return mpfr_operand_cmp(op1, op2, c) && c <= 0; }
+template <class S, class T, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator<=(const S op1, const T &op2) { int c = 0; return mpfr_operand_cmp(op2, op1, c) && c >= 0; }
+template <class T, class S, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator>=(const T &op1, const S op2) { int c = 0; return mpfr_operand_cmp(op1, op2, c) && c >= 0; }
+template <class S, class T, mpfr_enable_if_operand_scalar<T, S> = 0> inline bool operator>=(const S op1, const T &op2) { int c = 0; return mpfr_operand_cmp(op2, op1, c) && c <= 0; }
+// Comparisons between other operands, e.g. mpfr_class and mpfr_fixed<Bits>, or a leaf and
+// an expression (which is evaluated at the default precision first)
+template <class A, class B, class F> inline bool mpfr_operands_cmp(const A &op1, const B &op2, F cmp) {
+    if constexpr (is_mpfr_expr<A>::value)
+        return mpfr_operands_cmp(mpfr_class(op1), op2, cmp);
+    else if constexpr (is_mpfr_expr<B>::value)
+        return mpfr_operands_cmp(op1, mpfr_class(op2), cmp);
+    else
+        return cmp(op1.get_mpfr_t(), op2.get_mpfr_t()) != 0;
+}
+template <class A, class B, mpfr_enable_if_operands<A, B> = 0> inline bool operator==(const A &op1, const B &op2) { return mpfr_operands_cmp(op1, op2, mpfr_equal_p); }
+template <class A, class B, mpfr_enable_if_operands<A, B> = 0> inline bool operator!=(const A &op1, const B &op2) { return mpfr_operands_cmp(op1, op2, mpfr_lessgreater_p); }
+template <class A, class B, mpfr_enable_if_operands<A, B> = 0> inline bool operator<(const A &op1, const B &op2) { return mpfr_operands_cmp(op1, op2, mpfr_less_p); }
+template <class A, class B, mpfr_enable_if_operands<A, B> = 0> inline bool operator>(const A &op1, const B &op2) { return mpfr_operands_cmp(op1, op2, mpfr_greater_p); }
+template <class A, class B, mpfr_enable_if_operands<A, B> = 0> inline bool operator<=(const A &op1, const B &op2) { return mpfr_operands_cmp(op1, op2, mpfr_lessequal_p); }
+template <class A, class B, mpfr_enable_if_operands<A, B> = 0> inline bool operator>=(const A &op1, const B &op2) { return mpfr_operands_cmp(op1, op2, mpfr_greaterequal_p); }
+
 inline mpfr_class sqrt(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_sqrt(rop.value, op.get_mpfr_t(), rnd);
+    MPFR_CLASS_STATS_OP(stats::sqrt, rop.get_prec());
+    mpfr_sqrt(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class sqrt(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return sqrt(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::sqrt, op.get_prec());
+    mpfr_sqrt(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class neg(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_neg(rop.value, op.get_mpfr_t(), rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpfr_neg(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class neg(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return neg(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, op.get_prec());
+    mpfr_neg(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class abs(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_abs(rop.value, op.get_mpfr_t(), rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpfr_abs(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class abs(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return abs(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, op.get_prec());
+    mpfr_abs(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class mul_2ui(const mpfr_class &op1, unsigned long int op2, mpfr_rnd_t rnd) {
     mpfr_class rop;
-    mpfr_mul_2ui(rop.value, op1.value, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpfr_mul_2ui(rop.materialize(), op1.get_mpfr_t(), op2, rnd);
     return rop;
 }
+inline mpfr_class mul_2ui(mpfr_class &&op1, unsigned long int op2, mpfr_rnd_t rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return mul_2ui(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, op1.get_prec());
+    mpfr_mul_2ui(op1.materialize(), op1.get_mpfr_t(), op2, rnd);
+    return std::move(op1);
+}
 inline mpfr_class mul_2si(const mpfr_class &op1, long int op2, mpfr_rnd_t rnd) {
     mpfr_class rop;
-    mpfr_mul_2si(rop.value, op1.value, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpfr_mul_2si(rop.materialize(), op1.get_mpfr_t(), op2, rnd);
     return rop;
 }
+inline mpfr_class mul_2si(mpfr_class &&op1, long int op2, mpfr_rnd_t rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return mul_2si(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, op1.get_prec());
+    mpfr_mul_2si(op1.materialize(), op1.get_mpfr_t(), op2, rnd);
+    return std::move(op1);
+}
 inline mpfr_class div_2ui(const mpfr_class &op1, unsigned long int op2, mpfr_rnd_t rnd) {
     mpfr_class rop;
-    mpfr_div_2ui(rop.value, op1.value, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpfr_div_2ui(rop.materialize(), op1.get_mpfr_t(), op2, rnd);
     return rop;
 }
+inline mpfr_class div_2ui(mpfr_class &&op1, unsigned long int op2, mpfr_rnd_t rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return div_2ui(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, op1.get_prec());
+    mpfr_div_2ui(op1.materialize(), op1.get_mpfr_t(), op2, rnd);
+    return std::move(op1);
+}
 inline mpfr_class div_2si(const mpfr_class &op1, long int op2, mpfr_rnd_t rnd) {
     mpfr_class rop;
-    mpfr_div_2si(rop.value, op1.value, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, rop.get_prec());
+    mpfr_div_2si(rop.materialize(), op1.get_mpfr_t(), op2, rnd);
     return rop;
 }
+inline mpfr_class div_2si(mpfr_class &&op1, long int op2, mpfr_rnd_t rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return div_2si(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::exact, op1.get_prec());
+    mpfr_div_2si(op1.materialize(), op1.get_mpfr_t(), op2, rnd);
+    return std::move(op1);
+}
 inline mpfr_class log(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_log(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_log(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class log(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return log(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_log(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class log_ui(unsigned long int op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_log_ui(rop.value, op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_log_ui(rop.materialize(), op, rnd);
     return rop;
 }
 inline mpfr_class log2(const mpfr_class &a, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_log2(rop.value, a.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_log2(rop.materialize(), a.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class log2(mpfr_class &&a, mpfr_rnd_t rnd = defaults::rnd) {
+    if (a.get_prec() != defaults::prec)
+        return log2(a, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, a.get_prec());
+    mpfr_log2(a.materialize(), a.get_mpfr_t(), rnd);
+    return std::move(a);
+}
 inline mpfr_class log10(const mpfr_class &a, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_log10(rop.value, a.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_log10(rop.materialize(), a.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class log10(mpfr_class &&a, mpfr_rnd_t rnd = defaults::rnd) {
+    if (a.get_prec() != defaults::prec)
+        return log10(a, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, a.get_prec());
+    mpfr_log10(a.materialize(), a.get_mpfr_t(), rnd);
+    return std::move(a);
+}
 inline mpfr_class log1p(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_log1p(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_log1p(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class log1p(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return log1p(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_log1p(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class log2p1(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_log2p1(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_log2p1(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class log2p1(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return log2p1(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_log2p1(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class log10p1(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_log10p1(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_log10p1(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class log10p1(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return log10p1(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_log10p1(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class exp(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_exp(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_exp(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class exp(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return exp(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_exp(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class exp2(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_exp2(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_exp2(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class exp2(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return exp2(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_exp2(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class exp10(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_exp10(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_exp10(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class exp10(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return exp10(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_exp10(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class expm1(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_expm1(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_expm1(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class expm1(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return expm1(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_expm1(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class exp2m1(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_exp2m1(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_exp2m1(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class exp2m1(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return exp2m1(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_exp2m1(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class exp10m1(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_exp10m1(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_exp10m1(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class exp10m1(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return exp10m1(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_exp10m1(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class pow(const mpfr_class &op1, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_pow(rop.value, op1.value, op2.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_pow(rop.materialize(), op1.get_mpfr_t(), op2.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class pow(mpfr_class &&op1, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return pow(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_pow(op1.materialize(), op1.get_mpfr_t(), op2.get_mpfr_t(), rnd);
+    return std::move(op1);
+}
 inline mpfr_class powr(const mpfr_class &op1, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_powr(rop.value, op1.value, op2.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_powr(rop.materialize(), op1.get_mpfr_t(), op2.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class powr(mpfr_class &&op1, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return powr(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_powr(op1.materialize(), op1.get_mpfr_t(), op2.get_mpfr_t(), rnd);
+    return std::move(op1);
+}
 inline mpfr_class pow_ui(const mpfr_class &op1, unsigned long int op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_pow_ui(rop.value, op1.value, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_pow_ui(rop.materialize(), op1.get_mpfr_t(), op2, rnd);
     return rop;
 }
+inline mpfr_class pow_ui(mpfr_class &&op1, unsigned long int op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return pow_ui(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_pow_ui(op1.materialize(), op1.get_mpfr_t(), op2, rnd);
+    return std::move(op1);
+}
 inline mpfr_class pow_si(const mpfr_class &op1, long int op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_pow_si(rop.value, op1.value, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_pow_si(rop.materialize(), op1.get_mpfr_t(), op2, rnd);
     return rop;
 }
-/*
+inline mpfr_class pow_si(mpfr_class &&op1, long int op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return pow_si(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_pow_si(op1.materialize(), op1.get_mpfr_t(), op2, rnd);
+    return std::move(op1);
+}
+#ifdef _MPFR_H_HAVE_INTMAX_T
 inline mpfr_class pow_uj(const mpfr_class &op1, uintmax_t op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_pow_uj(rop.value, op1.value, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_pow_uj(rop.materialize(), op1.get_mpfr_t(), op2, rnd);
     return rop;
 }
+inline mpfr_class pow_uj(mpfr_class &&op1, uintmax_t op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return pow_uj(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_pow_uj(op1.materialize(), op1.get_mpfr_t(), op2, rnd);
+    return std::move(op1);
+}
 inline mpfr_class pow_sj(const mpfr_class &op1, intmax_t op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_pow_sj(rop.value, op1.value, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_pow_sj(rop.materialize(), op1.get_mpfr_t(), op2, rnd);
     return rop;
 }
+inline mpfr_class pow_sj(mpfr_class &&op1, intmax_t op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return pow_sj(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_pow_sj(op1.materialize(), op1.get_mpfr_t(), op2, rnd);
+    return std::move(op1);
+}
 inline mpfr_class pown(const mpfr_class &op1, intmax_t n, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_pown(rop.value, op1.value, n, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_pown(rop.materialize(), op1.get_mpfr_t(), n, rnd);
     return rop;
 }
-*/
+inline mpfr_class pown(mpfr_class &&op1, intmax_t n, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return pown(op1, n, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_pown(op1.materialize(), op1.get_mpfr_t(), n, rnd);
+    return std::move(op1);
+}
+#endif
 inline mpfr_class pow_z(const mpfr_class &op1, const mpz_t op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_pow_z(rop.value, op1.value, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_pow_z(rop.materialize(), op1.get_mpfr_t(), op2, rnd);
     return rop;
 }
+inline mpfr_class pow_z(mpfr_class &&op1, const mpz_t op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return pow_z(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_pow_z(op1.materialize(), op1.get_mpfr_t(), op2, rnd);
+    return std::move(op1);
+}
 inline mpfr_class ui_pow_ui(unsigned long int op1, unsigned long int op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_ui_pow_ui(rop.value, op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_ui_pow_ui(rop.materialize(), op1, op2, rnd);
     return rop;
 }
 inline mpfr_class ui_pow(unsigned long int op1, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_ui_pow(rop.value, op1, op2.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_ui_pow(rop.materialize(), op1, op2.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class ui_pow(unsigned long int op1, mpfr_class &&op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op2.get_prec() != defaults::prec)
+        return ui_pow(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op2.get_prec());
+    mpfr_ui_pow(op2.materialize(), op1, op2.get_mpfr_t(), rnd);
+    return std::move(op2);
+}
 inline mpfr_class cos(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_cos(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_cos(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class cos(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return cos(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_cos(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class sin(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_sin(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_sin(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class sin(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return sin(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_sin(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class tan(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_tan(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_tan(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class tan(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return tan(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_tan(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class cosu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_cosu(rop.value, op.value, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_cosu(rop.materialize(), op.get_mpfr_t(), u, rnd);
     return rop;
 }
+inline mpfr_class cosu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return cosu(op, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_cosu(op.materialize(), op.get_mpfr_t(), u, rnd);
+    return std::move(op);
+}
 inline mpfr_class sinu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_sinu(rop.value, op.value, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_sinu(rop.materialize(), op.get_mpfr_t(), u, rnd);
     return rop;
 }
+inline mpfr_class sinu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return sinu(op, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_sinu(op.materialize(), op.get_mpfr_t(), u, rnd);
+    return std::move(op);
+}
 inline mpfr_class tanu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_tanu(rop.value, op.value, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_tanu(rop.materialize(), op.get_mpfr_t(), u, rnd);
     return rop;
 }
+inline mpfr_class tanu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return tanu(op, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_tanu(op.materialize(), op.get_mpfr_t(), u, rnd);
+    return std::move(op);
+}
 inline mpfr_class cospi(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_cospi(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_cospi(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class cospi(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return cospi(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_cospi(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class sinpi(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_sinpi(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_sinpi(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class sinpi(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return sinpi(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_sinpi(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class tanpi(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_tanpi(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_tanpi(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
-void sin_cos(mpfr_class &sop, mpfr_class &cop, const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) { mpfr_sin_cos(sop.value, cop.value, op.value, rnd); }
+inline mpfr_class tanpi(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return tanpi(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_tanpi(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
+inline void sin_cos(mpfr_class &sop, mpfr_class &cop, const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) { MPFR_CLASS_STATS_OP(stats::transcendental, sop.get_prec()); mpfr_sin_cos(sop.materialize(), cop.materialize(), op.get_mpfr_t(), rnd); }
 inline mpfr_class sec(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_sec(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_sec(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class sec(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return sec(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_sec(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class csc(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_csc(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_csc(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class csc(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return csc(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_csc(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class cot(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_cot(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_cot(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class cot(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return cot(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_cot(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class acos(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_acos(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_acos(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class acos(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return acos(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_acos(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class asin(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_asin(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_asin(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class asin(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return asin(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_asin(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class acosu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_acosu(rop.value, op.value, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_acosu(rop.materialize(), op.get_mpfr_t(), u, rnd);
     return rop;
 }
+inline mpfr_class acosu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return acosu(op, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_acosu(op.materialize(), op.get_mpfr_t(), u, rnd);
+    return std::move(op);
+}
 inline mpfr_class asinu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_asinu(rop.value, op.value, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_asinu(rop.materialize(), op.get_mpfr_t(), u, rnd);
     return rop;
 }
+inline mpfr_class asinu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return asinu(op, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_asinu(op.materialize(), op.get_mpfr_t(), u, rnd);
+    return std::move(op);
+}
 inline mpfr_class atanu(const mpfr_class &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_atanu(rop.value, op.value, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_atanu(rop.materialize(), op.get_mpfr_t(), u, rnd);
     return rop;
 }
+inline mpfr_class atanu(mpfr_class &&op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return atanu(op, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_atanu(op.materialize(), op.get_mpfr_t(), u, rnd);
+    return std::move(op);
+}
 inline mpfr_class acospi(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_acospi(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_acospi(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class acospi(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return acospi(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_acospi(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class asinpi(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_asinpi(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_asinpi(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class asinpi(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return asinpi(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_asinpi(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class atanpi(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_atanpi(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_atanpi(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class atanpi(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return atanpi(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_atanpi(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class atan2(const mpfr_class &y, const mpfr_class &x, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_atan2(rop.value, y.value, x.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_atan2(rop.materialize(), y.get_mpfr_t(), x.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class atan2(mpfr_class &&y, const mpfr_class &x, mpfr_rnd_t rnd = defaults::rnd) {
+    if (y.get_prec() != defaults::prec)
+        return atan2(y, x, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, y.get_prec());
+    mpfr_atan2(y.materialize(), y.get_mpfr_t(), x.get_mpfr_t(), rnd);
+    return std::move(y);
+}
 inline mpfr_class atan2u(const mpfr_class &y, const mpfr_class &x, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_atan2u(rop.value, y.value, x.value, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_atan2u(rop.materialize(), y.get_mpfr_t(), x.get_mpfr_t(), u, rnd);
     return rop;
 }
+inline mpfr_class atan2u(mpfr_class &&y, const mpfr_class &x, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    if (y.get_prec() != defaults::prec)
+        return atan2u(y, x, u, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, y.get_prec());
+    mpfr_atan2u(y.materialize(), y.get_mpfr_t(), x.get_mpfr_t(), u, rnd);
+    return std::move(y);
+}
 inline mpfr_class atan2pi(const mpfr_class &y, const mpfr_class &x, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_atan2pi(rop.value, y.value, x.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_atan2pi(rop.materialize(), y.get_mpfr_t(), x.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class atan2pi(mpfr_class &&y, const mpfr_class &x, mpfr_rnd_t rnd = defaults::rnd) {
+    if (y.get_prec() != defaults::prec)
+        return atan2pi(y, x, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, y.get_prec());
+    mpfr_atan2pi(y.materialize(), y.get_mpfr_t(), x.get_mpfr_t(), rnd);
+    return std::move(y);
+}
 inline mpfr_class cosh(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_cosh(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_cosh(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class cosh(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return cosh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_cosh(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class sinh(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_sinh(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_sinh(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class sinh(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return sinh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_sinh(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class tanh(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_tanh(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_tanh(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
-void sinh_cosh(mpfr_class &sop, mpfr_class &cop, const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) { mpfr_sinh_cosh(sop.value, cop.value, op.value, rnd); }
+inline mpfr_class tanh(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return tanh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_tanh(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
+inline void sinh_cosh(mpfr_class &sop, mpfr_class &cop, const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) { MPFR_CLASS_STATS_OP(stats::transcendental, sop.get_prec()); mpfr_sinh_cosh(sop.materialize(), cop.materialize(), op.get_mpfr_t(), rnd); }
 inline mpfr_class sech(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_sech(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_sech(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class sech(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return sech(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_sech(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class csch(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_csch(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_csch(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class csch(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return csch(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_csch(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class coth(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_coth(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_coth(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class coth(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return coth(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_coth(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class acosh(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_acosh(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_acosh(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class acosh(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return acosh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_acosh(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class asinh(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_asinh(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_asinh(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class asinh(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return asinh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_asinh(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class atanh(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_atanh(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_atanh(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class atanh(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return atanh(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_atanh(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class eint(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_eint(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_eint(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class eint(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return eint(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_eint(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class li2(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_li2(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_li2(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class li2(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return li2(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_li2(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class beta(const mpfr_class &op1, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_beta(rop.value, op1.value, op2.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_beta(rop.materialize(), op1.get_mpfr_t(), op2.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class beta(mpfr_class &&op1, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return beta(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_beta(op1.materialize(), op1.get_mpfr_t(), op2.get_mpfr_t(), rnd);
+    return std::move(op1);
+}
 inline mpfr_class gamma(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_gamma(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_gamma(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class gamma(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return gamma(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_gamma(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class gamma_inc(const mpfr_class &op, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_gamma_inc(rop.value, op.value, op2.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_gamma_inc(rop.materialize(), op.get_mpfr_t(), op2.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class gamma_inc(mpfr_class &&op, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return gamma_inc(op, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_gamma_inc(op.materialize(), op.get_mpfr_t(), op2.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class lngamma(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_lngamma(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_lngamma(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class lngamma(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return lngamma(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_lngamma(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class lgamma(const mpfr_class &op, int &signp, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_lgamma(rop.value, &signp, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_lgamma(rop.materialize(), &signp, op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class lgamma(mpfr_class &&op, int &signp, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return lgamma(op, signp, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_lgamma(op.materialize(), &signp, op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class digamma(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_digamma(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_digamma(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class digamma(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return digamma(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_digamma(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class zeta(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_zeta(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_zeta(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class zeta(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return zeta(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_zeta(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class zeta_ui(unsigned long int op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_zeta_ui(rop.value, op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_zeta_ui(rop.materialize(), op, rnd);
     return rop;
 }
 inline mpfr_class erf(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_erf(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_erf(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class erf(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return erf(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_erf(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class erfc(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_erfc(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_erfc(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class erfc(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return erfc(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_erfc(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class j0(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_j0(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_j0(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class j0(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return j0(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_j0(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class j1(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_j1(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_j1(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class j1(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return j1(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_j1(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class jn(long int n, const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_jn(rop.value, n, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_jn(rop.materialize(), n, op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class jn(long int n, mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return jn(n, op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_jn(op.materialize(), n, op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class y0(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_y0(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_y0(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class y0(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return y0(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_y0(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class y1(const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_y1(rop.value, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_y1(rop.materialize(), op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class y1(mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return y1(op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_y1(op.materialize(), op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class yn(long int n, const mpfr_class &op, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_yn(rop.value, n, op.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_yn(rop.materialize(), n, op.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class yn(long int n, mpfr_class &&op, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op.get_prec() != defaults::prec)
+        return yn(n, op, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op.get_prec());
+    mpfr_yn(op.materialize(), n, op.get_mpfr_t(), rnd);
+    return std::move(op);
+}
 inline mpfr_class agm(const mpfr_class &op1, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_agm(rop.value, op1.value, op2.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_agm(rop.materialize(), op1.get_mpfr_t(), op2.get_mpfr_t(), rnd);
     return rop;
 }
+inline mpfr_class agm(mpfr_class &&op1, const mpfr_class &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    if (op1.get_prec() != defaults::prec)
+        return agm(op1, op2, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, op1.get_prec());
+    mpfr_agm(op1.materialize(), op1.get_mpfr_t(), op2.get_mpfr_t(), rnd);
+    return std::move(op1);
+}
 inline mpfr_class ai(const mpfr_class &x, mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_ai(rop.value, x.value, rnd);
-    return rop;
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    mpfr_ai(rop.materialize(), x.get_mpfr_t(), rnd);
+    return rop;
+}
+inline mpfr_class ai(mpfr_class &&x, mpfr_rnd_t rnd = defaults::rnd) {
+    if (x.get_prec() != defaults::prec)
+        return ai(x, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, x.get_prec());
+    mpfr_ai(x.materialize(), x.get_mpfr_t(), rnd);
+    return std::move(x);
+}
+////////////////////////////////////////////////////////////////////////////////////////
+// Constant cache
+// const_pi, const_log2, const_euler and const_catalan are served from one process-wide
+// cache which keeps, per constant, the value at the highest precision asked for so far.
+// Lower precisions are correctly rounded from it instead of being recomputed; a higher
+// precision recomputes and replaces the entry. MPFR's own cache holds one precision per
+// thread, so code alternating between 256 and 4096 bits kept recomputing.
+//
+//   mpfr::constants::prewarm(4096);   // compute all four before the threads start
+//   mpfr::constants::free();          // drop them, and MPFR's caches (mpfr_free_cache)
+////////////////////////////////////////////////////////////////////////////////////////
+namespace constants {
+
+enum constant { pi, log2, euler, catalan, count };
+
+struct statistics {
+    unsigned long long hits = 0;   // rounded from a cached value
+    unsigned long long misses = 0; // computed by MPFR
+};
+
+struct entry {
+    mpfr_t value;
+    int inexact = 0; // ternary value of value against the constant; never 0, they are irrational
+    bool valid = false;
+    ~entry() {
+        if (valid)
+            mpfr_clear(value);
+    }
+};
+
+inline std::shared_mutex cache_mutex;
+inline entry cache[count];
+inline std::atomic<unsigned long long> hits{0}, misses{0};
+
+inline int compute(mpfr_ptr rop, const constant c, const mpfr_rnd_t rnd) {
+    switch (c) {
+    case pi:
+        return mpfr_const_pi(rop, rnd);
+    case log2:
+        return mpfr_const_log2(rop, rnd);
+    case euler:
+        return mpfr_const_euler(rop, rnd);
+    default:
+        return mpfr_const_catalan(rop, rnd);
+    }
 }
+
+// Rounds the cached value x (nearest, ternary value t) to rop. Rounding twice is only
+// wrong where x sits on a boundary of the target precision: a midpoint for MPFR_RNDN, or
+// a representable number for the directed modes. There t tells on which side the exact
+// constant lies. All four constants are positive.
+inline int round_down(mpfr_ptr rop, mpfr_srcptr x, const int t, mpfr_rnd_t rnd) {
+    const mpfr_prec_t prec = mpfr_get_prec(rop);
+    if (rnd == MPFR_RNDF)
+        rnd = MPFR_RNDN;
+    if (rnd == MPFR_RNDN && mpfr_min_prec(x) == prec + 1) // x is a midpoint
+        return mpfr_set(rop, x, t > 0 ? MPFR_RNDZ : MPFR_RNDA);
+    const int inexact = mpfr_set(rop, x, rnd);
+    if (inexact != 0 || rnd == MPFR_RNDN)
+        return inexact != 0 ? inexact : t;
+    const bool down = rnd == MPFR_RNDD || rnd == MPFR_RNDZ;
+    if (down && t > 0) {
+        mpfr_nextbelow(rop);
+        return -1;
+    }
+    if (!down && t < 0) {
+        mpfr_nextabove(rop);
+        return 1;
+    }
+    return t;
+}
+
+inline int get(mpfr_ptr rop, const constant c, const mpfr_rnd_t rnd) {
+    const mpfr_prec_t prec = mpfr_get_prec(rop);
+    {
+        std::shared_lock<std::shared_mutex> lock(cache_mutex);
+        const entry &e = cache[c];
+        if (e.valid && mpfr_get_prec(e.value) > prec) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return round_down(rop, e.value, e.inexact, rnd);
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(cache_mutex);
+    entry &e = cache[c];
+    if (!e.valid || mpfr_get_prec(e.value) <= prec) {
+        // a few guard bits keep later requests at this precision off the boundary cases
+        const mpfr_prec_t cached_prec = (prec / GMP_NUMB_BITS + 1) * GMP_NUMB_BITS;
+        allocator::arena_suspend suspend; // the entry outlives any arena_scope of the caller
+        if (e.valid)
+            mpfr_set_prec(e.value, cached_prec);
+        else
+            mpfr_init2(e.value, cached_prec);
+        e.inexact = compute(e.value, c, MPFR_RNDN);
+        e.valid = true;
+        misses.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    return round_down(rop, e.value, e.inexact, rnd);
+}
+
+inline void prewarm(const mpfr_prec_t prec) {
+    mpfr_t tmp;
+    mpfr_init2(tmp, prec);
+    for (int c = 0; c < count; c++)
+        get(tmp, static_cast<constant>(c), MPFR_RNDN);
+    mpfr_clear(tmp);
+}
+
+// Also frees MPFR's caches of the calling thread (mpfr_free_cache).
+inline void free() {
+    {
+        std::unique_lock<std::shared_mutex> lock(cache_mutex);
+        for (entry &e : cache) {
+            if (e.valid)
+                mpfr_clear(e.value);
+            e.valid = false;
+        }
+    }
+    mpfr_free_cache();
+}
+
+inline statistics get_statistics() {
+    statistics s;
+    s.hits = hits.load(std::memory_order_relaxed);
+    s.misses = misses.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace constants
+
 inline mpfr_class const_log2(mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_const_log2(rop.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    constants::get(rop.materialize(), constants::log2, rnd);
     return rop;
 }
 inline mpfr_class const_pi(mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_const_pi(rop.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    constants::get(rop.materialize(), constants::pi, rnd);
     return rop;
 }
 inline mpfr_class const_euler(mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_const_euler(rop.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    constants::get(rop.materialize(), constants::euler, rnd);
     return rop;
 }
 inline mpfr_class const_catalan(mpfr_rnd_t rnd = defaults::rnd) {
     mpfr_class rop;
-    mpfr_const_catalan(rop.value, rnd);
+    MPFR_CLASS_STATS_OP(stats::transcendental, rop.get_prec());
+    constants::get(rop.materialize(), constants::catalan, rnd);
     return rop;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// Literals
+// 1130_mpfr, 3.14159265358979323846264338327950288_mpfr, 1e-64_mpfr, 0x1.8p-3_mpfr.
+// The digits are checked at compile time and kept as written (no detour through double).
+// Each literal is parsed once per thread and precision, rounded to nearest, and then
+// returned from a cache; it is a constant, so it does not follow defaults::rnd.
+////////////////////////////////////////////////////////////////////////////////////////
+constexpr bool mpfr_literal_digit(const char c, const int base) {
+    if (base == 16)
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    return c >= '0' && c < '0' + base;
+}
+// decimal (with optional fraction and exponent), hexadecimal floating point and binary
+template <std::size_t N> constexpr bool mpfr_literal_valid(const std::array<char, N> &s) {
+    std::size_t i = 0;
+    int base = 10;
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+        base = 16;
+        i = 2;
+    } else if (s[0] == '0' && (s[1] == 'b' || s[1] == 'B')) {
+        base = 2;
+        i = 2;
+    } else if (s[0] == '0' && mpfr_literal_digit(s[1], 10)) {
+        bool octal = true; // C++ reads 017 as octal, MPFR would read it as decimal
+        for (std::size_t j = 1; s[j] != '\0'; j++)
+            octal = octal && mpfr_literal_digit(s[j], 10);
+        if (octal)
+            return false;
+    }
+    std::size_t digits = 0;
+    for (; mpfr_literal_digit(s[i], base); i++)
+        digits++;
+    if (s[i] == '.' && base != 2)
+        for (i++; mpfr_literal_digit(s[i], base); i++)
+            digits++;
+    if (digits == 0)
+        return false;
+    const char e = base == 16 ? 'p' : 'e', E = base == 16 ? 'P' : 'E';
+    if (base != 2 && (s[i] == e || s[i] == E)) {
+        i++;
+        if (s[i] == '+' || s[i] == '-')
+            i++;
+        if (!mpfr_literal_digit(s[i], 10))
+            return false;
+        while (mpfr_literal_digit(s[i], 10))
+            i++;
+    }
+    return s[i] == '\0';
+}
+// the literal without digit separators, null terminated
+template <char... Cs> constexpr std::array<char, sizeof...(Cs) + 1> mpfr_literal_text() {
+    const char raw[] = {Cs...};
+    std::array<char, sizeof...(Cs) + 1> text{};
+    std::size_t n = 0;
+    for (const char c : raw)
+        if (c != '\'')
+            text[n++] = c;
+    return text;
+}
+
+class mpfr_literal_cache {
+  public:
+    const mpfr_class &get(const char *text) {
+        if (last != nullptr && last->get_prec() == defaults::prec)
+            return *last;
+        auto it = values.find(defaults::prec);
+        if (it == values.end()) {
+            allocator::arena_suspend suspend; // interned for the life of the thread, past any arena_scope
+            it = values.emplace(defaults::prec, mpfr_class()).first;
+            mpfr_set_str(it->second.materialize(), text, 0, MPFR_RNDN);
+        }
+        last = &it->second;
+        return *last;
+    }
+
+  private:
+    std::map<mpfr_prec_t, mpfr_class> values;
+    const mpfr_class *last = nullptr;
+};
+
+inline namespace literals {
+template <char... Cs> inline const mpfr_class &operator""_mpfr() {
+    static constexpr std::array<char, sizeof...(Cs) + 1> text = mpfr_literal_text<Cs...>();
+    static_assert(mpfr_literal_valid(text), "_mpfr takes decimal, hexadecimal floating point or binary literals");
+    thread_local mpfr_literal_cache cache;
+    return cache.get(text.data());
+}
+} // namespace literals
+
 } // namespace mpfr
 
 namespace std {
@@ -1130,10 +2688,6 @@ template <> class numeric_limits<mpfr::mpfr_class> {
 
 } // namespace std
 
-mpfr_prec_t mpfr::defaults::prec;
-mpfr_rnd_t mpfr::defaults::rnd;
-int mpfr::defaults::base;
-
 class mpfr_class_initializer {
   public:
     mpfr_class_initializer() {
@@ -1143,4 +2697,6 @@ class mpfr_class_initializer {
     }
 };
 
-mpfr_class_initializer global_mpfr_class_initializer;
+inline mpfr_class_initializer global_mpfr_class_initializer;
+
+#endif
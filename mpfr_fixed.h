@@ -0,0 +1,716 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_FIXED_H_
+#define _MPFR_FIXED_H_
+
+#include "mpfr_class.h"
+#include <cstring>
+
+namespace mpfr {
+
+////////////////////////////////////////////////////////////////////////////////////////
+// mpfr_fixed<Bits>: an mpfr number of compile-time precision whose limbs are stored
+// inside the object through MPFR's custom interface (mpfr_custom_init_set). Nothing is
+// allocated on the heap, copies are a memcpy, and std::vector<mpfr_fixed<Bits>> is one
+// contiguous block. Operators go through the same expression templates as mpfr_class.
+////////////////////////////////////////////////////////////////////////////////////////
+template <mpfr_prec_t Bits> class mpfr_fixed;
+template <mpfr_prec_t Bits> struct is_mpfr_leaf<mpfr_fixed<Bits>> : std::true_type {};
+
+// The free functions are defined ahead of the class so that their default arguments
+// come with the first declaration; the class befriends them below.
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> sqrt(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_sqrt(rop.value, op.get_mpfr_t(), rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> neg(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_neg(rop.value, op.get_mpfr_t(), rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> abs(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_abs(rop.value, op.get_mpfr_t(), rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> mul_2ui(const mpfr_fixed<Bits> &op1, unsigned long int op2, mpfr_rnd_t rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_mul_2ui(rop.value, op1.value, op2, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> mul_2si(const mpfr_fixed<Bits> &op1, long int op2, mpfr_rnd_t rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_mul_2si(rop.value, op1.value, op2, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> div_2ui(const mpfr_fixed<Bits> &op1, unsigned long int op2, mpfr_rnd_t rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_div_2ui(rop.value, op1.value, op2, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> div_2si(const mpfr_fixed<Bits> &op1, long int op2, mpfr_rnd_t rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_div_2si(rop.value, op1.value, op2, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> log(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_log(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> log_ui(unsigned long int op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_log_ui(rop.value, op, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> log2(const mpfr_fixed<Bits> &a, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_log2(rop.value, a.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> log10(const mpfr_fixed<Bits> &a, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_log10(rop.value, a.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> log1p(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_log1p(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> log2p1(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_log2p1(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> log10p1(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_log10p1(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> exp(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_exp(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> exp2(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_exp2(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> exp10(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_exp10(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> expm1(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_expm1(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> exp2m1(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_exp2m1(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> exp10m1(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_exp10m1(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> pow(const mpfr_fixed<Bits> &op1, const mpfr_fixed<Bits> &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_pow(rop.value, op1.value, op2.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> powr(const mpfr_fixed<Bits> &op1, const mpfr_fixed<Bits> &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_powr(rop.value, op1.value, op2.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> pow_ui(const mpfr_fixed<Bits> &op1, unsigned long int op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_pow_ui(rop.value, op1.value, op2, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> pow_si(const mpfr_fixed<Bits> &op1, long int op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_pow_si(rop.value, op1.value, op2, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> pow_z(const mpfr_fixed<Bits> &op1, const mpz_t op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_pow_z(rop.value, op1.value, op2, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> ui_pow_ui(unsigned long int op1, unsigned long int op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_ui_pow_ui(rop.value, op1, op2, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> ui_pow(unsigned long int op1, const mpfr_fixed<Bits> &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_ui_pow(rop.value, op1, op2.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> cos(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_cos(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> sin(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_sin(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> tan(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_tan(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> cosu(const mpfr_fixed<Bits> &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_cosu(rop.value, op.value, u, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> sinu(const mpfr_fixed<Bits> &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_sinu(rop.value, op.value, u, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> tanu(const mpfr_fixed<Bits> &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_tanu(rop.value, op.value, u, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> cospi(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_cospi(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> sinpi(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_sinpi(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> tanpi(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_tanpi(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline void sin_cos(mpfr_fixed<Bits> &sop, mpfr_fixed<Bits> &cop, const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) { mpfr_sin_cos(sop.value, cop.value, op.value, rnd); }
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> sec(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_sec(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> csc(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_csc(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> cot(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_cot(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> acos(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_acos(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> asin(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_asin(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> acosu(const mpfr_fixed<Bits> &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_acosu(rop.value, op.value, u, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> asinu(const mpfr_fixed<Bits> &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_asinu(rop.value, op.value, u, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> atanu(const mpfr_fixed<Bits> &op, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_atanu(rop.value, op.value, u, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> acospi(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_acospi(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> asinpi(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_asinpi(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> atanpi(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_atanpi(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> atan2(const mpfr_fixed<Bits> &y, const mpfr_fixed<Bits> &x, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_atan2(rop.value, y.value, x.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> atan2u(const mpfr_fixed<Bits> &y, const mpfr_fixed<Bits> &x, unsigned long int u, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_atan2u(rop.value, y.value, x.value, u, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> atan2pi(const mpfr_fixed<Bits> &y, const mpfr_fixed<Bits> &x, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_atan2pi(rop.value, y.value, x.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> cosh(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_cosh(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> sinh(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_sinh(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> tanh(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_tanh(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline void sinh_cosh(mpfr_fixed<Bits> &sop, mpfr_fixed<Bits> &cop, const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) { mpfr_sinh_cosh(sop.value, cop.value, op.value, rnd); }
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> sech(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_sech(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> csch(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_csch(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> coth(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_coth(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> acosh(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_acosh(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> asinh(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_asinh(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> atanh(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_atanh(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> eint(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_eint(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> li2(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_li2(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> beta(const mpfr_fixed<Bits> &op1, const mpfr_fixed<Bits> &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_beta(rop.value, op1.value, op2.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> gamma(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_gamma(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> gamma_inc(const mpfr_fixed<Bits> &op, const mpfr_fixed<Bits> &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_gamma_inc(rop.value, op.value, op2.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> lngamma(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_lngamma(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> lgamma(const mpfr_fixed<Bits> &op, int &signp, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_lgamma(rop.value, &signp, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> digamma(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_digamma(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> zeta(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_zeta(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> zeta_ui(unsigned long int op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_zeta_ui(rop.value, op, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> erf(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_erf(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> erfc(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_erfc(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> j0(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_j0(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> j1(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_j1(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> jn(long int n, const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_jn(rop.value, n, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> y0(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_y0(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> y1(const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_y1(rop.value, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> yn(long int n, const mpfr_fixed<Bits> &op, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_yn(rop.value, n, op.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> agm(const mpfr_fixed<Bits> &op1, const mpfr_fixed<Bits> &op2, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_agm(rop.value, op1.value, op2.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> ai(const mpfr_fixed<Bits> &x, mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    mpfr_ai(rop.value, x.value, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> const_log2(mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    constants::get(rop.value, constants::log2, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> const_pi(mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    constants::get(rop.value, constants::pi, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> const_euler(mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    constants::get(rop.value, constants::euler, rnd);
+    return rop;
+}
+template <mpfr_prec_t Bits> inline mpfr_fixed<Bits> const_catalan(mpfr_rnd_t rnd = defaults::rnd) {
+    mpfr_fixed<Bits> rop;
+    constants::get(rop.value, constants::catalan, rnd);
+    return rop;
+}
+
+template <mpfr_prec_t Bits> class mpfr_fixed {
+    static_assert(Bits >= MPFR_PREC_MIN && Bits <= MPFR_PREC_MAX, "mpfr_fixed: precision out of range");
+
+  public:
+    static constexpr mpfr_prec_t prec = Bits;
+    static constexpr size_t nlimbs = (Bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.1 Initialization Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_fixed() noexcept {
+        mpfr_custom_init(limbs, Bits);
+        mpfr_custom_init_set(value, MPFR_NAN_KIND, 0, Bits, limbs);
+    }
+    ~mpfr_fixed() {} // nothing to free, the limbs are part of the object
+    mpfr_prec_t get_prec() const { return Bits; }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.2 Assignment Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // Copying a value is copying the header and the limbs, then pointing the copy at its own limbs.
+    mpfr_fixed(const mpfr_fixed &op) noexcept {
+        value[0] = op.value[0];
+        std::memcpy(limbs, op.limbs, sizeof(limbs));
+        mpfr_custom_move(value, limbs);
+    }
+    mpfr_fixed &operator=(const mpfr_fixed &op) noexcept {
+        if (this != &op) {
+            value[0] = op.value[0];
+            std::memcpy(limbs, op.limbs, sizeof(limbs));
+            mpfr_custom_move(value, limbs);
+        }
+        return *this;
+    }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const mpfr_t &op) noexcept : mpfr_fixed() { mpfr_set(value, op, defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const mpfr_class &op) noexcept : mpfr_fixed() { mpfr_set(value, op.get_mpfr_t(), defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const unsigned int op) noexcept : mpfr_fixed() { mpfr_set_ui(value, (unsigned long int)op, defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const int op) noexcept : mpfr_fixed() { mpfr_set_si(value, (long int)op, defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const unsigned long int op) noexcept : mpfr_fixed() { mpfr_set_ui(value, op, defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const long int op) noexcept : mpfr_fixed() { mpfr_set_si(value, op, defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const float op) noexcept : mpfr_fixed() { mpfr_set_flt(value, op, defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const double op) noexcept : mpfr_fixed() { mpfr_set_d(value, op, defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const long double op) noexcept : mpfr_fixed() { mpfr_set_ld(value, op, defaults::rnd); }
+#ifdef MPFR_WANT_FLOAT128
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const _Float128 op) noexcept : mpfr_fixed() { mpfr_set_float128(value, op, defaults::rnd); }
+#endif
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const mpz_t op) noexcept : mpfr_fixed() { mpfr_set_z(value, op, defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const mpq_t op) noexcept : mpfr_fixed() { mpfr_set_q(value, op, defaults::rnd); }
+    ___MPFR_CLASS_EXPLICIT___ mpfr_fixed(const mpf_t op) noexcept : mpfr_fixed() { mpfr_set_f(value, op, defaults::rnd); }
+    mpfr_fixed(const char *s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) : mpfr_fixed() {
+        if (mpfr_set_str(value, s, base, rnd) != 0) {
+            std::cerr << "Error initializing mpfr_t from const char*: " << s << std::endl;
+            throw std::runtime_error("Failed to initialize mpfr_t with given string.");
+        }
+    }
+    mpfr_fixed(const std::string &s, int base = defaults::base, mpfr_rnd_t rnd = defaults::rnd) : mpfr_fixed() {
+        if (mpfr_set_str(value, s.c_str(), base, rnd) != 0) {
+            std::cerr << "Error initializing mpfr_t from std::string: " << s << std::endl;
+            throw std::runtime_error("Failed to initialize mpfr_t with given string.");
+        }
+    }
+    template <class Op, class L, class R> mpfr_fixed(const mpfr_expr<Op, L, R> &e) : mpfr_fixed() { e.eval(value, defaults::rnd); }
+    template <class Op, class L, class R> mpfr_fixed &operator=(const mpfr_expr<Op, L, R> &e) {
+        e.eval(value, defaults::rnd);
+        return *this;
+    }
+    mpfr_fixed &operator=(const mpfr_class &op) noexcept {
+        mpfr_set(value, op.get_mpfr_t(), defaults::rnd);
+        return *this;
+    }
+    mpfr_fixed &operator=(double op) noexcept {
+        mpfr_set_d(value, op, defaults::rnd);
+        return *this;
+    }
+    mpfr_fixed &operator=(const char *s) {
+        if (mpfr_set_str(value, s, defaults::base, defaults::rnd) != 0) {
+            std::cerr << "Error assigning mpfr_t from char:" << std::endl;
+            throw std::runtime_error("Failed to initialize mpfr_t with given string.");
+        }
+        return *this;
+    }
+    mpfr_fixed &operator=(const std::string &s) {
+        if (mpfr_set_str(value, s.c_str(), defaults::base, defaults::rnd) != 0) {
+            std::cerr << "Error assigning mpfr_t from string: " << s << std::endl;
+            throw std::runtime_error("Failed to initialize mpfr_t with given string.");
+        }
+        return *this;
+    }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.5 Arithmetic Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    mpfr_fixed &operator+=(const mpfr_fixed &rhs) {
+        mpfr_add(value, value, rhs.value, defaults::rnd);
+        return *this;
+    }
+    mpfr_fixed &operator*=(const mpfr_fixed &rhs) {
+        mpfr_mul(value, value, rhs.value, defaults::rnd);
+        return *this;
+    }
+    mpfr_fixed &operator-=(const mpfr_fixed &rhs) {
+        mpfr_sub(value, value, rhs.value, defaults::rnd);
+        return *this;
+    }
+    mpfr_fixed &operator/=(const mpfr_fixed &rhs) {
+        mpfr_div(value, value, rhs.value, defaults::rnd);
+        return *this;
+    }
+    template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> mpfr_fixed &operator+=(const S rhs) {
+        mpfr_add_op::apply(value, value, mpfr_scalar_t<S>(rhs), defaults::rnd);
+        return *this;
+    }
+    template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> mpfr_fixed &operator-=(const S rhs) {
+        mpfr_sub_op::apply(value, value, mpfr_scalar_t<S>(rhs), defaults::rnd);
+        return *this;
+    }
+    template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> mpfr_fixed &operator*=(const S rhs) {
+        mpfr_mul_op::apply(value, value, mpfr_scalar_t<S>(rhs), defaults::rnd);
+        return *this;
+    }
+    template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> mpfr_fixed &operator/=(const S rhs) {
+        mpfr_div_op::apply(value, value, mpfr_scalar_t<S>(rhs), defaults::rnd);
+        return *this;
+    }
+    template <class Op, class L, class R> mpfr_fixed &operator+=(const mpfr_expr<Op, L, R> &rhs) {
+        (*this + rhs).eval(value, defaults::rnd);
+        return *this;
+    }
+    template <class Op, class L, class R> mpfr_fixed &operator-=(const mpfr_expr<Op, L, R> &rhs) {
+        (*this - rhs).eval(value, defaults::rnd);
+        return *this;
+    }
+    template <class Op, class L, class R> mpfr_fixed &operator*=(const mpfr_expr<Op, L, R> &rhs) {
+        (*this * rhs).eval(value, defaults::rnd);
+        return *this;
+    }
+    template <class Op, class L, class R> mpfr_fixed &operator/=(const mpfr_expr<Op, L, R> &rhs) {
+        (*this / rhs).eval(value, defaults::rnd);
+        return *this;
+    }
+    template <mpfr_prec_t B> friend mpfr_fixed<B> sqrt(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> neg(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> abs(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> mul_2ui(const mpfr_fixed<B> &op1, unsigned long int op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> mul_2si(const mpfr_fixed<B> &op1, long int op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> div_2ui(const mpfr_fixed<B> &op1, unsigned long int op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> div_2si(const mpfr_fixed<B> &op1, long int op2, mpfr_rnd_t rnd);
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.6 Comparison Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    friend inline bool operator==(const mpfr_fixed &op1, const mpfr_fixed &op2) { return mpfr_equal_p(op1.value, op2.value) != 0; }
+    friend inline bool operator!=(const mpfr_fixed &op1, const mpfr_fixed &op2) { return mpfr_lessgreater_p(op1.value, op2.value) != 0; }
+    friend inline bool operator<(const mpfr_fixed &op1, const mpfr_fixed &op2) { return mpfr_less_p(op1.value, op2.value) != 0; }
+    friend inline bool operator>(const mpfr_fixed &op1, const mpfr_fixed &op2) { return mpfr_greater_p(op1.value, op2.value) != 0; }
+    friend inline bool operator<=(const mpfr_fixed &op1, const mpfr_fixed &op2) { return mpfr_lessequal_p(op1.value, op2.value) != 0; }
+    friend inline bool operator>=(const mpfr_fixed &op1, const mpfr_fixed &op2) { return mpfr_greaterequal_p(op1.value, op2.value) != 0; }
+    bool is_nan() const { return mpfr_nan_p(value) != 0; }
+    bool is_inf() const { return mpfr_inf_p(value) != 0; }
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.7 Transcendental Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    template <mpfr_prec_t B> friend mpfr_fixed<B> log(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> log_ui(unsigned long int op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> log2(const mpfr_fixed<B> &a, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> log10(const mpfr_fixed<B> &a, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> log1p(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> log2p1(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> log10p1(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> exp(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> exp2(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> exp10(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> expm1(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> exp2m1(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> exp10m1(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> pow(const mpfr_fixed<B> &op1, const mpfr_fixed<B> &op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> powr(const mpfr_fixed<B> &op1, const mpfr_fixed<B> &op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> pow_ui(const mpfr_fixed<B> &op1, unsigned long int op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> pow_si(const mpfr_fixed<B> &op1, long int op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> pow_z(const mpfr_fixed<B> &op1, const mpz_t op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> ui_pow_ui(unsigned long int op1, unsigned long int op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> ui_pow(unsigned long int op1, const mpfr_fixed<B> &op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> cos(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> sin(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> tan(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> cosu(const mpfr_fixed<B> &op, unsigned long int u, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> sinu(const mpfr_fixed<B> &op, unsigned long int u, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> tanu(const mpfr_fixed<B> &op, unsigned long int u, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> cospi(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> sinpi(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> tanpi(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend void sin_cos(mpfr_fixed<B> &sop, mpfr_fixed<B> &cop, const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> sec(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> csc(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> cot(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> acos(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> asin(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> acosu(const mpfr_fixed<B> &op, unsigned long int u, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> asinu(const mpfr_fixed<B> &op, unsigned long int u, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> atanu(const mpfr_fixed<B> &op, unsigned long int u, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> acospi(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> asinpi(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> atanpi(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> atan2(const mpfr_fixed<B> &y, const mpfr_fixed<B> &x, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> atan2u(const mpfr_fixed<B> &y, const mpfr_fixed<B> &x, unsigned long int u, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> atan2pi(const mpfr_fixed<B> &y, const mpfr_fixed<B> &x, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> cosh(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> sinh(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> tanh(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend void sinh_cosh(mpfr_fixed<B> &sop, mpfr_fixed<B> &cop, const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> sech(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> csch(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> coth(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> acosh(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> asinh(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> atanh(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> eint(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> li2(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> beta(const mpfr_fixed<B> &op1, const mpfr_fixed<B> &op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> gamma(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> gamma_inc(const mpfr_fixed<B> &op, const mpfr_fixed<B> &op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> lngamma(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> lgamma(const mpfr_fixed<B> &op, int &signp, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> digamma(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> zeta(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> zeta_ui(unsigned long int op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> erf(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> erfc(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> j0(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> j1(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> jn(long int n, const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> y0(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> y1(const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> yn(long int n, const mpfr_fixed<B> &op, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> agm(const mpfr_fixed<B> &op1, const mpfr_fixed<B> &op2, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> ai(const mpfr_fixed<B> &x, mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> const_log2(mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> const_pi(mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> const_euler(mpfr_rnd_t rnd);
+    template <mpfr_prec_t B> friend mpfr_fixed<B> const_catalan(mpfr_rnd_t rnd);
+    ////////////////////////////////////////////////////////////////////////////////////////
+    // 5.8 Input and Output Functions
+    ////////////////////////////////////////////////////////////////////////////////////////
+    friend std::ostream &operator<<(std::ostream &os, const mpfr_fixed &m) { return mpfr_write(os, m.value); }
+    mpfr_srcptr get_mpfr_t() const { return value; }
+    mpfr_ptr get_mpfr_t() { return value; } // for calling MPFR directly; the precision must not be changed
+
+  private:
+    mpfr_t value;
+    mp_limb_t limbs[nlimbs];
+};
+
+} // namespace mpfr
+
+#endif
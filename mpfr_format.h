@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_FORMAT_H_
+#define _MPFR_FORMAT_H_
+
+#include "mpfr_class.h"
+#include "mpfr_blas.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MPFR_FORMAT_MMAP
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Bulk text output and input of vectors.
+//
+// write: the elements of an mpfr_vector, std::vector<mpfr_class> or anything with
+// size() and operator[] giving leaves, each formatted by to_chars and followed by the
+// separator. Rounds of write_chunk elements per thread are formatted in parallel
+// (blas::set_num_threads) into buffers that are kept for the whole call, then written
+// in order, so the output is the same for any thread count:
+//
+//   mpfr::format::write(os, v);                                     // as os << v[i] << '\n'
+//   mpfr::format::write(os, v, mpfr::chars_format::scientific, 40); // %.40Re
+//
+// read / parse: one number per line, or per delimiter within lines, into an mpfr_vector
+// (at its precision) or a std::vector<mpfr_class> (new elements at the default
+// precision), resized to the number of values. The file is memory mapped and split at
+// line boundaries into shards which mpfr_strtofr parses in parallel, straight into the
+// destination. Blank fields are skipped; spaces, tabs and '\r' around a value are
+// ignored. A value that does not parse is set to NaN and reported, and parsing goes on:
+//
+//   std::vector<mpfr::format::parse_error> errors = mpfr::format::read("x.txt", v);
+//   for (auto &e : errors) std::cerr << e.line << ": " << e.what << ": " << e.text << '\n';
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+namespace format {
+
+constexpr long write_chunk = 4096;
+constexpr size_t parse_shard_bytes = 1 << 16; // files are split across threads in shards of at least this size
+
+template <class V> void write(std::ostream &os, const V &v, const chars_format fmt, const int precision, const char separator = '\n') {
+    const long n = static_cast<long>(v.size());
+    const int threads = blas::get_num_threads();
+    std::vector<std::vector<char>> buffers(threads);
+    std::vector<size_t> used(threads);
+    for (long round = 0; round < n && os; round += threads * write_chunk) {
+        const long count = std::min<long>(n - round, threads * write_chunk);
+        const int parts = static_cast<int>((count + write_chunk - 1) / write_chunk);
+        blas::parallel_for(parts, count, [&](int p, long begin, long end) {
+            std::vector<char> &buffer = buffers[p];
+            size_t size = 0;
+            for (long i = round + begin; i < round + end; i++) {
+                mpfr_srcptr x = mpfr_expr_leaf(v[i]);
+                const size_t need = to_chars_size(x, fmt, precision) + 1;
+                if (buffer.size() < size + need)
+                    buffer.resize(std::max(size + need, 2 * buffer.size()));
+                char *first = buffer.data() + size;
+                char *last = to_chars(first, first + need - 1, x, fmt, precision).ptr;
+                *last++ = separator;
+                size = last - buffer.data();
+            }
+            used[p] = size;
+        });
+        for (int p = 0; p < parts; p++)
+            os.write(buffers[p].data(), static_cast<std::streamsize>(used[p]));
+    }
+}
+// in the format and precision of the stream, as operator<< without the field width
+template <class V> void write(std::ostream &os, const V &v, const char separator = '\n') {
+    write(os, v, mpfr_chars_format(os), static_cast<int>(os.precision()), separator);
+}
+
+
+struct parse_error {
+    size_t index;     // the element set to NaN, or npos if the file could not be read
+    size_t line;      // 1-based
+    std::string text; // the field, cut at 80 characters
+    const char *what; // "not a number", "trailing characters" or "cannot read the file"
+    static constexpr size_t npos = static_cast<size_t>(-1);
+};
+
+namespace detail {
+
+inline mpfr_ptr target(mpfr_vector &v, const size_t i) { return v.data()[i]; }
+inline mpfr_ptr target(std::vector<mpfr_class> &v, const size_t i) { return v[i].get_mpfr_t(); }
+
+// Calls field(begin, end, line) for each non-blank field of [first, last), trimmed, and
+// returns the number of line ends in it.
+template <class F> size_t fields(const char *first, const char *last, const char delimiter, size_t line, F field) {
+    auto blank = [](const char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    const size_t first_line = line;
+    while (first < last) {
+        const char *line_end = static_cast<const char *>(std::memchr(first, '\n', last - first));
+        if (!line_end)
+            line_end = last;
+        while (true) {
+            const char *end = delimiter == '\n' ? nullptr : static_cast<const char *>(std::memchr(first, delimiter, line_end - first));
+            if (!end)
+                end = line_end;
+            const char *b = first, *e = end;
+            while (b < e && blank(*b))
+                b++;
+            while (e > b && blank(e[-1]))
+                e--;
+            if (b < e)
+                field(b, e, line);
+            first = end + 1;
+            if (end == line_end)
+                break;
+        }
+        if (line_end < last)
+            line++;
+    }
+    return line - first_line;
+}
+
+// the file, mapped where possible, read otherwise
+struct mapped_file {
+    const char *data = nullptr;
+    size_t size = 0;
+    bool ok = false;
+#ifdef MPFR_FORMAT_MMAP
+    void *map = nullptr;
+    explicit mapped_file(const char *path) {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0) {
+            size = static_cast<size_t>(st.st_size);
+            if (size == 0) {
+                ok = true;
+            } else if ((map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED) {
+                ::madvise(map, size, MADV_WILLNEED);
+                data = static_cast<const char *>(map);
+                ok = true;
+            } else {
+                map = nullptr;
+            }
+        }
+        ::close(fd);
+    }
+    ~mapped_file() {
+        if (map)
+            ::munmap(map, size);
+    }
+#else
+    std::vector<char> bytes;
+    explicit mapped_file(const char *path) {
+        std::ifstream is(path, std::ios::binary);
+        if (!is)
+            return;
+        bytes.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+        data = bytes.data();
+        size = bytes.size();
+        ok = !is.bad();
+    }
+#endif
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+};
+
+} // namespace detail
+
+template <class V> std::vector<parse_error> parse(const char *first, const char *last, V &v, const char delimiter = '\n', const int base = defaults::base) {
+    // shards start after a line end, so that each knows its first line from the counts
+    const size_t bytes = static_cast<size_t>(last - first);
+    const size_t wanted = bytes / parse_shard_bytes;
+    const int threads = blas::get_num_threads();
+    const int parts = wanted < 1 ? 1 : (wanted < static_cast<size_t>(threads) ? static_cast<int>(wanted) : threads);
+    std::vector<const char *> cuts(parts + 1, last);
+    cuts[0] = first;
+    for (int p = 1; p < parts; p++) {
+        const char *c = std::max(first + bytes * p / parts, cuts[p - 1]);
+        while (c < last && c[-1] != '\n')
+            c++;
+        cuts[p] = c;
+    }
+
+    std::vector<size_t> values(parts + 1, 0), lines(parts + 1, 0);
+    blas::parallel_for(parts, parts, [&](int p, long, long) {
+        size_t count = 0;
+        lines[p + 1] = detail::fields(cuts[p], cuts[p + 1], delimiter, 0, [&](const char *, const char *, size_t) { count++; });
+        values[p + 1] = count;
+    });
+    lines[0] = 1;
+    for (int p = 0; p < parts; p++) {
+        values[p + 1] += values[p];
+        lines[p + 1] += lines[p];
+    }
+    v.resize(values[parts]);
+
+    std::vector<std::vector<parse_error>> errors(parts);
+    blas::parallel_for(parts, parts, [&](int p, long, long) {
+        size_t i = values[p];
+        std::string copy;
+        detail::fields(cuts[p], cuts[p + 1], delimiter, lines[p], [&](const char *b, const char *e, const size_t line) {
+            mpfr_ptr x = detail::target(v, i);
+            copy.assign(b, e); // mpfr_strtofr takes the strlen of what it is given
+            char *end;
+            mpfr_strtofr(x, copy.c_str(), &end, base, defaults::rnd);
+            if (end != copy.c_str() + copy.size()) {
+                mpfr_set_nan(x);
+                errors[p].push_back({i, line, std::string(b, std::min<size_t>(e - b, 80)), end == copy.c_str() ? "not a number" : "trailing characters"});
+            }
+            i++;
+        });
+    });
+    std::vector<parse_error> all;
+    for (auto &e : errors)
+        all.insert(all.end(), std::make_move_iterator(e.begin()), std::make_move_iterator(e.end()));
+    return all;
+}
+template <class V> std::vector<parse_error> read(const char *path, V &v, const char delimiter = '\n', const int base = defaults::base) {
+    detail::mapped_file f(path);
+    if (!f.ok)
+        return {{parse_error::npos, 0, path, "cannot read the file"}};
+    return parse(f.data, f.data + f.size, v, delimiter, base);
+}
+
+} // namespace format
+} // namespace mpfr
+
+#endif
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_LONG_ACCUMULATOR_H_
+#define _MPFR_LONG_ACCUMULATOR_H_
+
+#include "mpfr_class.h"
+#include "mpfr_blas.h"
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// mpfr_long_accumulator: a Kulisch-style fixed-point accumulator.
+//
+// The accumulator holds sums of products exactly in two limb buffers, one for positive
+// and one for negative terms, that cover bit positions [lsb, msb) of a fixed window.
+// A product is formed exactly with mpn_mul from the significands and added at its
+// bit offset; nothing is normalized or rounded until result(), which rounds the exact
+// sum once. A term outside the window, wider than max_prec, or NaN or infinite is kept
+// aside and result() then falls back to mpfr_dot over the window sum and those terms,
+// which is still correctly rounded.
+//
+//   long_dot(n, x, y)   dot product through the accumulator, window taken from the data
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+
+class mpfr_long_accumulator {
+  public:
+    // products with exponents (as mpfr_get_exp) in [emin, emax] of operands of at most
+    // max_prec bits; the window grows by 64 bits of headroom for carries
+    mpfr_long_accumulator(mpfr_exp_t emin, mpfr_exp_t emax, mpfr_prec_t max_prec = defaults::prec)
+        : emin(emin), emax(emax), max_limbs(limbs(max_prec)), lsb(emin - 2 * max_limbs * GMP_NUMB_BITS),
+          len(static_cast<mp_size_t>((emax + GMP_NUMB_BITS - lsb) / GMP_NUMB_BITS + 1)), pos(len), neg(len), scratch(2 * max_limbs + 1) {
+        mpfr_init2(one, 2);
+        mpfr_set_ui(one, 1, MPFR_RNDN);
+    }
+    mpfr_long_accumulator(const mpfr_long_accumulator &op)
+        : emin(op.emin), emax(op.emax), max_limbs(op.max_limbs), lsb(op.lsb), len(op.len), pos(op.pos), neg(op.neg), scratch(op.scratch.size()), aside(op.aside),
+          nonzero(op.nonzero), zeros(op.zeros) {
+        mpfr_init2(one, 2);
+        mpfr_set_ui(one, 1, MPFR_RNDN);
+        for (auto &a : aside)
+            if (a.second == op.one)
+                a.second = one;
+    }
+    mpfr_long_accumulator &operator=(const mpfr_long_accumulator &) = delete;
+    ~mpfr_long_accumulator() { mpfr_clear(one); }
+
+    // Adds a * b. The operands of terms kept aside must live until result().
+    void add_product(mpfr_srcptr a, mpfr_srcptr b) {
+        if (mpfr_zero_p(a) || mpfr_zero_p(b)) {
+            if (!mpfr_number_p(a) || !mpfr_number_p(b)) // 0 * Inf or NaN
+                aside.emplace_back(a, b);
+            else
+                zeros |= (mpfr_signbit(a) != 0) != (mpfr_signbit(b) != 0) ? minus_zero : plus_zero;
+            return;
+        }
+        nonzero = true;
+        const mp_size_t na = limbs(mpfr_get_prec(a)), nb = limbs(mpfr_get_prec(b));
+        if (!mpfr_regular_p(a) || !mpfr_regular_p(b) || na > max_limbs || nb > max_limbs || !fits(mpfr_get_exp(a) + mpfr_get_exp(b))) {
+            aside.emplace_back(a, b);
+            return;
+        }
+        const mp_limb_t *ma = significand(a), *mb = significand(b);
+        if (na >= nb)
+            mpn_mul(scratch.data(), ma, na, mb, nb);
+        else
+            mpn_mul(scratch.data(), mb, nb, ma, na);
+        add_limbs((mpfr_signbit(a) != 0) != (mpfr_signbit(b) != 0), na + nb, mpfr_get_exp(a) + mpfr_get_exp(b) - (na + nb) * GMP_NUMB_BITS);
+    }
+    template <class A, class B, typename std::enable_if<is_mpfr_leaf<A>::value && is_mpfr_leaf<B>::value, int>::type = 0> void add_product(const A &a, const B &b) {
+        add_product(a.get_mpfr_t(), b.get_mpfr_t());
+    }
+    // Adds x, which must live until result() if it is kept aside.
+    void add(mpfr_srcptr x) {
+        const mp_size_t n = limbs(mpfr_get_prec(x));
+        if (mpfr_zero_p(x)) {
+            zeros |= mpfr_signbit(x) ? minus_zero : plus_zero;
+            return;
+        }
+        nonzero = true;
+        if (!mpfr_regular_p(x) || n > 2 * max_limbs || !fits(mpfr_get_exp(x))) {
+            aside.emplace_back(x, one);
+            return;
+        }
+        std::copy(significand(x), significand(x) + n, scratch.begin());
+        add_limbs(mpfr_signbit(x) != 0, n, mpfr_get_exp(x) - n * GMP_NUMB_BITS);
+    }
+    template <class T, typename std::enable_if<is_mpfr_leaf<T>::value, int>::type = 0> void add(const T &x) { add(x.get_mpfr_t()); }
+
+    // Merges another accumulator with the same window; exact.
+    mpfr_long_accumulator &operator+=(const mpfr_long_accumulator &op) {
+        if (op.lsb != lsb || op.len != len) {
+            std::cerr << "Error: accumulators with different windows" << std::endl;
+            throw std::runtime_error("Accumulators with different windows.");
+        }
+        mpn_add_n(pos.data(), pos.data(), op.pos.data(), len);
+        mpn_add_n(neg.data(), neg.data(), op.neg.data(), len);
+        for (const auto &a : op.aside)
+            aside.emplace_back(a.first, a.second == op.one ? one : a.second);
+        nonzero = nonzero || op.nonzero;
+        zeros |= op.zeros;
+        return *this;
+    }
+
+    // The exact sum rounded once at the default precision. An exact zero has the sign
+    // mpfr_sum gives it: that of the terms if all are zeros of one sign, else + except
+    // under MPFR_RNDD.
+    mpfr_class result(mpfr_rnd_t rnd = defaults::rnd) const {
+        mpfr_class rop(0.0);
+        std::vector<mp_limb_t> d(len);
+        const bool negative = mpn_cmp(pos.data(), neg.data(), len) < 0;
+        if (negative)
+            mpn_sub_n(d.data(), neg.data(), pos.data(), len);
+        else
+            mpn_sub_n(d.data(), pos.data(), neg.data(), len);
+        mpz_t z;
+        mpz_roinit_n(z, d.data(), negative ? -len : len);
+        if (aside.empty()) {
+            mpfr_set_z_2exp(rop.get_mpfr_t(), z, lsb, rnd);
+            if (mpfr_zero_p(rop.get_mpfr_t())) {
+                const bool mixed = nonzero || zeros == (plus_zero | minus_zero);
+                mpfr_set_zero(rop.get_mpfr_t(), (mixed ? rnd == MPFR_RNDD : zeros == minus_zero) ? -1 : 1);
+            }
+            return rop;
+        }
+        // the window sum exactly, as one more term of mpfr_dot
+        mpfr_t w;
+        mpfr_init2(w, len * GMP_NUMB_BITS);
+        mpfr_set_z_2exp(w, z, lsb, MPFR_RNDN);
+        std::vector<mpfr_ptr> x(aside.size() + 1), y(aside.size() + 1);
+        x[0] = w;
+        y[0] = const_cast<mpfr_ptr>(static_cast<mpfr_srcptr>(one));
+        for (size_t i = 0; i < aside.size(); i++) { // mpfr_dot only reads through these
+            x[i + 1] = const_cast<mpfr_ptr>(aside[i].first);
+            y[i + 1] = const_cast<mpfr_ptr>(aside[i].second);
+        }
+        mpfr_dot(rop.get_mpfr_t(), x.data(), y.data(), x.size(), rnd);
+        mpfr_clear(w);
+        return rop;
+    }
+    void clear() {
+        std::fill(pos.begin(), pos.end(), 0);
+        std::fill(neg.begin(), neg.end(), 0);
+        aside.clear();
+        nonzero = false;
+        zeros = 0;
+    }
+    // terms that did not fit the window
+    size_t outside() const { return aside.size(); }
+
+  private:
+    static mp_size_t limbs(mpfr_prec_t prec) { return static_cast<mp_size_t>((prec + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS); }
+    static const mp_limb_t *significand(mpfr_srcptr x) { return static_cast<const mp_limb_t *>(mpfr_custom_get_significand(x)); }
+    bool fits(mpfr_exp_t e) const { return e >= emin && e <= emax; }
+    // adds scratch[0, n) * 2^low into the buffer of its sign
+    void add_limbs(bool negative, mp_size_t n, mpfr_exp_t low) {
+        std::vector<mp_limb_t> &acc = negative ? neg : pos;
+        const mpfr_exp_t off = low - lsb;
+        const mp_size_t q = static_cast<mp_size_t>(off / GMP_NUMB_BITS);
+        const unsigned s = static_cast<unsigned>(off % GMP_NUMB_BITS);
+        scratch[n] = s ? mpn_lshift(scratch.data(), scratch.data(), n, s) : 0;
+        mp_limb_t c = mpn_add_n(acc.data() + q, acc.data() + q, scratch.data(), n + 1);
+        for (mp_size_t i = q + n + 1; c && i < len; i++)
+            c = ++acc[i] == 0;
+    }
+
+    mpfr_exp_t emin, emax;
+    mp_size_t max_limbs;
+    mpfr_exp_t lsb; // weight of bit 0 of the buffers
+    mp_size_t len;
+    std::vector<mp_limb_t> pos, neg, scratch;
+    std::vector<std::pair<mpfr_srcptr, mpfr_srcptr>> aside;
+    // for the sign of an exact zero: whether a nonzero term was added, and which zeros
+    static constexpr unsigned plus_zero = 1, minus_zero = 2;
+    bool nonzero = false;
+    unsigned zeros = 0;
+    mpfr_t one;
+};
+
+// Exact dot product rounded once, through per-thread long accumulators merged in order.
+// The window spans the exponents of the products; beyond max_window_bits it would cost
+// more than it saves, and mpfr_dot is used instead.
+constexpr mpfr_exp_t long_dot_max_window_bits = 4096;
+template <class X, class Y> inline mpfr_class long_dot(const long n, X x, Y y) {
+    bool any = false;
+    mpfr_exp_t lo = 0, hi = 0;
+    mpfr_prec_t prec = MPFR_PREC_MIN;
+    for (long i = 0; i < n; i++) {
+        mpfr_srcptr a = x[i].get_mpfr_t(), b = y[i].get_mpfr_t();
+        prec = std::max({prec, mpfr_get_prec(a), mpfr_get_prec(b)});
+        if (!mpfr_regular_p(a) || !mpfr_regular_p(b))
+            continue;
+        const mpfr_exp_t e = mpfr_get_exp(a) + mpfr_get_exp(b);
+        lo = any ? std::min(lo, e) : e;
+        hi = any ? std::max(hi, e) : e;
+        any = true;
+    }
+    if (!any || hi - lo > long_dot_max_window_bits)
+        return blas::dot(n, x, y);
+    const int parts = blas::parts_for(n);
+    std::vector<mpfr_long_accumulator> acc(parts, mpfr_long_accumulator(lo, hi, prec));
+    blas::parallel_for(parts, n, [&](int p, long begin, long end) {
+        for (long i = begin; i < end; i++)
+            acc[p].add_product(x[i].get_mpfr_t(), y[i].get_mpfr_t());
+    });
+    for (int p = 1; p < parts; p++)
+        acc[0] += acc[p];
+    return acc[0].result();
+}
+
+} // namespace mpfr
+
+#endif
@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_PROFILE_H_
+#define _MPFR_PROFILE_H_
+
+#include <mpfr.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#if __cplusplus >= 202002L && __has_include(<source_location>)
+#include <source_location>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Precision profiler, compiled in with -DMPFR_CLASS_PROFILE and compiled out otherwise.
+//
+// Mark the functions to look at with a region; every +, -, *, / and fused multiply-add
+// of mpfr_class evaluated while it is the innermost region of the thread is charged to
+// its source location (std::source_location under C++20, the equivalent compiler
+// builtins under C++17). Operations outside any region are charged to one site of their own.
+//
+//   void calculate_sequence(int prec) {
+//       mpfr::profile::region profile;
+//       ...
+//   }
+//   mpfr::profile::report();   // to std::cerr
+//
+// Per site it records the precisions of the results and operands, results wider than
+// all of their operands, and cancellation: an addition or subtraction whose result has
+// k fewer leading bits than its larger operand lost k bits of accuracy. The suggested
+// precision is the target accuracy (53 bits unless set_target_bits says otherwise) plus
+// the largest loss in one operation. Where losses compound, as in recurrences like
+// example08's, the losses summed over one call of the region give the upper figure,
+// compounded_prec; convergence tests and sums of terms of both signs inflate it. The
+// mathematical functions are not profiled.
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+namespace profile {
+
+#ifdef MPFR_CLASS_PROFILE
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+struct site {
+    const char *file;
+    unsigned line;
+    const char *function;
+};
+
+struct site_summary {
+    std::string file, function;              // empty for the operations outside any region
+    unsigned line = 0;
+    unsigned long long calls = 0;            // times the region was entered
+    unsigned long long operations = 0;
+    mpfr_prec_t min_result_prec = 0, max_result_prec = 0;
+    mpfr_prec_t max_operand_prec = 0;        // doubles count as 53 bits, integers as their length
+    unsigned long long over_provisioned = 0; // results wider than every operand
+    unsigned long long cancellations = 0;    // operations losing at least catastrophic_bits()
+    long max_cancelled_bits = 0;             // in one operation
+    long max_call_cancelled_bits = 0;        // summed over one call of the region
+    mpfr_prec_t suggested_prec = 0;          // target_bits() + max_cancelled_bits, in whole limbs
+    mpfr_prec_t compounded_prec = 0;         // target_bits() + max_call_cancelled_bits, in whole limbs
+};
+
+namespace detail {
+
+inline std::atomic<long> target{53};
+inline std::atomic<long> catastrophic{8};
+
+// what the profiler needs to know of an operand
+struct operand {
+    mpfr_prec_t prec;
+    mpfr_exp_t exp;
+    bool regular; // nonzero and finite: exp is meaningful
+};
+inline operand describe(mpfr_srcptr x) {
+    const bool regular = mpfr_regular_p(x) != 0;
+    return {mpfr_get_prec(x), regular ? mpfr_get_exp(x) : 0, regular};
+}
+inline operand describe(const double x) {
+    int exp = 0;
+    std::frexp(x, &exp);
+    return {53, exp, std::isfinite(x) && x != 0};
+}
+inline operand describe(const unsigned long x) {
+    mpfr_prec_t bits = 0;
+    for (unsigned long y = x; y != 0; y >>= 1)
+        bits++;
+    return {bits > 0 ? bits : 1, bits, x != 0};
+}
+inline operand describe(const long x) { return describe(x < 0 ? 0UL - static_cast<unsigned long>(x) : static_cast<unsigned long>(x)); }
+inline operand describe(mpz_srcptr x) {
+    const mpfr_prec_t bits = static_cast<mpfr_prec_t>(mpz_sizeinbase(x, 2));
+    return {bits, bits, mpz_sgn(x) != 0};
+}
+inline operand describe(mpq_srcptr x) {
+    const mpfr_prec_t num = static_cast<mpfr_prec_t>(mpz_sizeinbase(mpq_numref(x), 2));
+    const mpfr_prec_t den = static_cast<mpfr_prec_t>(mpz_sizeinbase(mpq_denref(x), 2));
+    return {std::max(num, den), num - den + 1, mpq_sgn(x) != 0};
+}
+// a * b as the addend of a fused multiply-add; exponent within one of the true one
+inline operand product(const operand &a, const operand &b) { return {std::max(a.prec, b.prec), a.exp + b.exp, a.regular && b.regular}; }
+
+struct site_data {
+    unsigned long long calls = 0, operations = 0, over_provisioned = 0, cancellations = 0;
+    mpfr_prec_t min_result_prec = 0, max_result_prec = 0, max_operand_prec = 0;
+    long max_cancelled_bits = 0, max_call_cancelled_bits = 0;
+    void merge(const site_data &d) {
+        if (d.operations != 0) {
+            min_result_prec = operations == 0 ? d.min_result_prec : std::min(min_result_prec, d.min_result_prec);
+            max_result_prec = std::max(max_result_prec, d.max_result_prec);
+        }
+        calls += d.calls;
+        operations += d.operations;
+        over_provisioned += d.over_provisioned;
+        cancellations += d.cancellations;
+        max_operand_prec = std::max(max_operand_prec, d.max_operand_prec);
+        max_cancelled_bits = std::max(max_cancelled_bits, d.max_cancelled_bits);
+        max_call_cancelled_bits = std::max(max_call_cancelled_bits, d.max_call_cancelled_bits);
+    }
+};
+
+// sites are told apart by the address of the file name and the line
+using site_key = std::pair<const char *, unsigned>;
+struct site_record {
+    site where;
+    site_data data;
+};
+using site_map = std::map<site_key, site_record>;
+
+inline void merge(site_map &into, const site_map &from) {
+    for (const auto &s : from) {
+        site_record &r = into.emplace(s.first, site_record{s.second.where, site_data()}).first->second;
+        r.data.merge(s.second.data);
+    }
+}
+
+struct region_state;
+
+// Per-thread sites. The owning thread updates them under mutex, which only snapshot()
+// ever contends for.
+struct thread_data {
+    std::mutex mutex;
+    site_map sites;
+    region_state *current = nullptr; // innermost region of the thread
+    site_data *outside = nullptr;    // the site of the operations outside any region
+};
+
+inline std::mutex registry_mutex;
+inline std::vector<thread_data *> registry;
+inline site_map retired; // sites of threads which have exited
+
+struct thread_registration {
+    thread_registration() {
+        t.outside = &t.sites.emplace(site_key(nullptr, 0), site_record{site{nullptr, 0, nullptr}, site_data()}).first->second.data;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(&t);
+    }
+    ~thread_registration() {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        merge(retired, t.sites);
+        for (auto it = registry.begin(); it != registry.end(); ++it) {
+            if (*it == &t) {
+                registry.erase(it);
+                break;
+            }
+        }
+    }
+    thread_data t;
+};
+
+// As in mpfr_stats.h: operations late during thread exit are not profiled.
+inline thread_local thread_registration *this_thread_ptr = nullptr;
+inline thread_local bool this_thread_dead = false;
+struct thread_guard {
+    ~thread_guard() {
+        delete this_thread_ptr;
+        this_thread_ptr = nullptr;
+        this_thread_dead = true;
+    }
+};
+inline thread_data *this_thread() {
+    if (this_thread_ptr == nullptr) {
+        if (this_thread_dead)
+            return nullptr;
+        static thread_local thread_guard guard;
+        (void)guard;
+        this_thread_ptr = new thread_registration;
+    }
+    return &this_thread_ptr->t;
+}
+
+struct region_state {
+    explicit region_state(const site &where) {
+        t = this_thread();
+        if (t == nullptr)
+            return;
+        std::lock_guard<std::mutex> lock(t->mutex);
+        data = &t->sites.emplace(site_key(where.file, where.line), site_record{where, site_data()}).first->second.data;
+        data->calls++;
+        outer = t->current;
+        t->current = this;
+    }
+    ~region_state() {
+        if (t == nullptr)
+            return;
+        std::lock_guard<std::mutex> lock(t->mutex);
+        data->max_call_cancelled_bits = std::max(data->max_call_cancelled_bits, cancelled_bits);
+        t->current = outer;
+    }
+    region_state(const region_state &) = delete;
+    region_state &operator=(const region_state &) = delete;
+
+    thread_data *t = nullptr;
+    site_data *data = nullptr;
+    region_state *outer = nullptr;
+    long cancelled_bits = 0; // summed over this call
+};
+
+// rop has just been computed from x and y; additive for sums, differences and fused
+// multiply-adds, where cancellation can happen
+inline void note(const operand &x, const operand &y, const bool additive, mpfr_srcptr rop) {
+    thread_data *t = this_thread();
+    if (t == nullptr)
+        return;
+    std::lock_guard<std::mutex> lock(t->mutex);
+    site_data &d = t->current != nullptr ? *t->current->data : *t->outside;
+    const mpfr_prec_t prec = mpfr_get_prec(rop);
+    d.min_result_prec = d.operations == 0 ? prec : std::min(d.min_result_prec, prec);
+    d.max_result_prec = std::max(d.max_result_prec, prec);
+    d.operations++;
+    const mpfr_prec_t operand_prec = std::max(x.prec, y.prec);
+    d.max_operand_prec = std::max(d.max_operand_prec, operand_prec);
+    if (prec > operand_prec)
+        d.over_provisioned++;
+    if (!additive || !x.regular || !y.regular || !mpfr_regular_p(rop))
+        return;
+    const long lost = static_cast<long>(std::max(x.exp, y.exp) - mpfr_get_exp(rop));
+    if (lost <= 0)
+        return;
+    d.max_cancelled_bits = std::max(d.max_cancelled_bits, lost);
+    if (lost >= catastrophic.load(std::memory_order_relaxed))
+        d.cancellations++;
+    if (t->current != nullptr)
+        t->current->cancelled_bits += lost;
+}
+
+inline mpfr_prec_t suggest(const long cancelled_bits) {
+    const long bits = target.load(std::memory_order_relaxed) + cancelled_bits;
+    return static_cast<mpfr_prec_t>((bits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS * GMP_NUMB_BITS);
+}
+
+} // namespace detail
+
+// The accuracy the suggested precisions aim at, in bits; 53 by default.
+inline void set_target_bits(const long bits) { detail::target.store(bits, std::memory_order_relaxed); }
+inline long target_bits() { return detail::target.load(std::memory_order_relaxed); }
+// Losses of at least this many bits in one operation count as cancellations; 8 by default.
+inline void set_catastrophic_bits(const long bits) { detail::catastrophic.store(bits, std::memory_order_relaxed); }
+inline long catastrophic_bits() { return detail::catastrophic.load(std::memory_order_relaxed); }
+
+#ifdef MPFR_CLASS_PROFILE
+class region {
+  public:
+#if defined(__cpp_lib_source_location)
+    explicit region(const std::source_location where = std::source_location::current()) : state(site{where.file_name(), where.line(), where.function_name()}) {}
+#else
+    explicit region(const char *file = __builtin_FILE(), unsigned line = __builtin_LINE(), const char *function = __builtin_FUNCTION()) : state(site{file, line, function}) {}
+#endif
+    region(const region &) = delete;
+    region &operator=(const region &) = delete;
+
+  private:
+    detail::region_state state;
+};
+#else
+class region {
+  public:
+    region() {}
+    region(const region &) = delete;
+    region &operator=(const region &) = delete;
+};
+#endif
+
+// The sites of all threads, those which have exited included, busiest first.
+inline std::vector<site_summary> snapshot() {
+    detail::site_map sites;
+    {
+        std::lock_guard<std::mutex> lock(detail::registry_mutex);
+        sites = detail::retired;
+        for (detail::thread_data *t : detail::registry) {
+            std::lock_guard<std::mutex> thread_lock(t->mutex);
+            detail::merge(sites, t->sites);
+        }
+    }
+    std::vector<site_summary> summaries;
+    for (const auto &s : sites) {
+        const detail::site_data &d = s.second.data;
+        if (d.operations == 0 && d.calls == 0)
+            continue;
+        site_summary r;
+        if (s.second.where.file != nullptr) {
+            r.file = s.second.where.file;
+            r.function = s.second.where.function;
+            r.line = s.second.where.line;
+        }
+        r.calls = d.calls;
+        r.operations = d.operations;
+        r.min_result_prec = d.min_result_prec;
+        r.max_result_prec = d.max_result_prec;
+        r.max_operand_prec = d.max_operand_prec;
+        r.over_provisioned = d.over_provisioned;
+        r.cancellations = d.cancellations;
+        r.max_cancelled_bits = d.max_cancelled_bits;
+        r.max_call_cancelled_bits = d.max_call_cancelled_bits;
+        r.suggested_prec = detail::suggest(d.max_cancelled_bits);
+        r.compounded_prec = detail::suggest(std::max(d.max_cancelled_bits, d.max_call_cancelled_bits));
+        summaries.push_back(r);
+    }
+    std::stable_sort(summaries.begin(), summaries.end(), [](const site_summary &a, const site_summary &b) { return a.operations > b.operations; });
+    return summaries;
+}
+
+// Forgets every site. Regions active at the time keep counting into fresh sites.
+inline void reset() {
+    std::lock_guard<std::mutex> lock(detail::registry_mutex);
+    detail::retired.clear();
+    for (detail::thread_data *t : detail::registry) {
+        std::lock_guard<std::mutex> thread_lock(t->mutex);
+        for (auto &s : t->sites) {
+            const unsigned long long calls = s.second.data.calls;
+            s.second.data = detail::site_data();
+            s.second.data.calls = calls;
+        }
+    }
+}
+
+inline void report(std::ostream &os, const std::vector<site_summary> &sites) {
+    const std::ios_base::fmtflags flags = os.flags();
+    os << "mpfr_class precision profile";
+    if (!enabled)
+        os << " (not compiled in, build with -DMPFR_CLASS_PROFILE)";
+    os << ", target " << target_bits() << " bits\n";
+    for (const site_summary &s : sites) {
+        if (s.file.empty())
+            os << "(outside any region)\n";
+        else
+            os << s.file << ":" << s.line << " " << s.function << "\n";
+        os << "    " << s.calls << " calls, " << s.operations << " operations at " << s.min_result_prec;
+        if (s.max_result_prec != s.min_result_prec)
+            os << ".." << s.max_result_prec;
+        os << " bits, operands up to " << s.max_operand_prec << " bits\n";
+        if (s.over_provisioned != 0)
+            os << "    " << s.over_provisioned << " results wider than their operands\n";
+        if (s.max_cancelled_bits != 0)
+            os << "    cancellation: " << s.cancellations << " operations lost " << catastrophic_bits() << " bits or more, at most " << s.max_cancelled_bits << " bits at once, " << s.max_call_cancelled_bits << " bits in one call\n";
+        os << "    suggested precision " << s.suggested_prec << " bits";
+        if (s.compounded_prec != s.suggested_prec)
+            os << ", " << s.compounded_prec << " if the losses compound";
+        if (s.operations != 0 && s.suggested_prec < s.max_result_prec)
+            os << "; over-provisioned, runs at up to " << s.max_result_prec;
+        else if (s.operations != 0 && s.suggested_prec > s.max_result_prec)
+            os << "; under-provisioned, runs at up to " << s.max_result_prec;
+        os << "\n";
+    }
+    os.flags(flags);
+}
+inline void report(std::ostream &os = std::cerr) { report(os, snapshot()); }
+
+} // namespace profile
+} // namespace mpfr
+
+#endif
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_REDUCE_H_
+#define _MPFR_REDUCE_H_
+
+#include "mpfr_class.h"
+#include "mpfr_blas.h"
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Reproducible parallel summation and reduction.
+//
+//   sum(range)          correctly rounded sum, as mpfr_sum, split across threads
+//   reduce(range, op)   op folded over fixed chunks, then over the chunk results
+//   mpfr_accumulator    exact sum many threads add() into at once
+//
+// A range is anything with begin() and end() random-access iterators to mpfr leaves:
+// std::vector<mpfr_class>, mpfr_vector, arrays. Threads follow blas::set_num_threads().
+// Every result is bitwise the same for any thread count: sum and mpfr_accumulator add
+// exactly and round once at the end; reduce fixes the grouping independently of the
+// threads, which is as far as a general op allows.
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+
+// Above this a partial sum is not worth holding exactly: sum() adds serially, and
+// mpfr_exact_add() declines.
+constexpr mpfr_prec_t exact_sum_max_prec = mpfr_prec_t(1) << 20;
+
+// Adds x to s exactly, first raising the precision of s to cover both operands, and
+// returns true; returns false, leaving s as it is, if that takes more than
+// exact_sum_max_prec bits. s must not be shared with another thread. The precision only
+// grows.
+inline bool mpfr_exact_add(mpfr_ptr s, mpfr_srcptr x, mpfr_rnd_t rnd) {
+    if (mpfr_regular_p(x) && mpfr_zero_p(s)) {
+        if (mpfr_get_prec(s) < mpfr_get_prec(x))
+            mpfr_set_prec(s, mpfr_get_prec(x));
+        mpfr_set(s, x, rnd);
+        return true;
+    }
+    if (mpfr_regular_p(x) && mpfr_regular_p(s)) {
+        const mpfr_exp_t hi = std::max(mpfr_get_exp(s), mpfr_get_exp(x)) + 1;
+        const mpfr_exp_t lo = std::min(mpfr_get_exp(s) - mpfr_get_prec(s), mpfr_get_exp(x) - mpfr_get_prec(x));
+        if (hi - lo > exact_sum_max_prec)
+            return false;
+        if (hi - lo > mpfr_get_prec(s))
+            mpfr_prec_round(s, hi - lo, MPFR_RNDN); // widening is exact
+    }
+    mpfr_add(s, s, x, rnd); // exact, or NaN, an infinity or a signed zero
+    return true;
+}
+
+// Precision that holds the sum of n values exactly, from the largest exponent and the
+// lowest bit position among them; 0 if none is regular.
+inline mpfr_prec_t mpfr_exact_sum_prec(const mpfr_ptr *x, const unsigned long n) {
+    bool regular = false;
+    mpfr_exp_t hi = 0, lo = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        if (!mpfr_regular_p(x[i]))
+            continue;
+        const mpfr_exp_t e = mpfr_get_exp(x[i]), l = e - mpfr_get_prec(x[i]);
+        hi = regular ? std::max(hi, e) : e;
+        lo = regular ? std::min(lo, l) : l;
+        regular = true;
+    }
+    if (!regular)
+        return 0;
+    mpfr_prec_t carry = 1;
+    for (unsigned long c = n; c > 0; c >>= 1)
+        carry++;
+    return hi - lo + carry;
+}
+
+template <class It> inline mpfr_class sum(It first, It last) {
+    mpfr_class rop(0.0);
+    const long n = static_cast<long>(last - first);
+    std::vector<mpfr_ptr> x(n > 0 ? n : 0); // mpfr_sum only reads through these
+    for (long i = 0; i < n; i++)
+        x[i] = const_cast<mpfr_ptr>(static_cast<mpfr_srcptr>(first[i].get_mpfr_t()));
+    const int parts = blas::parts_for(n);
+    // the shards are summed exactly, so splitting does not change the rounded total
+    std::vector<mpfr_class> partial(parts);
+    std::atomic<bool> too_wide{false};
+    if (parts > 1) {
+        blas::parallel_for(parts, n, [&](int p, long begin, long end) {
+            const mpfr_prec_t prec = mpfr_exact_sum_prec(x.data() + begin, end - begin);
+            if (prec > exact_sum_max_prec) {
+                too_wide = true;
+                return;
+            }
+            partial[p].set_prec(prec > 0 ? prec : MPFR_PREC_MIN);
+            mpfr_sum(partial[p].get_mpfr_t(), x.data() + begin, end - begin, defaults::rnd);
+        });
+    }
+    if (parts > 1 && !too_wide) {
+        std::vector<mpfr_ptr> px(parts);
+        for (int p = 0; p < parts; p++)
+            px[p] = partial[p].get_mpfr_t();
+        mpfr_sum(rop.get_mpfr_t(), px.data(), parts, defaults::rnd);
+    } else {
+        mpfr_sum(rop.get_mpfr_t(), x.data(), n, defaults::rnd);
+    }
+    return rop;
+}
+template <class Range> inline mpfr_class sum(const Range &r) { return sum(std::begin(r), std::end(r)); }
+
+// Folds op(acc, x) left to right over chunks of reduce_chunk elements, then over the
+// chunk results in order. op(a, b) takes an mpfr_class a and an element or mpfr_class b
+// and returns an mpfr_class or an expression. The grouping depends on reduce_chunk
+// only. An empty range gives NaN.
+constexpr long reduce_chunk = 1024;
+template <class It, class Op> inline mpfr_class reduce(It first, It last, Op op) {
+    const long n = static_cast<long>(last - first);
+    if (n <= 0)
+        return mpfr_class();
+    const long chunks = (n + reduce_chunk - 1) / reduce_chunk;
+    std::vector<mpfr_class> partial(chunks);
+    blas::parallel_for(blas::parts_for(n) < chunks ? blas::parts_for(n) : static_cast<int>(chunks), chunks, [&](int, long begin, long end) {
+        for (long c = begin; c < end; c++) {
+            mpfr_class &acc = partial[c];
+            const long i1 = (c + 1) * reduce_chunk < n ? (c + 1) * reduce_chunk : n;
+            acc = first[c * reduce_chunk];
+            for (long i = c * reduce_chunk + 1; i < i1; i++)
+                acc = op(acc, first[i]);
+        }
+    });
+    for (long c = 1; c < chunks; c++)
+        partial[0] = op(partial[0], partial[c]);
+    return std::move(partial[0]);
+}
+template <class Range, class Op> inline mpfr_class reduce(const Range &r, Op op) { return reduce(std::begin(r), std::end(r), op); }
+
+// An exact running sum that any number of threads add() into concurrently. Each add
+// claims a free shard with an atomic flag, so threads never wait on a mutex and only
+// retry when every shard is taken. Shards keep their sums exact, so result() does not
+// depend on which thread added what, or in which order. A value too far in magnitude from
+// a shard's sum to be held with it in exact_sum_max_prec bits goes to a further exact sum
+// of that shard, so the precision stays bounded; result() rounds all of them at once.
+// result() and clear() must not run concurrently with add().
+class mpfr_accumulator {
+  public:
+    explicit mpfr_accumulator(unsigned shards = std::thread::hardware_concurrency()) : n(shards > 0 ? shards : 1), shard(new slot[n]) {
+        for (unsigned i = 0; i < n; i++) {
+            mpfr_init2(shard[i].sum, MPFR_PREC_MIN);
+            mpfr_set_zero(shard[i].sum, 1);
+        }
+    }
+    ~mpfr_accumulator() {
+        for (unsigned i = 0; i < n; i++)
+            mpfr_clear(shard[i].sum);
+    }
+    mpfr_accumulator(const mpfr_accumulator &) = delete;
+    mpfr_accumulator &operator=(const mpfr_accumulator &) = delete;
+
+    void add(mpfr_srcptr x) {
+        unsigned i = static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id()) % n);
+        for (bool expected = false; !shard[i].busy.compare_exchange_weak(expected, true, std::memory_order_acquire); expected = false)
+            i = i + 1 < n ? i + 1 : 0;
+        if (!mpfr_exact_add(shard[i].sum, x, MPFR_RNDN))
+            add_far(shard[i].far, x);
+        shard[i].busy.store(false, std::memory_order_release);
+    }
+    template <class T, typename std::enable_if<is_mpfr_leaf<T>::value, int>::type = 0> void add(const T &x) { add(x.get_mpfr_t()); }
+    // doubles and integers up to 64 bits are taken exactly
+    template <class S, typename std::enable_if<std::is_arithmetic<S>::value && is_mpfr_scalar<S>::value, int>::type = 0> void add(const S x) {
+        MPFR_DECL_INIT(t, 64);
+        mpfr_scalar_set(t, mpfr_scalar_t<S>(x));
+        add(t);
+    }
+
+    mpfr_class result(mpfr_rnd_t rnd = defaults::rnd) const {
+        mpfr_class rop(0.0);
+        std::vector<mpfr_ptr> px;
+        for (unsigned i = 0; i < n; i++) {
+            px.push_back(shard[i].sum);
+            for (auto &f : shard[i].far)
+                px.push_back(f.get_mpfr_t());
+        }
+        mpfr_sum(rop.get_mpfr_t(), px.data(), px.size(), rnd);
+        return rop;
+    }
+    void clear() {
+        for (unsigned i = 0; i < n; i++) {
+            mpfr_set_prec(shard[i].sum, MPFR_PREC_MIN);
+            mpfr_set_zero(shard[i].sum, 1);
+            shard[i].far.clear();
+        }
+    }
+    unsigned shards() const { return n; }
+
+  private:
+    static void mpfr_scalar_set(mpfr_ptr rop, const double op) { mpfr_set_d(rop, op, MPFR_RNDN); }
+    static void mpfr_scalar_set(mpfr_ptr rop, const long op) { mpfr_set_si(rop, op, MPFR_RNDN); }
+    static void mpfr_scalar_set(mpfr_ptr rop, const unsigned long op) { mpfr_set_ui(rop, op, MPFR_RNDN); }
+    // into the first further sum that holds x exactly, or a new one
+    static void add_far(std::vector<mpfr_class> &far, mpfr_srcptr x) {
+        for (auto &f : far)
+            if (mpfr_exact_add(f.get_mpfr_t(), x, MPFR_RNDN))
+                return;
+        far.emplace_back();
+        far.back().set_prec(mpfr_get_prec(x));
+        mpfr_set(far.back().get_mpfr_t(), x, MPFR_RNDN);
+    }
+
+    struct alignas(64) slot {
+        std::atomic<bool> busy{false};
+        mpfr_t sum;
+        std::vector<mpfr_class> far;
+    };
+    unsigned n;
+    std::unique_ptr<slot[]> shard;
+};
+
+} // namespace mpfr
+
+#endif
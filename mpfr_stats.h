@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+#ifndef _MPFR_STATS_H_
+#define _MPFR_STATS_H_
+
+#include <mpfr.h>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Operation and allocation counters of mpfr_class, compiled in with -DMPFR_CLASS_STATS
+// and compiled out (every hook expands to nothing) otherwise.
+//
+//   * operations are counted per kind and per precision bucket of the destination; a
+//     fused a * b + c counts as one fma, its operands evaluated on their own as usual;
+//   * inits, clears and reallocations of mpfr_class limbs, and expression temporaries
+//     (on the stack or, above MPFR_EXPR_TEMP_LIMBS, on the heap);
+//   * limb bytes in use (mpfr_custom_get_size of the precision) and their peak.
+//
+// Counters are per thread and summed by snapshot(); report() prints them:
+//
+//   mpfr::stats::reset();
+//   phase();
+//   mpfr::stats::report();   // to std::cerr
+//
+// Only mpfr_class goes through the hooks; mpfr_vector storage and the kernels of
+// mpfr_blas.h, mpfr_reduce.h etc., which call MPFR directly, are not counted.
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+namespace stats {
+
+#ifdef MPFR_CLASS_STATS
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+enum op_kind {
+    add,
+    sub,
+    mul,
+    div,
+    fma,            // mpfr_fma, mpfr_fms, mpfr_fmma, mpfr_fmms from fused expressions
+    sqrt,
+    transcendental, // exp, log, trigonometric, pow, gamma, ..., and the constants
+    exact,          // neg, abs, multiplication and division by 2^n
+    op_kinds
+};
+
+// bucket 0 is up to 64 bits, bucket b up to 64 << b bits, the last one everything above
+constexpr int prec_buckets = 10;
+
+inline int prec_bucket(const mpfr_prec_t prec) {
+    int b = 0;
+    for (mpfr_prec_t limit = 64; b < prec_buckets - 1 && prec > limit; limit <<= 1)
+        b++;
+    return b;
+}
+
+inline const char *op_name(const op_kind k) {
+    static const char *const names[op_kinds] = {"add", "sub", "mul", "div", "fma", "sqrt", "transcendental", "exact"};
+    return k >= 0 && k < op_kinds ? names[k] : "?";
+}
+
+struct counters {
+    unsigned long long ops[op_kinds][prec_buckets] = {};
+    unsigned long long inits = 0;            // mpfr_class limbs allocated
+    unsigned long long clears = 0;           // mpfr_class limbs freed
+    unsigned long long reallocs = 0;         // set_prec changing the limb count
+    unsigned long long temporaries = 0;      // intermediate results of expressions
+    unsigned long long heap_temporaries = 0; // of which did not fit on the stack
+    long long live_limb_bytes = 0;           // limb bytes of mpfr_class objects and temporaries now
+    long long peak_limb_bytes = 0;           // highest live_limb_bytes since the last reset()
+
+    unsigned long long total(const op_kind k) const {
+        unsigned long long n = 0;
+        for (int b = 0; b < prec_buckets; b++)
+            n += ops[k][b];
+        return n;
+    }
+    unsigned long long total() const {
+        unsigned long long n = 0;
+        for (int k = 0; k < op_kinds; k++)
+            n += total(static_cast<op_kind>(k));
+        return n;
+    }
+};
+
+namespace detail {
+
+// per-thread counters; written only by the owning thread, read by snapshot()
+struct thread_counters {
+    std::atomic<unsigned long long> ops[op_kinds][prec_buckets] = {};
+    std::atomic<unsigned long long> inits{0}, clears{0}, reallocs{0}, temporaries{0}, heap_temporaries{0};
+    static void bump(std::atomic<unsigned long long> &c, unsigned long long n = 1) { c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    void add_to(counters &s) const {
+        for (int k = 0; k < op_kinds; k++)
+            for (int b = 0; b < prec_buckets; b++)
+                s.ops[k][b] += ops[k][b].load(std::memory_order_relaxed);
+        s.inits += inits.load(std::memory_order_relaxed);
+        s.clears += clears.load(std::memory_order_relaxed);
+        s.reallocs += reallocs.load(std::memory_order_relaxed);
+        s.temporaries += temporaries.load(std::memory_order_relaxed);
+        s.heap_temporaries += heap_temporaries.load(std::memory_order_relaxed);
+    }
+    void clear() {
+        for (int k = 0; k < op_kinds; k++)
+            for (int b = 0; b < prec_buckets; b++)
+                ops[k][b].store(0, std::memory_order_relaxed);
+        for (std::atomic<unsigned long long> *c : {&inits, &clears, &reallocs, &temporaries, &heap_temporaries})
+            c->store(0, std::memory_order_relaxed);
+    }
+};
+
+inline std::mutex registry_mutex;
+inline std::vector<thread_counters *> registry;
+inline counters retired; // counters of threads which have exited
+
+// Objects are freed by other threads than the ones which allocated them, so the bytes in
+// use and their peak are process-wide rather than summed from the threads.
+inline std::atomic<long long> live_limb_bytes{0};
+inline std::atomic<long long> peak_limb_bytes{0};
+
+struct thread_registration {
+    thread_registration() {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(&c);
+    }
+    ~thread_registration() {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        c.add_to(retired);
+        for (auto it = registry.begin(); it != registry.end(); ++it) {
+            if (*it == &c) {
+                registry.erase(it);
+                break;
+            }
+        }
+    }
+    thread_counters c;
+};
+
+// As in mpfr_allocator.h, the counters are reached through a trivially destructible
+// pointer: objects destroyed late during thread exit are then simply not counted.
+inline thread_local thread_registration *this_thread_ptr = nullptr;
+inline thread_local bool this_thread_dead = false;
+struct thread_guard {
+    ~thread_guard() {
+        delete this_thread_ptr;
+        this_thread_ptr = nullptr;
+        this_thread_dead = true;
+    }
+};
+inline thread_counters *this_thread() {
+    if (this_thread_ptr == nullptr) {
+        if (this_thread_dead)
+            return nullptr;
+        static thread_local thread_guard guard;
+        (void)guard;
+        this_thread_ptr = new thread_registration;
+    }
+    return &this_thread_ptr->c;
+}
+
+inline void add_limb_bytes(const long long n) {
+    const long long live = live_limb_bytes.fetch_add(n, std::memory_order_relaxed) + n;
+    long long peak = peak_limb_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_limb_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+inline long long limb_bytes(const mpfr_prec_t prec) { return static_cast<long long>(mpfr_custom_get_size(prec)); }
+
+inline void count_op(const op_kind k, const mpfr_prec_t prec) {
+    if (thread_counters *c = this_thread())
+        thread_counters::bump(c->ops[k][prec_bucket(prec)]);
+}
+inline void count_init(const mpfr_prec_t prec) {
+    if (thread_counters *c = this_thread())
+        thread_counters::bump(c->inits);
+    add_limb_bytes(limb_bytes(prec));
+}
+inline void count_clear(const mpfr_prec_t prec) {
+    if (thread_counters *c = this_thread())
+        thread_counters::bump(c->clears);
+    add_limb_bytes(-limb_bytes(prec));
+}
+inline void count_realloc(const mpfr_prec_t from, const mpfr_prec_t to) {
+    if (limb_bytes(from) == limb_bytes(to))
+        return;
+    if (thread_counters *c = this_thread())
+        thread_counters::bump(c->reallocs);
+    add_limb_bytes(limb_bytes(to) - limb_bytes(from));
+}
+// a temporary on the heap is released again with count_temporary_freed
+inline void count_temporary(const mpfr_prec_t prec, const bool on_heap) {
+    if (thread_counters *c = this_thread()) {
+        thread_counters::bump(c->temporaries);
+        if (on_heap)
+            thread_counters::bump(c->heap_temporaries);
+    }
+    if (on_heap)
+        add_limb_bytes(limb_bytes(prec));
+}
+inline void count_temporary_freed(const mpfr_prec_t prec) { add_limb_bytes(-limb_bytes(prec)); }
+
+} // namespace detail
+
+// The counters of all threads, those which have exited included.
+inline counters snapshot() {
+    counters s;
+    {
+        std::lock_guard<std::mutex> lock(detail::registry_mutex);
+        s = detail::retired;
+        for (const detail::thread_counters *c : detail::registry)
+            c->add_to(s);
+    }
+    s.live_limb_bytes = detail::live_limb_bytes.load(std::memory_order_relaxed);
+    s.peak_limb_bytes = detail::peak_limb_bytes.load(std::memory_order_relaxed);
+    return s;
+}
+
+// Zeroes the counters and restarts the peak from the bytes in use. Threads counting at
+// the same time may lose the odd increment; reset between phases.
+inline void reset() {
+    std::lock_guard<std::mutex> lock(detail::registry_mutex);
+    detail::retired = counters();
+    for (detail::thread_counters *c : detail::registry)
+        c->clear();
+    detail::peak_limb_bytes.store(detail::live_limb_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+inline void report(std::ostream &os, const counters &s) {
+    const std::ios_base::fmtflags flags = os.flags();
+    os << "mpfr_class statistics";
+    if (!enabled)
+        os << " (not compiled in, build with -DMPFR_CLASS_STATS)";
+    os << "\n";
+    // only the buckets which saw an operation get a column
+    bool used[prec_buckets] = {};
+    for (int k = 0; k < op_kinds; k++)
+        for (int b = 0; b < prec_buckets; b++)
+            used[b] = used[b] || s.ops[k][b] != 0;
+    os << std::left << std::setw(16) << "operation" << std::right;
+    for (int b = 0; b < prec_buckets; b++) {
+        if (!used[b])
+            continue;
+        if (b == prec_buckets - 1)
+            os << std::setw(14) << (">" + std::to_string(64L << (b - 1)));
+        else
+            os << std::setw(14) << ("<=" + std::to_string(64L << b));
+    }
+    os << std::setw(14) << "total"
+       << "\n";
+    for (int k = 0; k < op_kinds; k++) {
+        const op_kind kind = static_cast<op_kind>(k);
+        os << std::left << std::setw(16) << op_name(kind) << std::right;
+        for (int b = 0; b < prec_buckets; b++)
+            if (used[b])
+                os << std::setw(14) << s.ops[k][b];
+        os << std::setw(14) << s.total(kind) << "\n";
+    }
+    os << "inits " << s.inits << ", clears " << s.clears << ", reallocs " << s.reallocs << "\n";
+    os << "temporaries " << s.temporaries << " (" << s.heap_temporaries << " on the heap)\n";
+    os << "limb bytes in use " << s.live_limb_bytes << ", peak " << s.peak_limb_bytes << "\n";
+    os.flags(flags);
+}
+inline void report(std::ostream &os = std::cerr) { report(os, snapshot()); }
+
+} // namespace stats
+} // namespace mpfr
+
+#ifdef MPFR_CLASS_STATS
+#define MPFR_CLASS_STATS_OP(kind, prec) ::mpfr::stats::detail::count_op(kind, prec)
+#define MPFR_CLASS_STATS_INIT(prec) ::mpfr::stats::detail::count_init(prec)
+#define MPFR_CLASS_STATS_CLEAR(prec) ::mpfr::stats::detail::count_clear(prec)
+#define MPFR_CLASS_STATS_REALLOC(from, to) ::mpfr::stats::detail::count_realloc(from, to)
+#define MPFR_CLASS_STATS_TEMPORARY(prec, on_heap) ::mpfr::stats::detail::count_temporary(prec, on_heap)
+#define MPFR_CLASS_STATS_TEMPORARY_FREED(prec) ::mpfr::stats::detail::count_temporary_freed(prec)
+#else
+#define MPFR_CLASS_STATS_OP(kind, prec) ((void)0)
+#define MPFR_CLASS_STATS_INIT(prec) ((void)0)
+#define MPFR_CLASS_STATS_CLEAR(prec) ((void)0)
+#define MPFR_CLASS_STATS_REALLOC(from, to) ((void)0)
+#define MPFR_CLASS_STATS_TEMPORARY(prec, on_heap) ((void)0)
+#define MPFR_CLASS_STATS_TEMPORARY_FREED(prec) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2024
+ *      Nakata, Maho
+ *      All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef _MPFR_VECTOR_H_
+#define _MPFR_VECTOR_H_
+
+#include "mpfr_class.h"
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+
+////////////////////////////////////////////////////////////////////////////////////////
+// mpfr_vector: n values of one precision in a single allocation.
+//
+//   | mpfr_ptr[capacity] | __mpfr_struct[capacity] | limbs[capacity * stride] |
+//
+// Each section starts on a cache line; headers and limbs are dense. Elements are handed
+// out as mpfr_ref, which takes part in expressions like mpfr_class does and rounds
+// assignments to the precision of the vector. data() is the mpfr_ptr array mpfr_sum and
+// mpfr_dot take. resize() and set_prec() allocate at most once, whatever the size, but
+// take O(n) time: each new or reset element gets a NaN header, since data() hands the
+// headers to MPFR directly and they cannot be set up on first access. Limbs are not
+// touched.
+////////////////////////////////////////////////////////////////////////////////////////
+namespace mpfr {
+
+inline int mpfr_scalar_set(mpfr_ptr rop, const double op, mpfr_rnd_t rnd) { return mpfr_set_d(rop, op, rnd); }
+inline int mpfr_scalar_set(mpfr_ptr rop, const long op, mpfr_rnd_t rnd) { return mpfr_set_si(rop, op, rnd); }
+inline int mpfr_scalar_set(mpfr_ptr rop, const unsigned long op, mpfr_rnd_t rnd) { return mpfr_set_ui(rop, op, rnd); }
+inline int mpfr_scalar_set(mpfr_ptr rop, mpz_srcptr op, mpfr_rnd_t rnd) { return mpfr_set_z(rop, op, rnd); }
+inline int mpfr_scalar_set(mpfr_ptr rop, mpq_srcptr op, mpfr_rnd_t rnd) { return mpfr_set_q(rop, op, rnd); }
+
+// Read-only element of an mpfr_vector.
+class mpfr_cref {
+  public:
+    explicit mpfr_cref(mpfr_srcptr p) noexcept : ptr(p) {}
+    mpfr_srcptr get_mpfr_t() const { return ptr; }
+    mpfr_prec_t get_prec() const { return mpfr_get_prec(ptr); }
+    bool is_nan() const { return mpfr_nan_p(ptr) != 0; }
+    bool is_inf() const { return mpfr_inf_p(ptr) != 0; }
+    friend std::ostream &operator<<(std::ostream &os, const mpfr_cref &m) { return mpfr_write(os, m.ptr); }
+
+  private:
+    mpfr_srcptr ptr;
+};
+
+// Element of an mpfr_vector. Copying an mpfr_ref copies the reference; assigning to it
+// sets the element, rounded to the element's precision.
+class mpfr_ref {
+  public:
+    explicit mpfr_ref(mpfr_ptr p) noexcept : ptr(p) {}
+    mpfr_ref(const mpfr_ref &) = default;
+    mpfr_ref &operator=(const mpfr_ref &op) {
+        mpfr_set(ptr, op.ptr, defaults::rnd);
+        return *this;
+    }
+    template <class T, typename std::enable_if<is_mpfr_leaf<T>::value, int>::type = 0> mpfr_ref &operator=(const T &op) {
+        mpfr_set(ptr, op.get_mpfr_t(), defaults::rnd);
+        return *this;
+    }
+    template <class Op, class L, class R> mpfr_ref &operator=(const mpfr_expr<Op, L, R> &e) {
+        e.eval(ptr, defaults::rnd);
+        return *this;
+    }
+    template <class S, typename std::enable_if<is_mpfr_scalar<S>::value, int>::type = 0> mpfr_ref &operator=(const S op) {
+        mpfr_scalar_set(ptr, mpfr_scalar_t<S>(op), defaults::rnd);
+        return *this;
+    }
+    template <class T> mpfr_ref &operator+=(const T &rhs) {
+        (*this + rhs).eval(ptr, defaults::rnd);
+        return *this;
+    }
+    template <class T> mpfr_ref &operator-=(const T &rhs) {
+        (*this - rhs).eval(ptr, defaults::rnd);
+        return *this;
+    }
+    template <class T> mpfr_ref &operator*=(const T &rhs) {
+        (*this * rhs).eval(ptr, defaults::rnd);
+        return *this;
+    }
+    template <class T> mpfr_ref &operator/=(const T &rhs) {
+        (*this / rhs).eval(ptr, defaults::rnd);
+        return *this;
+    }
+    operator mpfr_cref() const { return mpfr_cref(ptr); }
+    // the element itself, for calling MPFR directly
+    mpfr_ptr get_mpfr_t() const { return ptr; }
+    mpfr_prec_t get_prec() const { return mpfr_get_prec(ptr); }
+    bool is_nan() const { return mpfr_nan_p(ptr) != 0; }
+    bool is_inf() const { return mpfr_inf_p(ptr) != 0; }
+    friend std::ostream &operator<<(std::ostream &os, const mpfr_ref &m) { return mpfr_write(os, m.ptr); }
+
+  private:
+    mpfr_ptr ptr;
+};
+
+template <> struct is_mpfr_leaf<mpfr_ref> : std::true_type {};
+template <> struct is_mpfr_leaf<mpfr_cref> : std::true_type {};
+
+class mpfr_vector {
+  public:
+    static constexpr size_t alignment = 64;
+
+    template <class Ref, class Ptr> class basic_iterator {
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = mpfr_class;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Ref;
+        explicit basic_iterator(Ptr p) noexcept : p(p) {}
+        Ref operator*() const { return Ref(*p); }
+        Ref operator[](difference_type n) const { return Ref(p[n]); }
+        basic_iterator &operator++() {
+            ++p;
+            return *this;
+        }
+        basic_iterator operator++(int) { return basic_iterator(p++); }
+        basic_iterator &operator--() {
+            --p;
+            return *this;
+        }
+        basic_iterator operator--(int) { return basic_iterator(p--); }
+        basic_iterator &operator+=(difference_type n) {
+            p += n;
+            return *this;
+        }
+        basic_iterator &operator-=(difference_type n) {
+            p -= n;
+            return *this;
+        }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const basic_iterator &a, const basic_iterator &b) { return a.p - b.p; }
+        friend bool operator==(const basic_iterator &a, const basic_iterator &b) { return a.p == b.p; }
+        friend bool operator!=(const basic_iterator &a, const basic_iterator &b) { return a.p != b.p; }
+        friend bool operator<(const basic_iterator &a, const basic_iterator &b) { return a.p < b.p; }
+        friend bool operator>(const basic_iterator &a, const basic_iterator &b) { return a.p > b.p; }
+        friend bool operator<=(const basic_iterator &a, const basic_iterator &b) { return a.p <= b.p; }
+        friend bool operator>=(const basic_iterator &a, const basic_iterator &b) { return a.p >= b.p; }
+
+      private:
+        Ptr p;
+    };
+    using iterator = basic_iterator<mpfr_ref, const mpfr_ptr *>;
+    using const_iterator = basic_iterator<mpfr_cref, const mpfr_ptr *>;
+
+    mpfr_vector() noexcept : prec(defaults::prec), stride(limbs_per_value(defaults::prec)) {}
+    explicit mpfr_vector(size_t n, mpfr_prec_t prec = defaults::prec) : prec(prec), stride(limbs_per_value(prec)) { resize(n); }
+    mpfr_vector(const mpfr_vector &op) : prec(op.prec), stride(op.stride) {
+        allocate(op.n, stride);
+        if (op.n > 0)
+            std::memcpy(limbs, op.limbs, op.n * stride * sizeof(mp_limb_t));
+        for (size_t i = 0; i < op.n; i++) {
+            headers[i] = op.headers[i];
+            mpfr_custom_move(&headers[i], limbs + i * stride);
+        }
+        n = op.n;
+    }
+    mpfr_vector(mpfr_vector &&op) noexcept : mpfr_vector() { swap(op); }
+    mpfr_vector &operator=(mpfr_vector op) noexcept { // copy-and-swap, as mpfr_class
+        swap(op);
+        return *this;
+    }
+    ~mpfr_vector() { release(); }
+    void swap(mpfr_vector &op) noexcept {
+        std::swap(block, op.block);
+        std::swap(ptrs, op.ptrs);
+        std::swap(headers, op.headers);
+        std::swap(limbs, op.limbs);
+        std::swap(n, op.n);
+        std::swap(cap, op.cap);
+        std::swap(limb_cap, op.limb_cap);
+        std::swap(prec, op.prec);
+        std::swap(stride, op.stride);
+    }
+
+    size_t size() const { return n; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return n == 0; }
+    mpfr_prec_t get_prec() const { return prec; }
+
+    mpfr_ref operator[](size_t i) { return mpfr_ref(ptrs[i]); }
+    mpfr_cref operator[](size_t i) const { return mpfr_cref(ptrs[i]); }
+    iterator begin() { return iterator(ptrs); }
+    iterator end() { return iterator(ptrs + n); }
+    const_iterator begin() const { return const_iterator(ptrs); }
+    const_iterator end() const { return const_iterator(ptrs + n); }
+    // mpfr_sum(rop, v.data(), v.size(), rnd), mpfr_dot(rop, x.data(), y.data(), n, rnd)
+    mpfr_ptr *data() { return ptrs; }
+    const mpfr_ptr *data() const { return ptrs; }
+    // The limbs of element i start at limb_data() + i * limb_stride(), all in one block.
+    mp_limb_t *limb_data() { return limbs; }
+    const mp_limb_t *limb_data() const { return limbs; }
+    size_t limb_stride() const { return stride; }
+
+    // Keeps the first min(n, size()) values; new elements are NaN, one header each.
+    void resize(size_t new_n) {
+        if (new_n > cap) {
+            mpfr_vector grown;
+            grown.prec = prec;
+            grown.stride = stride;
+            grown.allocate(new_n > 2 * cap ? new_n : 2 * cap, stride);
+            if (n > 0)
+                std::memcpy(grown.limbs, limbs, n * stride * sizeof(mp_limb_t));
+            for (size_t i = 0; i < n; i++) {
+                grown.headers[i] = headers[i];
+                mpfr_custom_move(&grown.headers[i], grown.limbs + i * stride);
+            }
+            grown.n = n;
+            swap(grown);
+        }
+        for (size_t i = n; i < new_n; i++)
+            init(i);
+        n = new_n;
+    }
+    // Like mpfr_set_prec, every element becomes NaN, header by header. The block is reused
+    // when it is large enough.
+    void set_prec(mpfr_prec_t new_prec) {
+        const size_t new_stride = limbs_per_value(new_prec);
+        prec = new_prec;
+        stride = new_stride;
+        if (cap * new_stride > limb_cap) {
+            release();
+            allocate(cap, new_stride);
+        }
+        for (size_t i = 0; i < n; i++)
+            init(i);
+    }
+    void clear() { n = 0; }
+
+  private:
+    void *block = nullptr;
+    mpfr_ptr *ptrs = nullptr;
+    __mpfr_struct *headers = nullptr;
+    mp_limb_t *limbs = nullptr;
+    size_t n = 0, cap = 0, limb_cap = 0;
+    mpfr_prec_t prec;
+    size_t stride; // limbs per element
+
+    static size_t limbs_per_value(mpfr_prec_t prec) { return mpfr_custom_get_size(prec) / sizeof(mp_limb_t); }
+    static size_t round_up(size_t bytes) { return (bytes + alignment - 1) / alignment * alignment; }
+    void init(size_t i) {
+        mpfr_custom_init(limbs + i * stride, prec);
+        mpfr_custom_init_set(&headers[i], MPFR_NAN_KIND, 0, prec, limbs + i * stride);
+    }
+    // one block for all three sections; the headers of [0, new_cap) are not initialized
+    void allocate(size_t new_cap, size_t new_stride) {
+        const size_t ptr_bytes = round_up(new_cap * sizeof(mpfr_ptr));
+        const size_t header_bytes = round_up(new_cap * sizeof(__mpfr_struct));
+        block = ::operator new(ptr_bytes + header_bytes + new_cap * new_stride * sizeof(mp_limb_t), std::align_val_t(alignment));
+        ptrs = static_cast<mpfr_ptr *>(block);
+        headers = reinterpret_cast<__mpfr_struct *>(static_cast<char *>(block) + ptr_bytes);
+        limbs = reinterpret_cast<mp_limb_t *>(static_cast<char *>(block) + ptr_bytes + header_bytes);
+        for (size_t i = 0; i < new_cap; i++)
+            ptrs[i] = &headers[i];
+        cap = new_cap;
+        limb_cap = new_cap * new_stride;
+    }
+    void release() {
+        if (block != nullptr)
+            ::operator delete(block, std::align_val_t(alignment));
+        block = nullptr;
+    }
+};
+
+} // namespace mpfr
+
+#endif
@@ -30,9 +30,24 @@
 #include <cassert>
 #include <cstring>
 #include <string>
+#include <sstream>
+#include <fstream>
 #include <iomanip>
+#include <vector>
+#include <thread>
 
 #include "mpfr_class.h"
+#include "mpfr_fixed.h"
+#include "mpfr_allocator.h"
+#include "mpfr_vector.h"
+#include "mpfr_blas.h"
+#include "mpfr_reduce.h"
+#include "mpfr_long_accumulator.h"
+#include "mpfr_binary.h"
+#include "mpfr_format.h"
+#include "mpc_class.h"
+#include "mpfr_backend.h"
+#include "mpfr_ball.h"
 
 using namespace mpfr;
 
@@ -98,6 +113,37 @@ void testDefaultConstructor() {
     std::cout << "Default constructor test passed." << std::endl;
 }
 
+void testPrecisionScope() {
+    {
+        precision_scope p(1024, MPFR_RNDZ);
+        mpfr_class a(2.0);
+        assert(a.get_prec() == 1024 && defaults::rnd == MPFR_RNDZ);
+        assert(sqrt(a).get_prec() == 1024);
+    }
+    assert(defaults::get_default_prec() == 512 && defaults::get_default_rounding_mode() == MPFR_RNDN);
+
+    // each thread runs its own sweep; the contexts do not leak into each other
+    const mpfr_prec_t precs[] = {53, 113, 256, 2048};
+    mpfr_prec_t seen[4], fresh[4];
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&, i] {
+            fresh[i] = defaults::get_default_prec();
+            precision_scope p(precs[i]);
+            mpfr_class x(1.0);
+            for (int n = 0; n < 1000; n++)
+                x = sqrt(x + 1.0);
+            seen[i] = x.get_prec();
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    for (int i = 0; i < 4; i++)
+        assert(fresh[i] == 512 && seen[i] == precs[i]);
+    assert(defaults::get_default_prec() == 512);
+    std::cout << "Precision scope test passed." << std::endl;
+}
+
 void testCopyConstructor() {
     mpfr_class a;
     mpfr_class b = a;
@@ -110,6 +156,25 @@ void testAssignmentOperator() {
     mpfr_class b;
     b = a;
     assert(true);
+
+    // expressions keep the destination's precision; copies and function results bring their own
+    precision_scope scope(128);
+    mpfr_class y, x;
+    y.set_prec(64);
+    y = 2.0;
+    x.set_prec(200);
+    x = y + y * y;
+    assert(x.get_prec() == 200 && x == 6);
+    x = 1.0 / 3;
+    assert(x.get_prec() == 200);
+    x = sqrt(y);
+    assert(x.get_prec() == 128);
+    x.set_prec(200);
+    x = y;
+    assert(x.get_prec() == 64 && x == 2);
+    x.set_prec(200);
+    x = mpfr_class(y + y);
+    assert(x.get_prec() == 128 && x == 4);
     std::cout << "Assignment operator test passed." << std::endl;
 }
 
@@ -608,15 +673,1548 @@ void test_mpfr_class_double_division() {
     std::cout << "mpfr_class / double test passed." << std::endl;
 }
 
+void testMixedIntegerArithmetic() {
+    mpfr_class a(4.0), c;
+    long l = -3;
+    unsigned long u = 6;
+
+    c = a * 2;
+    assert(Is_mpfr_class_Equals(c, "8.0000000000"));
+    c = 3000 / a - l;
+    assert(Is_mpfr_class_Equals(c, "753.0000000000"));
+    c = u - a + 1;
+    assert(Is_mpfr_class_Equals(c, "3.0000000000"));
+    c = 1 / (a * a) + u * a;
+    assert(Is_mpfr_class_Equals(c, "24.0625000000"));
+    c += 2;
+    c -= 1L;
+    c *= 4u;
+    c /= -2;
+    assert(Is_mpfr_class_Equals(c, "-50.1250000000"));
+    assert(a == 4 && a != 5 && a < 5u && a > l && a <= 4L && a >= 4);
+    assert(5 > a && l < a && !(a < 4) && 3 <= c * -1 / 16);
+
+    mpz_t z;
+    mpq_t q;
+    mpz_init_set_si(z, 10);
+    mpq_init(q);
+    mpq_set_si(q, 1, 3);
+    c = a + z;
+    assert(Is_mpfr_class_Equals(c, "14.0000000000"));
+    c = z / a - z;
+    assert(Is_mpfr_class_Equals(c, "-7.5000000000"));
+    c = q - a; // no mpfr_q_sub: computed as -(a - q)
+    assert(Is_mpfr_class_Equals(c, "-3.6666666667"));
+    c = q / a * z;
+    assert(Is_mpfr_class_Equals(c, "0.8333333333"));
+    c = 1 / (q / a); // 12
+    c *= q;
+    c /= z;
+    assert(Is_mpfr_class_Equals(c, "0.4000000000"));
+    assert(a < z && z > a && a > q && c * z == 4 && q < c);
+
+    mpfr_class nan;
+    assert(!(nan == 0) && !(nan != 0) && !(nan < z) && !(q >= nan));
+    mpz_clear(z);
+    mpq_clear(q);
+    std::cout << "Mixed integer, mpz_t and mpq_t arithmetic test passed." << std::endl;
+}
+
+void testLiterals() {
+    mpfr_class third("0.3333333333333333333333333333333333333333333333333333333333333333333333333333");
+    assert(0.3333333333333333333333333333333333333333333333333333333333333333333333333333_mpfr == third);
+    assert(0.1_mpfr == mpfr_class("0.1") && 0.1_mpfr != 0.1);
+    assert(1'000'000_mpfr == 1000000 && 1e-64_mpfr == mpfr_class("1e-64") && 2.5E+3_mpfr == 2500);
+    assert(0x1.8p-3_mpfr == 0.1875 && 0b1011_mpfr == 11 && 0_mpfr == 0 && 0755.5_mpfr == 755.5);
+
+    mpfr_class v(2.0);
+    const mpfr_class *first = &1130_mpfr;
+    for (int n = 0; n < 3; n++) {
+        v = 111 - 1130_mpfr / v; // looked up, not parsed again
+        assert(&1130_mpfr == first);
+    }
+    {
+        precision_scope p(64);
+        assert((1130_mpfr).get_prec() == 64 && &1130_mpfr != first);
+        assert(0.1_mpfr == mpfr_class("0.1"));
+    }
+    assert(&1130_mpfr == first && (1130_mpfr).get_prec() == defaults::prec);
+
+    // a literal interned inside an arena_scope outlives it
+    allocator::install();
+    {
+        allocator::arena_scope arena;
+        precision_scope p(333);
+        assert(2.75_mpfr > 2);
+    }
+    {
+        precision_scope p(333);
+        const mpfr_class copy = 2.75_mpfr;
+        assert(copy == 2.75);
+    }
+    allocator::uninstall();
+    std::cout << "Literal test passed." << std::endl;
+}
+
+void testConstantCache() {
+    const mpfr_rnd_t rnds[] = {MPFR_RNDN, MPFR_RNDZ, MPFR_RNDU, MPFR_RNDD, MPFR_RNDA};
+    int (*direct[])(mpfr_ptr, mpfr_rnd_t) = {mpfr_const_pi, mpfr_const_log2, mpfr_const_euler, mpfr_const_catalan};
+    mpfr_t x, y;
+    constants::free();
+    for (int c = 0; c < constants::count; c++) {
+        mpfr_init2(x, 100);
+        constants::get(x, static_cast<constants::constant>(c), MPFR_RNDN); // cached at 128 bits
+        mpfr_clear(x);
+        // every precision below, so the boundary cases of rounding twice come up too
+        for (mpfr_prec_t prec = 2; prec < 128; prec++) {
+            for (mpfr_rnd_t rnd : rnds) {
+                mpfr_inits2(prec, x, y, (mpfr_ptr)0);
+                int t1 = constants::get(x, static_cast<constants::constant>(c), rnd);
+                int t2 = direct[c](y, rnd);
+                assert(mpfr_equal_p(x, y) && (t1 > 0) == (t2 > 0) && (t1 < 0) == (t2 < 0));
+                mpfr_clears(x, y, (mpfr_ptr)0);
+            }
+        }
+    }
+
+    constants::prewarm(4096);
+    constants::statistics before = constants::get_statistics();
+    for (int n = 0; n < 10; n++) {
+        precision_scope p(n % 2 ? 256 : 4000);
+        assert(const_pi() > 3.14159 && const_pi() < 3.1416 && const_log2() < 1 && const_catalan() > const_euler());
+    }
+    constants::statistics after = constants::get_statistics();
+    assert(after.misses == before.misses && after.hits == before.hits + 50);
+    constants::free();
+    mpfr_class pi = const_pi();
+    assert(constants::get_statistics().misses == after.misses + 1 && pi > 3.14159 && pi < 3.1416);
+
+    // a cache entry filled inside an arena_scope outlives it
+    constants::free();
+    allocator::install();
+    {
+        allocator::arena_scope arena;
+        assert(const_pi() > 3.14159);
+    }
+    assert(const_pi() > 3.14159 && const_pi() < 3.1416);
+    allocator::uninstall();
+    std::cout << "Constant cache test passed." << std::endl;
+}
+
+void testVector() {
+    mpfr_vector x(100, 256), y(100, 256);
+    assert(x.size() == 100 && x.get_prec() == 256 && x[99].is_nan());
+    assert(reinterpret_cast<uintptr_t>(x.data()) % mpfr_vector::alignment == 0);
+    assert(reinterpret_cast<uintptr_t>(x.data()[0]) % mpfr_vector::alignment == 0);
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = i + 1;
+        y[i] = 1 / x[i];
+    }
+    mpfr_class dot(0.0);
+    for (size_t i = 0; i < x.size(); i++)
+        dot += x[i] * y[i]; // mpfr_fma on the elements
+    mpfr_t exact;
+    mpfr_init2(exact, 256);
+    mpfr_dot(exact, x.data(), y.data(), x.size(), MPFR_RNDN);
+    assert(abs(dot - mpfr_class(exact)) < 1e-70 && abs(dot - 100) < 1e-70);
+    mpfr_clear(exact);
+    mpfr_sum(x[0].get_mpfr_t(), x.data() + 1, x.size() - 1, MPFR_RNDN); // 2 + ... + 100
+    assert(x[0] == 5049);
+    x[0] = 1;
+
+    x[1] += x[2] * 2; // 2 + 3 * 2
+    x[2] *= x[2];
+    assert(x[1] == 8 && x[2] == 9 && x[2] > x[1] && x[1] == mpfr_class(8.0));
+    mpfr_class s = sqrt(x[2]); // elements convert to mpfr_class where one is expected
+    assert(s == 3 && x[3] == y[3] * 16);
+
+    x.resize(1000); // grows: the values move into the new block
+    assert(x[1] == 8 && x[99] == 100 && x[999].is_nan());
+    x.resize(10);
+    const mpfr_vector z = x;
+    assert(z.size() == 10 && z[1] == 8 && z[1].get_mpfr_t() != x[1].get_mpfr_t());
+    int n = 0;
+    for (auto e : z)
+        n += e > 4;
+    assert(n == 8);
+
+    size_t cap = x.capacity();
+    x.set_prec(64); // fits in the old block
+    assert(x.capacity() == cap && x.get_prec() == 64 && x[0].get_prec() == 64 && x[0].is_nan());
+    x.set_prec(1024);
+    x[9] = const_pi();
+    assert(x[9].get_prec() == 1024 && x[9] > 3.14);
+    std::cout << "Vector test passed." << std::endl;
+}
+
+void testBlasLevel1() {
+    const long n = 5000;
+    mpfr_vector x(n), y(n);
+    std::vector<mpfr_class> u(n), v(n);
+    for (long i = 0; i < n; i++) {
+        x[i] = i % 2 ? -(i + 1) : i + 1;
+        y[i] = 1 / x[i];
+        u[i] = x[i];
+        v[i] = y[i];
+    }
+    for (int threads : {1, 4}) {
+        blas::set_num_threads(threads);
+        assert(abs(blas::dot(x, y) - n) < 1e-140 && blas::dot(n, u.data(), v.data()) == blas::dot(x, y));
+        assert(abs(blas::dot_fma(x, y) - n) < 1e-140);
+        assert(abs(blas::dot_fma(n / 2, u.data(), 2, v.data(), -2) - blas::dot(n / 2, u.data(), 2, v.data(), 2)) > 1);
+        assert(blas::asum(x) == n * (n + 1) / 2 && blas::asum(n / 2, u.data() + 1, 2) == (n / 2) * (n / 2 + 1));
+        assert(blas::iamax(x) == n - 1 && blas::iamax(n, u.data(), -1) == 0 && blas::iamax(3, u.data(), 2) == 2);
+
+        mpfr_vector z = y;
+        blas::axpy(-2, x, z); // y - 2 x
+        blas::scal(mpfr_class(0.5), z);
+        assert(z[10] == y[10] / 2 - x[10]);
+        std::vector<mpfr_class> w = v;
+        blas::axpy(n, mpfr_class(2.0), u.data(), w.data());
+        assert(w[n - 1] == 2 * u[n - 1] + y[n - 1]);
+        w = u;
+        blas::scal(n / 2, 3, w.data(), 2);
+        assert(w[0] == 3 && w[1] == -2 && w[2] == 9);
+    }
+    blas::set_num_threads(1);
+    int caught = 0;
+    mpfr_vector shorter(n - 1);
+    for (int k = 0; k < 3; k++) {
+        try {
+            if (k == 0)
+                blas::dot(x, shorter);
+            else if (k == 1)
+                blas::dot_fma(shorter, y);
+            else
+                blas::axpy(2, x, shorter);
+        } catch (const std::runtime_error &) {
+            caught++;
+        }
+    }
+    assert(caught == 3);
+
+    // 3-4-5 triangles at the ends of the exponent range
+    mpfr_exp_t emax = mpfr_get_emax(), emin = mpfr_get_emin();
+    mpfr_set_emax(1000);
+    mpfr_set_emin(-1000);
+    mpfr_class a[2];
+    mpfr_set_si_2exp(a[0].get_mpfr_t(), 3, 990, MPFR_RNDN);
+    mpfr_set_si_2exp(a[1].get_mpfr_t(), -4, 990, MPFR_RNDN);
+    mpfr_class r = blas::nrm2(2, a);
+    assert(mpfr_cmp_si_2exp(r.get_mpfr_t(), 5, 990) == 0);
+    mpfr_set_si_2exp(a[0].get_mpfr_t(), 3, -995, MPFR_RNDN);
+    mpfr_set_si_2exp(a[1].get_mpfr_t(), 4, -995, MPFR_RNDN);
+    r = blas::nrm2(2, a);
+    assert(mpfr_cmp_si_2exp(r.get_mpfr_t(), 5, -995) == 0);
+    mpfr_set_emax(emax);
+    mpfr_set_emin(emin);
+    assert(abs(blas::nrm2(x) - sqrt(mpfr_class(n) * (n + 1) * (2 * n + 1) / 6)) < 1e-140);
+    std::cout << "BLAS level 1 test passed." << std::endl;
+}
+
+void testBlasLevel2() {
+    for (long n : {7L, 300L}) {
+        // the same m x n matrix stored both ways, and its exact products with x and y
+        const long m = n + 2;
+        std::vector<mpfr_class> Acol(m * n), Arow(m * n), x(n), y(m), S(n * n);
+        for (long i = 0; i < m; i++)
+            for (long j = 0; j < n; j++)
+                Acol[i + j * m] = Arow[i * n + j] = mpfr_class(1) / (i + 2 * j + 1);
+        for (long j = 0; j < n; j++)
+            x[j] = j % 3 - 1;
+        for (long i = 0; i < m; i++)
+            y[i] = mpfr_class(1) / (i + 1);
+        for (long i = 0; i < n; i++)
+            for (long j = 0; j < n; j++)
+                S[i + j * n] = i <= j ? Acol[i + j * m] : mpfr_class(0.0) / 0; // NaN in the unread triangle
+
+        std::vector<mpfr_class> r1, r2, r3;
+        for (int threads : {1, 3}) {
+            blas::set_num_threads(threads);
+            std::vector<mpfr_class> ycol = y, yrow = y, yt(n, mpfr_class(0.0) / 0), ys(n);
+            blas::gemv(blas::col_major, 'N', m, n, 2, Acol.data(), m, x.data(), 1, mpfr_class(0.5), ycol.data(), 1);
+            blas::gemv(blas::row_major, 'N', m, n, 2, Arow.data(), n, x.data(), 1, mpfr_class(0.5), yrow.data(), 1);
+            blas::gemv(blas::row_major, 'T', m, n, 1, Arow.data(), n, y.data(), -1, 0, yt.data(), 1, true);
+            blas::symv(blas::col_major, 'U', n, 1, S.data(), n, x.data(), 1, 0, ys.data(), 1, true);
+            assert(ycol == yrow);
+            for (long i = 0; i < m; i++) {
+                std::vector<mpfr_class> row(Arow.begin() + i * n, Arow.begin() + (i + 1) * n);
+                assert(ycol[i] == 2 * blas::dot_fma(n, row.data(), x.data()) + mpfr_class(0.5) * y[i]);
+            }
+            for (long j = 0; j < n; j++) {
+                assert(yt[j] == blas::dot(m, Acol.data() + j * m, 1, y.data(), -1)); // correctly rounded
+                std::vector<mpfr_class> col(n);
+                for (long i = 0; i < n; i++)
+                    col[i] = i <= j ? S[i + j * n] : S[j + i * n];
+                assert(ys[j] == blas::dot(n, col.data(), x.data()));
+            }
+            if (threads == 1)
+                r1 = ycol, r2 = yt, r3 = ys;
+            else
+                assert(r1 == ycol && r2 == yt && r3 == ys);
+        }
+
+        // L x = b with a unit lower triangle of integers: exact in both layouts
+        std::vector<mpfr_class> L(n * n), Lrow(n * n), b(n), sol(n);
+        for (long i = 0; i < n; i++) {
+            sol[i] = i % 5 - 2;
+            for (long j = 0; j < n; j++)
+                L[i + j * n] = Lrow[i * n + j] = i > j ? (i * j) % 3 - 1 : (i == j ? 7 : 0);
+        }
+        for (int threads : {1, 3}) {
+            blas::set_num_threads(threads);
+            for (long i = 0; i < n; i++) {
+                b[i] = sol[i];
+                for (long j = 0; j < i; j++)
+                    b[i] += L[i + j * n] * sol[j];
+            }
+            std::vector<mpfr_class> b0 = b, bt = b;
+            blas::trsv(blas::col_major, 'L', 'N', 'U', n, L.data(), n, b.data(), 1);
+            assert(b == sol);
+            blas::trsv(blas::col_major, 'U', 'T', 'U', n, Lrow.data(), n, bt.data(), 1); // L stored transposed
+            assert(bt == sol);
+            // the diagonal 7 is read with diag 'N'; the rows in reverse with incx = -1
+            for (long i = 0; i < n; i++)
+                bt[n - 1 - i] = b0[i] + 6 * sol[i];
+            blas::trsv(blas::row_major, 'L', 'N', 'N', n, Lrow.data(), n, bt.data(), -1);
+            for (long i = 0; i < n; i++)
+                assert(bt[n - 1 - i] == sol[i]);
+        }
+
+        // A = 3 x y^T + A
+        std::vector<mpfr_class> G = Arow;
+        blas::ger(blas::row_major, m, n, 3, y.data(), 1, x.data(), 1, G.data(), n);
+        for (long i = 0; i < m; i++)
+            for (long j = 0; j < n; j++)
+                assert(G[i * n + j] == mpfr_class(3 * y[i]) * x[j] + Arow[i * n + j]);
+        blas::set_num_threads(1);
+    }
+    bool caught = false;
+    try {
+        std::vector<mpfr_class> a(4), v(2);
+        blas::trsv(blas::col_major, 'X', 'N', 'N', 2, a.data(), 2, v.data(), 1);
+    } catch (const std::runtime_error &) {
+        caught = true;
+    }
+    assert(caught);
+    std::cout << "BLAS level 2 test passed." << std::endl;
+}
+
+void testReduce() {
+    // magnitudes from 2^-600 to 2^600 with heavy cancellation
+    const long n = 10000;
+    std::vector<mpfr_class> x(n);
+    for (long i = 0; i < n; i++) {
+        x[i] = mpfr_class(1) / (i + 3);
+        mpfr_mul_2si(x[i].get_mpfr_t(), x[i].get_mpfr_t(), (i * 7919) % 1201 - 600, MPFR_RNDN);
+        if (i % 2)
+            mpfr_neg(x[i].get_mpfr_t(), x[i].get_mpfr_t(), MPFR_RNDN);
+    }
+    x[17] = mpfr_class("1e100");
+    x[n - 17] = mpfr_class("-1e100");
+    std::vector<mpfr_ptr> px(n);
+    for (long i = 0; i < n; i++)
+        px[i] = x[i].get_mpfr_t();
+    mpfr_class expected;
+    mpfr_sum(expected.get_mpfr_t(), px.data(), n, MPFR_RNDN);
+    auto product = [](const mpfr_class &a, const mpfr_class &b) { return a * (1 + b); };
+    auto larger = [](const mpfr_class &a, const mpfr_class &b) { return a < b ? b : a; };
+    mpfr_class p1, m1, largest = x[0];
+    for (const auto &v : x)
+        largest = larger(largest, v);
+    for (int threads : {1, 2, 3, 8}) {
+        blas::set_num_threads(threads);
+        mpfr_class s = sum(x);
+        assert(mpfr_equal_p(s.get_mpfr_t(), expected.get_mpfr_t()) && mpfr_signbit(s.get_mpfr_t()) == mpfr_signbit(expected.get_mpfr_t()));
+        mpfr_class p = reduce(x, product), m = reduce(x.begin(), x.end(), larger);
+        if (threads == 1)
+            p1 = p, m1 = m;
+        assert(p == p1 && m == m1 && m == largest);
+    }
+    blas::set_num_threads(1);
+    assert(sum(x.begin(), x.begin()) == 0 && reduce(x.begin(), x.begin(), larger).is_nan());
+    mpfr_vector v(3);
+    v[0] = 1, v[1] = 2, v[2] = 3;
+    assert(sum(v) == 6 && reduce(v, [](const mpfr_class &a, const auto &b) { return a * b; }) == 6);
+
+    // many threads adding at once, in whatever order
+    mpfr_accumulator acc(3);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 6; t++)
+        workers.emplace_back([&, t] {
+            for (long i = t; i < n; i += 6)
+                acc.add(x[i]);
+        });
+    for (auto &w : workers)
+        w.join();
+    assert(acc.result() == expected);
+    acc.add(1e-300);
+    acc.add(-1e-300);
+    acc.add(2);
+    acc.add(-2L);
+    assert(acc.result() == expected);
+    acc.clear();
+    acc.add(0.5);
+    acc.add(1UL << 60);
+    assert(acc.result() == mpfr_class(0.5) + mpfr_class(1UL << 60));
+
+    // values too far apart for one exact sum are kept in further ones, and still counted
+    acc.clear();
+    mpfr_class huge(1.0), tiny(1.0);
+    huge = mul_2ui(huge, 1000000000UL, MPFR_RNDN);
+    tiny = div_2ui(tiny, 10UL, MPFR_RNDN);
+    acc.add(huge);
+    for (int k = 0; k < 1024; k++)
+        acc.add(tiny);
+    acc.add(neg(huge));
+    acc.add(huge);
+    assert(acc.result() == huge && acc.result(MPFR_RNDU) > huge);
+    acc.add(neg(huge));
+    assert(acc.result() == 1);
+    std::cout << "Reduce test passed." << std::endl;
+}
+
+void testLongAccumulator() {
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 11);
+    for (mpfr_prec_t prec : {100, 512}) {
+        precision_scope scope(prec);
+        const long n = 3000;
+        mpfr_vector x(n), y(n);
+        for (long i = 0; i < n; i++) {
+            mpfr_urandom(x[i].get_mpfr_t(), state, MPFR_RNDN);
+            mpfr_urandom(y[i].get_mpfr_t(), state, MPFR_RNDN);
+            if (i % 3 == 0)
+                x[i] = 0 - x[i];
+        }
+        x[5] = 0 - x[6] * y[6] / y[5]; // near cancellation
+        for (int threads : {1, 3}) {
+            blas::set_num_threads(threads);
+            assert(long_dot(n, x.begin(), y.begin()) == blas::dot(x, y));
+        }
+        blas::set_num_threads(1);
+    }
+    gmp_randclear(state);
+
+    // terms outside the window, or wider than max_prec, go to mpfr_dot
+    mpfr_class wide = [] {
+        precision_scope scope(1000);
+        return mpfr_class(1 + mpfr_class("1e-200"));
+    }();
+    precision_scope scope(64);
+    mpfr_long_accumulator acc(-10, 10);
+    mpfr_class a(3.0), b("0.01"), big("1e40"), one(1.0), minus_one(-1.0);
+    acc.add_product(a, b);
+    acc.add_product(big, b);
+    acc.add(wide);
+    acc.add(minus_one);
+    assert(acc.outside() == 2);
+    std::vector<mpfr_ptr> px = {a.get_mpfr_t(), big.get_mpfr_t(), wide.get_mpfr_t(), minus_one.get_mpfr_t()};
+    std::vector<mpfr_ptr> py = {b.get_mpfr_t(), b.get_mpfr_t(), one.get_mpfr_t(), one.get_mpfr_t()};
+    mpfr_class expected;
+    mpfr_dot(expected.get_mpfr_t(), px.data(), py.data(), 4, MPFR_RNDN);
+    assert(acc.result() == expected);
+
+    // exact: a sum that cancels to a few bits far below the operands
+    mpfr_long_accumulator exact(-200, 10);
+    mpfr_class c(1.0), d("1e-50"), minus_c = 0 - c;
+    exact.add(c);
+    exact.add_product(c, d);
+    exact.add(minus_c);
+    assert(exact.outside() == 0 && exact.result() == d);
+    mpfr_long_accumulator merged(exact);
+    merged += exact;
+    assert(merged.result() == 2 * d);
+    merged.clear();
+    assert(merged.result() == 0);
+
+    // the sign of an exact zero follows mpfr_sum
+    auto is_minus_zero = [](const mpfr_class &x) { return mpfr_zero_p(x.get_mpfr_t()) && mpfr_signbit(x.get_mpfr_t()); };
+    auto is_plus_zero = [](const mpfr_class &x) { return mpfr_zero_p(x.get_mpfr_t()) && !mpfr_signbit(x.get_mpfr_t()); };
+    mpfr_long_accumulator zeros(-10, 10);
+    assert(is_plus_zero(zeros.result(MPFR_RNDD)));
+    zeros.add(c);
+    zeros.add(minus_c);
+    assert(is_plus_zero(zeros.result(MPFR_RNDN)) && is_minus_zero(zeros.result(MPFR_RNDD)) && is_plus_zero(zeros.result(MPFR_RNDU)));
+    mpfr_class plus_zero(0.0), minus_zero = neg(plus_zero);
+    mpfr_long_accumulator minus_zeros(-10, 10);
+    minus_zeros.add(minus_zero);
+    minus_zeros.add_product(plus_zero, minus_c);
+    assert(is_minus_zero(minus_zeros.result(MPFR_RNDN)) && is_minus_zero(minus_zeros.result(MPFR_RNDU)));
+    mpfr_long_accumulator mixed(minus_zeros);
+    mixed.add(plus_zero);
+    assert(is_plus_zero(mixed.result(MPFR_RNDN)) && is_minus_zero(mixed.result(MPFR_RNDD)));
+    mpfr_long_accumulator plus_zeros(-10, 10);
+    plus_zeros.add_product(minus_zero, minus_c);
+    assert(is_plus_zero(plus_zeros.result(MPFR_RNDD)));
+    minus_zeros += plus_zeros;
+    assert(is_plus_zero(minus_zeros.result(MPFR_RNDN)));
+    minus_zeros.clear();
+    assert(is_plus_zero(minus_zeros.result(MPFR_RNDN)));
+
+    // special values
+    mpfr_class inf(1.0), zero(0.0);
+    inf /= zero;
+    merged.add_product(inf, c);
+    assert(merged.result().is_inf());
+    merged.add_product(zero, inf);
+    assert(merged.result().is_nan());
+    std::cout << "Long accumulator test passed." << std::endl;
+}
+
+// reference for gemm: the same fma chain, combined the same way
+static mpfr_class gemmReference(bool ta, bool tb, long i, long j, long k, const mpfr_class *A, long lda, const mpfr_class *B, long ldb) {
+    mpfr_class s(0.0);
+    for (long p = 0; p < k; p++)
+        mpfr_fma(s.get_mpfr_t(), A[ta ? p + i * lda : i + p * lda].get_mpfr_t(), B[tb ? j + p * ldb : p + j * ldb].get_mpfr_t(), s.get_mpfr_t(), MPFR_RNDN);
+    return s;
+}
+
+void testGemm() {
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 7);
+    for (mpfr_prec_t prec : {53, 512, 4096}) {
+        precision_scope scope(prec);
+        // crosses the mc and kc blocks at every precision, with ragged edges
+        const long m = 70, n = 9, k = 300, lda = 301, ldb = k, ldc = m + 3;
+        std::vector<mpfr_class> A(lda * m), B(ldb * n), C(ldc * n), C0;
+        for (auto *v : {&A, &B, &C})
+            for (auto &x : *v)
+                mpfr_urandom(x.get_mpfr_t(), state, MPFR_RNDN);
+        C0 = C;
+        const mpfr_class alpha = mpfr_class(-1) / 3, keep(0.25); // alpha and beta
+        for (int threads : {1, 3}) {
+            blas::set_num_threads(threads);
+            C = C0;
+            blas::gemm('T', 'N', m, n, k, alpha, A.data(), lda, B.data(), ldb, keep, C.data(), ldc);
+            for (long j = 0; j < n; j++)
+                for (long i = 0; i < m; i++) {
+                    mpfr_class s = gemmReference(true, false, i, j, k, A.data(), lda, B.data(), ldb);
+                    assert(C[i + j * ldc] == alpha * s + keep * C0[i + j * ldc]);
+                }
+            assert(C[m + 1] == C0[m + 1]); // between columns, untouched
+        }
+        blas::set_num_threads(1);
+    }
+
+    // beta == 0 does not read C; mpfr_vector storage; transposed B
+    const long m = 5, n = 6, k = 7;
+    mpfr_vector A(m * k), B(n * k), C(m * n);
+    for (long i = 0; i < m * k; i++)
+        A[i] = i + 1;
+    for (long i = 0; i < n * k; i++)
+        B[i] = 1 - i;
+    blas::gemm('N', 'T', m, n, k, 2, A, m, B, n, 0, C, m);
+    for (long j = 0; j < n; j++)
+        for (long i = 0; i < m; i++) {
+            long s = 0;
+            for (long p = 0; p < k; p++)
+                s += (i + p * m + 1) * (1 - (j + p * n));
+            assert(C[i + j * m] == 2 * s);
+        }
+    bool caught = false;
+    try {
+        blas::gemm('X', 'N', m, n, k, 1, A, m, B, k, 0, C, m);
+    } catch (const std::runtime_error &) {
+        caught = true;
+    }
+    assert(caught);
+    // operands too short for their dimensions are refused before anything is read
+    mpfr_vector shorter(m * n - 1);
+    int refused = 0;
+    for (int which = 0; which < 3; which++) {
+        try {
+            if (which == 0)
+                blas::gemm('N', 'T', m, n, k, 1, shorter, m, B, n, 0, C, m);
+            else if (which == 1)
+                blas::gemm('N', 'T', m, n, k, 1, A, m, shorter, n, 0, C, m);
+            else
+                blas::gemm('N', 'T', m, n, k, 1, A, m, B, n, 0, shorter, m);
+        } catch (const std::runtime_error &) {
+            refused++;
+        }
+    }
+    assert(refused == 3);
+    gmp_randclear(state);
+    std::cout << "GEMM test passed." << std::endl;
+}
+
+// a = 1 + 2^-300, b = 1 - 2^-300: a * b = 1 - 2^-600 is not representable in 512 bits,
+// so only a fused operation keeps the 2^-600 term.
+void testFusedMultiplyAdd() {
+    mpfr_class a(1.0), b(1.0), c(-1.0), d(1.0), result;
+    mpfr_class eps = div_2ui(mpfr_class(1.0), 300, MPFR_RNDN);
+    a += eps;
+    b -= eps;
+
+    result = a * b + c; // mpfr_fma
+    assert(mpfr_cmp_si_2exp(result.get_mpfr_t(), -1, -600) == 0);
+    result = c + a * b; // mpfr_fma
+    assert(mpfr_cmp_si_2exp(result.get_mpfr_t(), -1, -600) == 0);
+    result = a * b - d; // mpfr_fms
+    assert(mpfr_cmp_si_2exp(result.get_mpfr_t(), -1, -600) == 0);
+    result = d - a * b; // -mpfr_fms
+    assert(mpfr_cmp_si_2exp(result.get_mpfr_t(), 1, -600) == 0);
+    result = a * b + c * d; // mpfr_fmma
+    assert(mpfr_cmp_si_2exp(result.get_mpfr_t(), -1, -600) == 0);
+    result = a * b - d * d; // mpfr_fmms
+    assert(mpfr_cmp_si_2exp(result.get_mpfr_t(), -1, -600) == 0);
+    mpfr_class e = a * b + c;
+    assert(mpfr_cmp_si_2exp(e.get_mpfr_t(), -1, -600) == 0);
+    result = c;
+    result += a * b; // mpfr_fma
+    assert(mpfr_cmp_si_2exp(result.get_mpfr_t(), -1, -600) == 0);
+    result = d;
+    result -= a * b; // -mpfr_fms
+    assert(mpfr_cmp_si_2exp(result.get_mpfr_t(), 1, -600) == 0);
+
+    // in c - a * b, an expression c is rounded in the caller's mode, as it is on its own
+    for (mpfr_rnd_t rnd : {MPFR_RNDU, MPFR_RNDD, MPFR_RNDZ, MPFR_RNDA}) {
+        precision_scope scope(53, rnd);
+        const mpfr_class x(1.0), y(0x1p-60), q(1.0);
+        mpfr_class p(1.0);
+        const mpfr_class c = x + y, fused = (x + y) - p * q, separate = c - p * q;
+        assert(fused == separate && (rnd == MPFR_RNDU || rnd == MPFR_RNDA ? fused > 0 : fused == 0));
+        p = (x + y) - p * q; // p is also an operand of the product
+        assert(p == separate);
+    }
+    std::cout << "Fused multiply-add test passed." << std::endl;
+}
+
+void testExpressionAliasing() {
+    mpfr_class x(1.0), y(3.0), two(2.0);
+    x = (x + two / x) / two; // x appears on both sides
+    assert(Is_mpfr_class_Equals(x, "1.5000000000"));
+    x = y - x * y; // 3 - 1.5 * 3
+    assert(Is_mpfr_class_Equals(x, "-1.5000000000"));
+    x = (y + x) * (x - y) + x; // (1.5) * (-4.5) - 1.5
+    assert(Is_mpfr_class_Equals(x, "-8.2500000000"));
+    x = 2.0 * x + 1.0 / (y - 1.0);
+    assert(Is_mpfr_class_Equals(x, "-16.0000000000"));
+    x *= x + y; // -16 * -13
+    assert(Is_mpfr_class_Equals(x, "208.0000000000"));
+    std::cout << "Expression aliasing test passed." << std::endl;
+}
+
+void testFixedPrecision() {
+    static_assert(sizeof(mpfr_fixed<256>) == sizeof(mpfr_t) + 256 / 8, "limbs are stored inline");
+    mpfr_fixed<256> a(1.5), b(2.5), c;
+    assert(c.is_nan());
+    assert(a.get_prec() == 256);
+    c = a * b + a; // mpfr_fma into c's inline limbs
+    assert(c == mpfr_fixed<256>("5.25"));
+
+    mpfr_fixed<256> d(c); // the copy has its own limbs
+    d += 1.0;
+    assert(c == mpfr_fixed<256>("5.25"));
+    assert(d == mpfr_fixed<256>("6.25"));
+    d = c;
+    assert(d == c);
+
+    mpfr_fixed<256> e = sqrt(mpfr_fixed<256>(2.0));
+    mpfr_t f;
+    mpfr_init2(f, 256);
+    mpfr_sqrt_ui(f, 2, MPFR_RNDN);
+    assert(mpfr_equal_p(e.get_mpfr_t(), f));
+    mpfr_clear(f);
+    e = const_pi<256>();
+    assert(mpfr_get_prec(e.get_mpfr_t()) == 256);
+    assert(exp(log(a)) > mpfr_fixed<256>(1.4999) && exp(log(a)) < mpfr_fixed<256>(1.5001));
+    std::cout << "mpfr_fixed test passed." << std::endl;
+}
+
+void testPoolAllocator() {
+    allocator::install();
+    allocator::statistics before = allocator::get_statistics();
+    for (int i = 0; i < 100; i++) {
+        mpfr_class a(1.5), b(2.5);
+        mpfr_class c = a * b + a;
+        assert(Is_mpfr_class_Equals(c, "5.2500000000"));
+    }
+    allocator::statistics after = allocator::get_statistics();
+    assert(after.hits > before.hits); // limbs of a, b and c are recycled from the second iteration on
+    {
+        allocator::arena_scope arena;
+        mpfr_class x(2.0);
+        for (int i = 0; i < 100; i++) {
+            mpfr_class y = sqrt(x);
+            x = y * y;
+        }
+        assert(Is_mpfr_class_Equals(x, "2.0000000000"));
+    }
+    assert(allocator::get_statistics().arena_allocations > after.arena_allocations);
+
+    // blocks of an arena freed or grown on another thread, and a value kept out of the arena
+    mpfr_t kept;
+    {
+        allocator::arena_scope arena;
+        mpfr_t grown, dropped;
+        mpfr_init2(grown, 128);
+        mpfr_init2(dropped, 128);
+        mpfr_set_ui(grown, 7, MPFR_RNDN);
+        {
+            allocator::arena_suspend suspend;
+            mpfr_init2(kept, 256);
+        }
+        mpfr_set_ui(kept, 3, MPFR_RNDN);
+        std::thread other([&] {
+            mpfr_set_prec(grown, 100000); // the new block is the other thread's
+            mpfr_set_ui(grown, 7, MPFR_RNDN);
+            mpfr_clear(dropped);
+        });
+        other.join();
+        assert(mpfr_cmp_ui(grown, 7) == 0);
+        mpfr_clear(grown);
+    }
+    assert(mpfr_cmp_ui(kept, 3) == 0);
+    mpfr_clear(kept);
+    allocator::uninstall();
+    std::cout << "Pool allocator test passed." << std::endl;
+}
+
+void testRvalueReuse() {
+    allocator::install();
+    mpfr_class a(1.0), b(3.0), c(3.0), d(4.0), two(2.0), r;
+    allocator::statistics before = allocator::get_statistics();
+    r = sqrt(a + b) * c / d; // a + b is materialized once; sqrt, * and / reuse it
+    allocator::statistics after = allocator::get_statistics();
+    assert(after.hits + after.misses - before.hits - before.misses == 1);
+    mpfr_class s = pow(a - b, two) / (d * c);
+    assert(Is_mpfr_class_Equals(r, "1.5000000000"));
+    assert(Is_mpfr_class_Equals(s, "0.3333333333"));
+
+    mpfr_class t(2.0);
+    mpfr_class u(std::move(t)); // t is left without limbs and reads as NaN
+    assert(t.is_nan());
+    t = u;
+    assert(t == u);
+    allocator::uninstall();
+
+    // a temporary at another precision is not reused: the result is at the default precision
+    // whether or not an operand is a temporary
+    {
+        precision_scope scope(256);
+        mpfr_class x, y(3.0);
+        x.set_prec(53);
+        x = 2.0;
+        const mpfr_class root = sqrt(mpfr_class(x)), sum = mpfr_class(x) + y / 7, quotient = 1 / mpfr_class(x);
+        assert(root.get_prec() == 256 && root == sqrt(x));
+        assert(sum.get_prec() == 256 && sum == x + y / 7);
+        assert(quotient.get_prec() == 256 && atan2(mpfr_class(x), y).get_prec() == 256);
+        const mpfr_class cube = pow_uj(mpfr_class(x), uintmax_t(3)), inverse = pow_sj(mpfr_class(x), intmax_t(-2)), fourth = pown(mpfr_class(x), intmax_t(4));
+        assert(cube.get_prec() == 256 && cube == 8 && inverse.get_prec() == 256 && inverse == 0.25 && fourth.get_prec() == 256 && fourth == 16);
+        assert(pow_uj(mpfr_class(y), uintmax_t(2)) == 9 && pown(y + 1, intmax_t(-1)) == 0.25); // the same object, reused
+        mpc_class z;
+        {
+            precision_scope narrow(53);
+            z = mpc_class(1, 2);
+        }
+        assert(z.get_prec() == 53);
+        const mpc_class w = mpc_class(z) / 3;
+        assert(w.get_prec() == 256 && w == z / 3);
+        const mpc_class e = exp(mpc_class(z)), s = sqrt(mpc_class(z)), l = log(mpc_class(z));
+        assert(e.get_prec() == 256 && e == exp(z) && s.get_prec() == 256 && s == sqrt(z) && l.get_prec() == 256 && l == log(z));
+    }
+    std::cout << "Rvalue reuse test passed." << std::endl;
+}
+
+void testLazyAllocation() {
+    allocator::install();
+    allocator::statistics before = allocator::get_statistics();
+    std::vector<mpfr_class> v(1000);
+    v.resize(4000);
+    mpfr_class a, b(std::move(a)), c = b;
+    allocator::statistics after = allocator::get_statistics();
+    assert(after.hits + after.misses == before.hits + before.misses); // only the vector storage itself
+    assert(c.get_prec() == mpfr_get_default_prec());
+
+    c = 0.5; // the first assignment allocates, at the precision c was created with
+    after = allocator::get_statistics();
+    assert(after.hits + after.misses == before.hits + before.misses + 1);
+    assert(mpfr_get_prec(c.get_mpfr_t()) == mpfr_get_default_prec());
+
+    mpfr_class d;
+    d.set_prec(64);
+    d = c * 3.0;
+    assert(d.get_prec() == 64 && Is_mpfr_class_Equals(d, "1.5000000000"));
+    assert(v[3999].is_nan() && mpfr_class(v[0] + c).is_nan());
+
+    // reading an empty object allocates nothing, so threads may read a shared vector
+    before = allocator::get_statistics();
+    const std::vector<mpfr_class> &shared = v;
+    std::vector<std::thread> readers;
+    std::atomic<long> nans{0};
+    for (int t = 0; t < 4; t++)
+        readers.emplace_back([&shared, &nans] {
+            long k = 0;
+            for (const mpfr_class &x : shared)
+                k += x.is_nan() && !(x < x) && !(x == x);
+            nans += k;
+        });
+    for (auto &t : readers)
+        t.join();
+    after = allocator::get_statistics();
+    assert(nans == 4 * 4000 && after.hits + after.misses == before.hits + before.misses);
+    v.clear();
+    allocator::uninstall();
+    std::cout << "Lazy allocation test passed." << std::endl;
+}
+
+void testStats() {
+    precision_scope scope(256);
+    stats::reset();
+    const stats::counters before = stats::snapshot();
+    {
+        mpfr_class a(2.0), b(3.0), c(5.0), r;
+        r = a * b + c;             // one fma into r, which allocates it
+        r = (a + b) * (a - b);     // add into r, sub into a temporary, mul
+        r /= a;                    // div
+        r = sqrt(a);               // sqrt, then r swaps with the result
+        r = exp(a);                // transcendental
+        mpfr_class w;
+        w.set_prec(1024);
+        w.set_prec(2048);          // a reallocation
+        std::thread t([] {
+            precision_scope inner(64);
+            mpfr_class x(1.0), y(1.0);
+            for (int i = 0; i < 10; i++)
+                y *= x;
+        });
+        t.join();                  // the counters of t outlive it
+    }
+    const stats::counters s = stats::snapshot();
+    if constexpr (stats::enabled) {
+        const int b256 = stats::prec_bucket(256);
+        assert(stats::prec_bucket(64) == 0 && b256 == 2 && stats::prec_bucket(1L << 30) == stats::prec_buckets - 1);
+        assert(s.ops[stats::fma][b256] == 1 && s.total(stats::fma) == 1);
+        assert(s.ops[stats::add][b256] == 1 && s.ops[stats::sub][b256] == 1 && s.ops[stats::mul][b256] == 1);
+        assert(s.ops[stats::mul][stats::prec_bucket(64)] == 10);
+        assert(s.total(stats::div) == 1 && s.total(stats::sqrt) == 1 && s.total(stats::transcendental) == 1);
+        assert(s.temporaries == 1 && s.heap_temporaries == 0);
+        assert(s.reallocs == 1);
+        assert(s.inits == s.clears && s.inits >= 9);
+        assert(s.live_limb_bytes == before.live_limb_bytes);
+        assert(s.peak_limb_bytes >= before.live_limb_bytes + static_cast<long long>(mpfr_custom_get_size(2048)));
+    } else {
+        assert(s.total() == 0 && s.inits == 0 && s.peak_limb_bytes == 0);
+    }
+    std::ostringstream os;
+    stats::report(os, s);
+    assert(os.str().find("transcendental") != std::string::npos);
+    std::cout << "Statistics test passed." << std::endl;
+}
+
+void testProfile() {
+    profile::reset();
+    precision_scope scope(128);
+    const mpfr_class a(1.0), b("1.00000000000000000001");
+    mpfr_class r;
+    unsigned narrow_line, wide_line;
+    {
+        profile::region narrow; narrow_line = __LINE__;
+        r = b - a; // about 66 of the leading bits cancel
+        r = a * 2;
+    }
+    {
+        precision_scope wide(256);
+        profile::region region; wide_line = __LINE__;
+        mpfr_class w;
+        w = a * b; // 256 bits out of 128 bit operands
+    }
+    const std::vector<profile::site_summary> sites = profile::snapshot();
+    if constexpr (profile::enabled) {
+        const profile::site_summary *n = nullptr, *v = nullptr;
+        for (const profile::site_summary &s : sites) {
+            n = s.line == narrow_line ? &s : n;
+            v = s.line == wide_line ? &s : v;
+        }
+        assert(n != nullptr && v != nullptr);
+        assert(n->function.find("testProfile") != std::string::npos);
+        assert(n->calls == 1 && n->operations == 2 && n->min_result_prec == 128 && n->max_operand_prec == 128);
+        assert(n->cancellations == 1 && n->max_cancelled_bits >= 60 && n->max_call_cancelled_bits == n->max_cancelled_bits);
+        assert(n->over_provisioned == 0 && n->suggested_prec == 128 && n->compounded_prec == 128);
+        assert(v->operations == 1 && v->over_provisioned == 1 && v->max_cancelled_bits == 0 && v->suggested_prec == 64);
+    } else {
+        assert(sites.empty());
+    }
+    std::ostringstream os;
+    profile::report(os, sites);
+    assert(os.str().find("precision profile") != std::string::npos);
+    std::cout << "Precision profile test passed." << std::endl;
+}
+
+void testBinary() {
+    precision_scope scope(200);
+    const mpfr_class third = mpfr_class(1) / 3;
+    mpfr_class values[6] = {third, mpfr_class(0) - third, mpfr_class(0.0), mpfr_class(1) / 0.0, mpfr_class(), const_pi()};
+    mpfr_neg(values[2].get_mpfr_t(), values[2].get_mpfr_t(), MPFR_RNDN); // -0
+    // single values, through a FILE * and through a stream
+    std::FILE *f = std::tmpfile();
+    std::stringstream ss;
+    for (const mpfr_class &x : values) {
+        binary::save(f, x);
+        binary::save(ss, x);
+    }
+    std::rewind(f);
+    for (const mpfr_class &x : values) {
+        precision_scope other(53);
+        mpfr_class y, z;
+        binary::load(f, y);
+        binary::load(ss, z);
+        for (const mpfr_class *r : {&y, &z}) {
+            assert(r->get_prec() == 200);
+            assert((mpfr_nan_p(x.get_mpfr_t()) && mpfr_nan_p(r->get_mpfr_t())) || (mpfr_equal_p(x.get_mpfr_t(), r->get_mpfr_t()) && mpfr_signbit(x.get_mpfr_t()) == mpfr_signbit(r->get_mpfr_t())));
+        }
+    }
+    std::fclose(f);
+
+    // arrays: mpfr_vector with and without singular values, std::vector<mpfr_class>
+    mpfr_vector v(1000, 300);
+    std::vector<mpfr_class> c(1000);
+    for (size_t i = 0; i < v.size(); i++) {
+        v[i] = mpfr_class(static_cast<long>(i) - 500) / 7;
+        c[i] = v[i];
+    }
+    for (int singular = 0; singular < 2; singular++) {
+        std::stringstream vs, cs;
+        binary::save(vs, v);
+        binary::save(cs, c);
+        assert(vs.str() == cs.str());
+        mpfr_vector w;
+        std::vector<mpfr_class> d;
+        binary::load(vs, w);
+        binary::load(cs, d);
+        assert(w.size() == v.size() && w.get_prec() == 300 && d.size() == v.size());
+        for (size_t i = 0; i < v.size(); i++) {
+            assert(d[i].get_prec() == 300);
+            if (v[i].is_nan()) {
+                assert(w[i].is_nan() && d[i].is_nan());
+            } else {
+                assert(mpfr_equal_p(w[i].get_mpfr_t(), v[i].get_mpfr_t()) && mpfr_equal_p(d[i].get_mpfr_t(), v[i].get_mpfr_t()));
+            }
+        }
+        v[3] = 0.0 / 0.0; // the second round has NaN, infinity and zero
+        v[4] = 1.0 / 0.0;
+        v[500] = 0.0;
+        c[3] = v[3];
+        c[4] = v[4];
+        c[500] = v[500];
+    }
+
+    // a mixed precision array and damaged input are refused
+    bool thrown = false;
+    std::vector<mpfr_class> mixed = {mpfr_class(1.0), mpfr_class(2.0)};
+    mixed[1].set_prec(64);
+    std::stringstream ms;
+    try {
+        binary::save(ms, mixed);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    std::stringstream good;
+    binary::save(good, v);
+    // the magic, the kind of element 1, and the lowest limb of element 0, whose low 20 bits are beyond the precision
+    for (size_t at : {size_t(0), sizeof(binary::header) + 1000 * 8 + 1, sizeof(binary::header) + 1000 * 8 + 1000}) {
+        std::string bytes = good.str();
+        bytes[at] = static_cast<char>(bytes[at] ^ 0x40);
+        std::stringstream bad(bytes);
+        thrown = false;
+        try {
+            mpfr_vector w;
+            binary::load(bad, w);
+        } catch (const std::runtime_error &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    std::stringstream truncated(good.str().substr(0, good.str().size() - 1));
+    thrown = false;
+    try {
+        std::vector<mpfr_class> d;
+        binary::load(truncated, d);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    std::cout << "Binary serialization test passed." << std::endl;
+}
+
+void testToChars() {
+    // what mpfr_printf writes, for random values and the rounding and special cases
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 21);
+    std::vector<mpfr_class> values;
+    for (const char *s : {"0", "0.5", "1.5", "2.5", "0.05", "0.0005", "9.5", "0.96", "99.5", "9.9999999", "123456", "1e20", "1e-5", "0.0001"})
+        values.push_back(mpfr_class(s));
+    values.push_back(mpfr_class(1) / 0.0);
+    values.push_back(mpfr_class(0.0) / 0.0);
+    for (int i = 0; i < 400; i++) {
+        const mpfr_prec_t precs[] = {2, 24, 53, 113, 300};
+        mpfr_class x;
+        x.set_prec(precs[i % 5]);
+        mpfr_urandomb(x.get_mpfr_t(), state);
+        mpfr_mul_2si(x.get_mpfr_t(), x.get_mpfr_t(), (i * 37) % 161 - 80, MPFR_RNDN);
+        values.push_back(x);
+    }
+    const size_t count = values.size();
+    for (size_t i = 0; i < count; i++) { // both signs of each
+        mpfr_class y = values[i];
+        mpfr_neg(y.get_mpfr_t(), y.get_mpfr_t(), MPFR_RNDN);
+        values.push_back(y);
+    }
+    const std::pair<chars_format, const char *> formats[] = {{chars_format::scientific, "%.*Re"}, {chars_format::fixed, "%.*Rf"}, {chars_format::general, "%.*Rg"}};
+    std::vector<char> buffer;
+    for (const mpfr_class &x : values) {
+        for (const auto &f : formats) {
+            for (int prec : {0, 1, 2, 3, 6, 12, 30}) {
+                char *expected = nullptr;
+                mpfr_asprintf(&expected, f.second, prec, x.get_mpfr_t());
+                buffer.resize(to_chars_size(x.get_mpfr_t(), f.first, prec));
+                const std::to_chars_result r = to_chars(buffer.data(), buffer.data() + buffer.size(), x.get_mpfr_t(), f.first, prec);
+                assert(r.ec == std::errc());
+                assert(std::string(buffer.data(), r.ptr) == expected);
+                // one byte short is refused
+                const size_t length = std::strlen(expected);
+                assert(to_chars(buffer.data(), buffer.data() + length - 1, x.get_mpfr_t(), f.first, prec).ec == std::errc::value_too_large);
+                mpfr_free_str(expected);
+            }
+        }
+        // the shortest form reads back to the same value
+        buffer.resize(to_chars_size(x.get_mpfr_t()));
+        const std::to_chars_result r = to_chars(buffer.data(), buffer.data() + buffer.size(), x.get_mpfr_t());
+        assert(r.ec == std::errc());
+        mpfr_class y;
+        y.set_prec(x.get_prec());
+        mpfr_set_str(y.get_mpfr_t(), std::string(buffer.data(), r.ptr).c_str(), 10, MPFR_RNDN);
+        assert((x.is_nan() && y.is_nan()) || mpfr_equal_p(x.get_mpfr_t(), y.get_mpfr_t()));
+    }
+    gmp_randclear(state);
+
+    // operator<< keeps the width and fill of the stream
+    std::ostringstream os;
+    os << std::setw(10) << std::setfill('*') << std::fixed << std::setprecision(2) << mpfr_class(2.5);
+    assert(os.str() == "******2.50");
+
+    // the bulk writer writes what operator<< does, for any number of threads
+    precision_scope scope(128);
+    mpfr_vector v(10000);
+    for (size_t i = 0; i < v.size(); i++)
+        v[i] = mpfr_class(static_cast<long>(i) - 5000) / 7;
+    std::ostringstream serial;
+    serial << std::setprecision(30);
+    for (size_t i = 0; i < v.size(); i++)
+        serial << v[i] << '\n';
+    for (int threads : {1, 3}) {
+        blas::set_num_threads(threads);
+        std::ostringstream bulk;
+        bulk << std::setprecision(30);
+        format::write(bulk, v);
+        assert(bulk.str() == serial.str());
+    }
+    blas::set_num_threads(1);
+    std::cout << "to_chars test passed." << std::endl;
+}
+
+void testBulkParse() {
+    precision_scope scope(128);
+    // blank lines, CRLF, spaces, a missing last line end, bad fields
+    const std::string text = "1.5\n\n  -2.25e3 \r\n0.1\nabc\n3.0x\n@inf@\n7";
+    for (int threads : {1, 3}) {
+        blas::set_num_threads(threads);
+        mpfr_vector v(2, 64);
+        std::vector<mpfr_class> c;
+        const std::vector<format::parse_error> errors = format::parse(text.data(), text.data() + text.size(), v);
+        format::parse(text.data(), text.data() + text.size(), c);
+        assert(v.size() == 7 && c.size() == 7 && v.get_prec() == 64 && c[0].get_prec() == 128);
+        assert(v[0] == 1.5 && v[1] == -2250 && v[4].is_nan() && v[5] == 1.0 / 0.0 && v[6] == 7);
+        {
+            precision_scope p64(64); // v is at 64 bits
+            assert(v[2] == mpfr_class("0.1"));
+        }
+        assert(c[2] == mpfr_class("0.1") && c[3].is_nan() && c[4].is_nan() && c[6] == 7);
+        assert(errors.size() == 2);
+        assert(errors[0].index == 3 && errors[0].line == 5 && errors[0].text == "abc" && std::string(errors[0].what) == "not a number");
+        assert(errors[1].index == 4 && errors[1].line == 6 && errors[1].text == "3.0x" && std::string(errors[1].what) == "trailing characters");
+    }
+    const std::string csv = "1, 2,3\n4,,5\n";
+    std::vector<mpfr_class> c;
+    assert(format::parse(csv.data(), csv.data() + csv.size(), c, ',').empty());
+    assert(c.size() == 5 && c[2] == 3 && c[3] == 4 && c[4] == 5);
+    assert(format::read("/nonexistent/values.txt", c).size() == 1);
+
+    // a file of several shards reads back what was written, for any number of threads
+    mpfr_vector v(200000);
+    for (size_t i = 0; i < v.size(); i++)
+        v[i] = mpfr_class(static_cast<long>(i) - 100000) / 7;
+    const char *path = "test_mpfr_class.parse.tmp";
+    {
+        std::ofstream os(path);
+        format::write(os, v, chars_format::scientific, static_cast<int>(mpfr_get_str_ndigits(10, 128)) - 1);
+    }
+    for (int threads : {1, 3}) {
+        blas::set_num_threads(threads);
+        mpfr_vector w(0, 128);
+        assert(format::read(path, w).empty());
+        assert(w.size() == v.size());
+        for (size_t i = 0; i < v.size(); i++)
+            assert(mpfr_equal_p(w[i].get_mpfr_t(), v[i].get_mpfr_t()));
+    }
+    blas::set_num_threads(1);
+    std::remove(path);
+    std::cout << "Bulk parse test passed." << std::endl;
+}
+
+void testMpcClass() {
+    precision_scope scope(128);
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 23);
+    auto random = [&state]() {
+        mpc_class z(0);
+        mpc_urandom(z.get_mpc_t(), state);
+        return z - mpc_class(0.5, 0.5);
+    };
+    // construction, lazy limbs, moves, and agreement with std::complex<double>
+    mpc_class e, a(1.5, -2), b("(3 0.25)");
+    assert(e.get_prec() == 128);
+    mpc_class m(std::move(a));
+    assert(m.real() == 1.5 && m.imag() == -2);
+    a = m;
+    const std::complex<double> za(1.5, -2), zb(3, 0.25);
+    assert((a + b).get_complex() == za + zb && (a - b).get_complex() == za - zb);
+    assert(mpc_class(a * b).get_complex() == za * zb && (b / 2).get_complex() == zb / 2.0);
+    assert(mpc_class(za) == a && mpc_class(mpfr_class(3)) == mpc_class(3, 0));
+
+    // the fused forms round once, as mpc_fma does
+    mpc_t r, t;
+    mpc_init2(r, 128);
+    mpc_init2(t, 128);
+    for (mpfr_rnd_t rnd : {MPFR_RNDN, MPFR_RNDU, MPFR_RNDZ}) {
+        precision_scope round(128, rnd);
+        const mpc_rnd_t crnd = MPC_RND(rnd, rnd);
+        for (int k = 0; k < 200; k++) {
+            const mpc_class x = random(), y = random(), c = random();
+            mpc_fma(r, x.get_mpc_t(), y.get_mpc_t(), c.get_mpc_t(), crnd);
+            assert(mpc_class(r) == x * y + c && mpc_class(r) == c + x * y && mpc_class(r) == fma(x, y, c));
+            mpc_class d = c;
+            d += x * y;
+            assert(d == mpc_class(r));
+            mpc_neg(t, c.get_mpc_t(), crnd);
+            mpc_fma(r, x.get_mpc_t(), y.get_mpc_t(), t, crnd);
+            assert(mpc_class(r) == x * y - c);
+            mpc_neg(t, x.get_mpc_t(), crnd);
+            mpc_fma(r, t, y.get_mpc_t(), c.get_mpc_t(), crnd);
+            assert(mpc_class(r) == c - x * y);
+            d = c;
+            d -= x * y;
+            assert(d == mpc_class(r));
+            mpc_fma(r, c.get_mpc_t(), y.get_mpc_t(), c.get_mpc_t(), crnd);
+            d = c;
+            d += d * y; // aliased
+            assert(d == mpc_class(r));
+        }
+    }
+    mpc_clear(r);
+    mpc_clear(t);
+
+    // the scratch of a thread's first fused operation, made inside an arena_scope, outlives it
+    std::thread([] {
+        allocator::install();
+        const mpc_class x(1, 2), y(3, 4), c(5, 6);
+        {
+            allocator::arena_scope arena;
+            precision_scope wide(1000);
+            const mpc_class wx(x), wy(y);
+            assert(mpc_class(wx * wy + c) == mpc_class(0, 16));
+        }
+        {
+            precision_scope wider(3000);
+            const mpc_class wx(x), wy(y);
+            assert(mpc_class(wx * wy + c) == mpc_class(0, 16));
+        }
+        assert(mpc_class(x * y + c) == mpc_class(0, 16));
+        allocator::uninstall();
+    }).join();
+
+    // reading an empty mpc_class allocates nothing, so threads may share one
+    {
+        const std::vector<mpc_class> shared(1000);
+        allocator::install();
+        const allocator::statistics before = allocator::get_statistics();
+        std::vector<std::thread> readers;
+        std::atomic<long> nans{0};
+        for (int t = 0; t < 4; t++)
+            readers.emplace_back([&shared, &nans] {
+                for (const mpc_class &z : shared)
+                    nans += mpfr_nan_p(mpc_realref(z.get_mpc_t())) && mpfr_nan_p(mpc_imagref(z.get_mpc_t())) && !(z == z);
+            });
+        for (auto &t : readers)
+            t.join();
+        const allocator::statistics after = allocator::get_statistics();
+        assert(nans == 4000 && after.hits + after.misses == before.hits + before.misses);
+        allocator::uninstall();
+    }
+
+    // parts of different precision are accounted each at its own
+    {
+        const stats::counters before = stats::snapshot();
+        mpc_t w;
+        mpc_init3(w, 64, 1024);
+        mpc_set_ui(w, 1, MPC_RNDNN);
+        {
+            mpc_class z(w), y(w);
+            y.set_prec(256);
+        }
+        mpc_clear(w);
+        assert(stats::snapshot().live_limb_bytes == before.live_limb_bytes);
+    }
+
+    // transcendentals, real results and output
+    const mpc_class pi_i(0, const_pi());
+    assert(abs(exp(pi_i) + 1) < exp2(mpfr_class(-120)));
+    assert(abs(mpc_class(3, 4)) == 5 && norm(mpc_class(3, 4)) == 25 && arg(mpc_class(0, 1)) == const_pi() / 2);
+    assert(mul_i(a, 1) == mpc_class(2, 1.5) && conj(a) == mpc_class(1.5, 2));
+    std::ostringstream os;
+    os << a;
+    assert(os.str() == "(1.5,-2)");
+
+    // dotu and dotc round each part once; axpy fuses each element, for any number of threads
+    const long n = 3000;
+    std::vector<mpc_class> x(n), y(n);
+    for (long i = 0; i < n; i++) {
+        x[i] = random();
+        y[i] = random();
+    }
+    mpc_class u(0), v(0);
+    {
+        precision_scope wide(4096); // the products and their sum are exact here
+        mpc_class su(0), sv(0);
+        for (long i = 0; i < n; i++) {
+            su += x[i] * y[i];
+            sv += conj(x[i]) * y[i];
+        }
+        mpc_set(u.get_mpc_t(), su.get_mpc_t(), MPC_RNDNN);
+        mpc_set(v.get_mpc_t(), sv.get_mpc_t(), MPC_RNDNN);
+    }
+    assert(blas::dotu(x, y) == u && blas::dotc(x, y) == v);
+    const mpc_class alpha(mpfr_class(1) / 3, mpfr_class(-2) / 7);
+    std::vector<mpc_class> ref = y;
+    for (long i = 0; i < n; i++)
+        ref[i] = alpha * x[i] + y[i];
+    for (int threads : {1, 3}) {
+        blas::set_num_threads(threads);
+        std::vector<mpc_class> w = y;
+        blas::axpy(alpha, x, w);
+        for (long i = 0; i < n; i++)
+            assert(w[i] == ref[i]);
+    }
+    blas::set_num_threads(1);
+    gmp_randclear(state);
+    std::cout << "mpc_class test passed." << std::endl;
+}
+
+template <class T> T backend_dot(const std::vector<T> &x, const std::vector<T> &y) {
+    T s(0.0);
+    for (size_t i = 0; i < x.size(); i++)
+        s += x[i] * y[i];
+    return s;
+}
+
+// log2 of the relative error of a backend's result against an MPFR reference
+template <class T> double backend_error(const T &t, const mpfr_class &ref) {
+    precision_scope scope(1024);
+    const mpfr_class v(t);
+    if (v == ref)
+        return -1024;
+    return mpfr_get_d(log2(abs((v - ref) / ref)).get_mpfr_t(), MPFR_RNDN);
+}
+
+template <class T> void testBackendArithmetic(const double bound, const bool correctly_rounded) {
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 24);
+    for (int k = 0; k < 2000; k++) {
+        precision_scope width(T::prec); // a and b carry the backend's width
+        mpfr_class a(0.0), b(0.0);
+        mpfr_urandomb(a.get_mpfr_t(), state);
+        mpfr_urandomb(b.get_mpfr_t(), state);
+        a = mul_2si(a, k % 61 - 30, MPFR_RNDN);
+        if (k % 2)
+            b = neg(b);
+        if (k % 5 == 0) // b close to -a, so that a + b cancels
+            b = neg(a) + mul_2si(b, -150, MPFR_RNDN);
+        const T ta(a), tb(b);
+        assert(mpfr_class(ta) == a && mpfr_class(tb) == b); // exact both ways at the backend's width
+        precision_scope scope(1024);
+        const mpfr_class ref[5] = {a + b, a - b, a * b, a / b, sqrt(abs(a))};
+        const T res[5] = {ta + tb, ta - tb, ta * tb, ta / tb, sqrt(abs(ta))};
+        for (int i = 0; i < 5; i++) {
+            if (correctly_rounded) {
+                assert(mpfr_fixed<T::prec>(mpfr_class(res[i])) == mpfr_fixed<T::prec>(ref[i]));
+            } else {
+                assert(backend_error(res[i], ref[i]) <= bound);
+            }
+        }
+        assert(backend_error(ta * 3.0, a * 3) <= bound && backend_error(ta / 7L, a / 7) <= bound && backend_error(1 - ta, 1 - a) <= bound);
+        assert((ta < tb) == (a < b) && (ta == tb) == (a == b) && (ta >= tb) == (a >= b));
+    }
+    gmp_randclear(state);
+}
+
+void testBackends() {
+    static_assert(std::is_same<backend_t<53>, mpfr_dd>::value && std::is_same<backend_t<106>, mpfr_dd>::value, "dd up to 106 bits");
+    static_assert(std::is_same<backend_t<200>, mpfr_qd>::value && std::is_same<backend_t<212>, mpfr_qd>::value, "qd up to 212 bits");
+    static_assert(std::is_same<backend_t<213>, mpfr_fixed<213>>::value, "mpfr_fixed above");
+#ifdef MPFR_WANT_FLOAT128
+    static_assert(std::is_same<backend_t<113>, mpfr_float128>::value, "float128 from 107 to 113 bits");
+    testBackendArithmetic<mpfr_float128>(0, true);
+    {
+        precision_scope scope(113);
+        const _Float128 third = static_cast<_Float128>(1) / 3;
+        assert(mpfr_class(third) == mpfr_class(1) / 3 && mpfr_float128("0.1").get_float128() == mpfr_float128(mpfr_class("0.1")).get_float128());
+    }
+#endif
+    testBackendArithmetic<mpfr_dd>(-102, false);
+    testBackendArithmetic<mpfr_qd>(-208, false);
+
+    // integers convert exactly, scalars mix in on either side
+    const long big = (1L << 62) + 1;
+    assert(mpfr_class(mpfr_dd(big)) == mpfr_class(big) && mpfr_class(mpfr_qd(-big)) == neg(mpfr_class(big)));
+    assert(2 - mpfr_dd(1.5) == 0.5 && 1 / mpfr_qd(4) == 0.25 && mpfr_dd(3) > 2 && 2 < mpfr_qd(3) && mpfr_dd(2) != 3);
+    assert(mpfr_dd().is_nan() && !(mpfr_dd() == mpfr_dd()) && (mpfr_qd(1.0) / 0.0).is_inf() && mpfr_dd(1.0) / 0.0 == mpfr_dd(2.0) / 0.0);
+    // strings and transcendentals go through MPFR at the backend's width
+    {
+        precision_scope scope(212);
+        assert(mpfr_class(mpfr_qd("0.1")) == mpfr_class("0.1") && mpfr_class(exp(mpfr_qd(1))) == exp(mpfr_class(1)));
+        assert(mpfr_class(const_pi<mpfr_qd>()) == const_pi() && mpfr_class(atan2(mpfr_qd(1), mpfr_qd(2))) == atan2(mpfr_class(1), mpfr_class(2)));
+    }
+    bool thrown = false;
+    try {
+        mpfr_dd bad("not a number");
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    std::ostringstream os;
+    os << std::setprecision(10) << mpfr_dd(1) / 3;
+    assert(os.str() == "0.3333333333");
+
+    // the same templated code on every backend, picked at compile time or at run time
+    std::vector<double> u(100), w(100);
+    for (int i = 0; i < 100; i++) {
+        u[i] = 1.0 / (i + 1);
+        w[i] = i - 49.5;
+    }
+    auto run = [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        std::vector<T> x, y;
+        for (int i = 0; i < 100; i++) {
+            x.push_back(T(u[i]));
+            y.push_back(T(w[i]));
+        }
+        precision_scope scope(1024);
+        return backend_error(backend_dot(x, y), backend_dot(std::vector<mpfr_class>(x.begin(), x.end()), std::vector<mpfr_class>(y.begin(), y.end())));
+    };
+    assert(run(backend_tag<backend_t<100>>{}) < -95 && run(backend_tag<backend_t<200>>{}) < -195);
+    assert(with_backend(100, run) < -95 && with_backend(150, run) < -100);
+    mpfr_prec_t inner = 0;
+    with_backend(300, [&](auto tag) { inner = typename decltype(tag)::type(1).get_prec(); });
+    assert(inner == 300);
+    std::cout << "Backends test passed." << std::endl;
+}
+
+// x + t r at 2048 bits, exact for the balls below
+mpfr_class ball_point(const mpfr_ball &x, const double t) {
+    precision_scope scope(2048);
+    const mpfr_class r(x.rad()); // named, or the sum would reuse it at 30 bits
+    return x.mid() + r * t;
+}
+
+// a ball around a random point of [lo, hi] at 113 bits, 2^-40 of it wide
+mpfr_ball random_ball(gmp_randstate_t state, const double lo, const double hi) {
+    precision_scope scope(113);
+    mpfr_class u(0.0);
+    mpfr_urandomb(u.get_mpfr_t(), state);
+    const mpfr_class m = lo + (hi - lo) * u;
+    return mpfr_ball(m, mul_2si(abs(m), -40, MPFR_RNDN));
+}
+
+// f of the ends and of points inside the ball, at 2048 bits, lie in f of the ball
+template <class F> void testBallFunction(F f, const double lo, const double hi, gmp_randstate_t state) {
+    for (int k = 0; k < 100; k++) {
+        const mpfr_ball x = random_ball(state, lo, hi);
+        mpfr_ball y;
+        {
+            precision_scope scope(113);
+            y = f(x);
+        }
+        assert(y.is_finite() && y.correct_bits() >= 20);
+        for (const double t : {-1.0, -0.3, 0.0, 0.7, 1.0}) {
+            precision_scope scope(2048);
+            assert(y.contains(f(ball_point(x, t))));
+        }
+    }
+}
+
+void testBall() {
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 25);
+    precision_scope scope(128);
+
+    // exact values stay exact, rounding shows in the radius
+    const mpfr_ball one(1), three(3), third = one / three;
+    assert((one + three).is_exact() && (one + three).correct_bits() == 128 && (three * 2 - 1).mid() == 5);
+    assert(!third.is_exact() && third.correct_bits() == 127 && third.contains(mpfr_class(1) / 3));
+    {
+        precision_scope p(2048);
+        assert(third.contains(mpfr_class(1) / 3) && mpfr_ball("0.1").contains(mpfr_class("0.1")) && const_pi<mpfr_ball>().contains(const_pi()));
+    }
+    assert(mpfr_ball(mpfr_class(1.5), mpfr_class(0.5)).lower() == 1 && mpfr_ball(mpfr_class(1.5), mpfr_class(0.5)).upper() == 2);
+
+    // arithmetic on balls that carry a radius, at the corners
+    for (int k = 0; k < 200; k++) {
+        const mpfr_ball a = random_ball(state, -10, 10), b = random_ball(state, 0.5, 4);
+        const mpfr_ball sum = a + b, difference = a - b, product = a * b, quotient = a / b;
+        for (const double s : {-1.0, 1.0})
+            for (const double t : {-1.0, 0.5, 1.0}) {
+                precision_scope p(2048);
+                const mpfr_class x = ball_point(a, s), y = ball_point(b, t);
+                assert(sum.contains(x + y) && difference.contains(x - y) && product.contains(x * y) && quotient.contains(x / y));
+            }
+    }
+    testBallFunction([](const auto &x) { return sqrt(x); }, 0.1, 10, state);
+    testBallFunction([](const auto &x) { return log(x); }, 0.1, 0.9, state);
+    testBallFunction([](const auto &x) { return log2(x); }, 1.5, 10, state);
+    testBallFunction([](const auto &x) { return log10(x); }, 1.5, 10, state);
+    testBallFunction([](const auto &x) { return log1p(x); }, -0.5, 10, state);
+    testBallFunction([](const auto &x) { return exp(x); }, -10, 10, state);
+    testBallFunction([](const auto &x) { return exp2(x); }, -10, 10, state);
+    testBallFunction([](const auto &x) { return exp10(x); }, -5, 5, state);
+    testBallFunction([](const auto &x) { return expm1(x); }, 0.1, 1, state);
+    testBallFunction([](const auto &x) { return sin(x); }, 0.1, 3, state);
+    testBallFunction([](const auto &x) { return cos(x); }, -1.5, 1.5, state);
+    testBallFunction([](const auto &x) { return tan(x); }, -1.5, 1.5, state);
+    testBallFunction([](const auto &x) { return sec(x); }, -1.5, 1.5, state);
+    testBallFunction([](const auto &x) { return csc(x); }, 0.1, 3, state);
+    testBallFunction([](const auto &x) { return cot(x); }, -3, -0.1, state);
+    testBallFunction([](const auto &x) { return sinpi(x); }, -3, 3, state);
+    testBallFunction([](const auto &x) { return cospi(x); }, -3, 3, state);
+    testBallFunction([](const auto &x) { return sinu(x, 360UL); }, -400, 400, state);
+    testBallFunction([](const auto &x) { return cosu(x, 360UL); }, -400, 400, state);
+    testBallFunction([](const auto &x) { return asin(x); }, -0.99, 0.99, state);
+    testBallFunction([](const auto &x) { return acos(x); }, -0.99, 0.99, state);
+    testBallFunction([](const auto &x) { return sinh(x); }, 0.1, 5, state);
+    testBallFunction([](const auto &x) { return cosh(x); }, -5, 5, state);
+    testBallFunction([](const auto &x) { return tanh(x); }, 0.1, 5, state);
+    testBallFunction([](const auto &x) { return sech(x); }, -5, 5, state);
+    testBallFunction([](const auto &x) { return csch(x); }, 0.1, 5, state);
+    testBallFunction([](const auto &x) { return coth(x); }, -5, -0.1, state);
+    testBallFunction([](const auto &x) { return asinh(x); }, 0.1, 100, state);
+    testBallFunction([](const auto &x) { return acosh(x); }, 1.1, 100, state);
+    testBallFunction([](const auto &x) { return atanh(x); }, 0.1, 0.99, state);
+    testBallFunction([](const auto &x) { return erf(x); }, 0.1, 3, state);
+    testBallFunction([](const auto &x) { return erfc(x); }, -3, 3, state);
+    testBallFunction([](const auto &x) { return pow_si(x, 7); }, -3, 3, state);
+    testBallFunction([](const auto &x) { return pow_si(x, -3); }, 0.5, 3, state);
+    testBallFunction([](const auto &x) { return pow_ui(x, 5UL); }, -3, 3, state);
+    testBallFunction([](const auto &x) { return pown(x, intmax_t(-4)); }, -3, -0.5, state);
+    testBallFunction([](const auto &x) { return pow_uj(x, uintmax_t(6)); }, -2, 2, state);
+    testBallFunction([](const auto &x) { return pow_sj(x, intmax_t(-2)); }, 0.5, 3, state);
+    testBallFunction([](const auto &x) { return ui_pow(3UL, x); }, -5, 5, state);
+    testBallFunction([](const auto &x) { return exp2m1(x); }, -3, 3, state);
+    testBallFunction([](const auto &x) { return exp10m1(x); }, -2, 2, state);
+    testBallFunction([](const auto &x) { return log2p1(x); }, -0.5, 10, state);
+    testBallFunction([](const auto &x) { return log10p1(x); }, -0.5, 10, state);
+    mpz_t exponent;
+    mpz_init_set_si(exponent, 9);
+    testBallFunction([&exponent](const auto &x) { return pow_z(x, exponent); }, -2, 2, state);
+    mpz_set_si(exponent, -5);
+    testBallFunction([&exponent](const auto &x) { return pow_z(x, exponent); }, 0.5, 3, state);
+    mpz_clear(exponent);
+    for (int k = 0; k < 100; k++) {
+        const mpfr_ball x = random_ball(state, 0.2, 4), y = random_ball(state, -3, 3), u = random_ball(state, -3, 3), v = random_ball(state, 0.2, 4);
+        const mpfr_ball p = pow(x, y), q = powr(x, y), angle = atan2(y, u), mean = agm(x, v);
+        assert(q.is_finite() && mean.is_finite() && mean.correct_bits() >= 20);
+        for (const double s : {-1.0, 1.0})
+            for (const double t : {-1.0, 1.0}) {
+                precision_scope scope(2048);
+                assert(p.contains(pow(ball_point(x, s), ball_point(y, t))));
+                assert(q.contains(powr(ball_point(x, s), ball_point(y, t))));
+                assert(mean.contains(agm(ball_point(x, s), ball_point(v, t))));
+                assert(!angle.is_finite() || angle.contains(atan2(ball_point(y, s), ball_point(u, t))));
+            }
+    }
+
+    // outside a domain, or across a pole or a cut, the radius is infinite
+    const mpfr_ball around_zero(mpfr_class(0.0), mpfr_class(0.5));
+    assert(!(one / around_zero).is_finite() && (one / around_zero).correct_bits() == 0 && !log(around_zero).is_finite() && !sqrt(around_zero).is_finite());
+    assert(!cot(around_zero).is_finite() && !csch(around_zero).is_finite() && !coth(around_zero).is_finite() && !sec(mpfr_ball(const_pi() / 2, mpfr_class(0.01))).is_finite());
+    assert(!tan(mpfr_ball(const_pi() / 2, mpfr_class(0.01))).is_finite() && !atan2(around_zero, mpfr_ball(mpfr_class(-1), mpfr_class(0.1))).is_finite());
+    assert(atan2(around_zero, mpfr_ball(mpfr_class(1), mpfr_class(0.1))).is_finite() && !mpfr_ball().is_finite() && mpfr_ball().mid().is_nan());
+    assert(pow_ui(mpfr_ball(mpfr_class(2), mpfr_class(0.5)), 0UL).is_finite() && !pown(around_zero, intmax_t(-2)).is_finite() && !agm(around_zero, one).is_finite() && !ui_pow(0UL, around_zero).is_finite());
+
+    // comparisons hold for every point of the balls
+    const mpfr_ball wide(mpfr_class(1), mpfr_class(0.5)), narrow(mpfr_class(1.2), mpfr_class(0.1));
+    assert(one < three && three > one && !(wide < narrow) && !(wide >= narrow) && wide.overlaps(narrow) && !one.overlaps(three));
+    assert(wide <= 1.5 && !(wide < 1.5) && 0.4 < wide && mpfr_class(2) > wide && wide.contains(narrow) && !narrow.contains(wide));
+    {
+        precision_scope p(2048);
+        assert((1 - third).contains(mpfr_class(2) / 3) && (mpfr_class(1) + third).contains(mpfr_class(4) / 3));
+    }
+
+    bool thrown = false;
+    try {
+        mpfr_ball bad("not a number");
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+    std::ostringstream os;
+    os << std::setprecision(10) << mpfr_ball(0.5) << ' ' << third;
+    assert(os.str().rfind("[0.5] [0.3333333333 +/- ", 0) == 0 && os.str().back() == ']');
+
+    // Muller's recurrence of example08, whose rounding errors grow until the limit 100 takes
+    // over from 6: one run at 256 bits says how far it can be trusted
+    precision_scope reference(4096);
+    mpfr_class w1(2), w2(-4), w;
+    precision_scope working(256);
+    mpfr_ball v1(2), v2(-4), v;
+    bool lost = false;
+    for (int n = 3; n <= 100; n++) {
+        v = 111 - 1130 / v2 + 3000 / (v2 * v1);
+        {
+            precision_scope q(4096);
+            w = 111 - 1130 / w2 + 3000 / (w2 * w1);
+            w1 = w2;
+            w2 = w;
+        }
+        assert(v.contains(w) && (n != 30 || v.correct_bits() > 100));
+        lost = lost || v.correct_bits() == 0;
+        v1 = v2;
+        v2 = v;
+    }
+    assert(lost);
+    gmp_randclear(state);
+    std::cout << "mpfr_ball test passed." << std::endl;
+}
+
 int main() {
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.1 Initialization Functions
     ////////////////////////////////////////////////////////////////////////////////////////
     testDefaultPrecision();
     testDefaultRoundingMode();
+    testPrecisionScope();
     testDefaultConstructor();
     testCopyConstructor();
     testSetAndGetPrec();
+    testFixedPrecision();
+    testPoolAllocator();
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.2 Assignment Functions
     ////////////////////////////////////////////////////////////////////////////////////////
@@ -638,6 +2236,27 @@ int main() {
     test_mpfr_class_double_subtraction();
     test_mpfr_class_double_multiplication();
     test_mpfr_class_double_division();
+    testMixedIntegerArithmetic();
+    testLiterals();
+    testConstantCache();
+    testVector();
+    testBlasLevel1();
+    testReduce();
+    testLongAccumulator();
+    testBlasLevel2();
+    testGemm();
+    testFusedMultiplyAdd();
+    testExpressionAliasing();
+    testRvalueReuse();
+    testLazyAllocation();
+    testStats();
+    testProfile();
+    testBinary();
+    testToChars();
+    testBulkParse();
+    testMpcClass();
+    testBackends();
+    testBall();
     ////////////////////////////////////////////////////////////////////////////////////////
     // 5.6 Comparison Functions
     ////////////////////////////////////////////////////////////////////////////////////////